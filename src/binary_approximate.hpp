@@ -0,0 +1,215 @@
+#pragma once
+#include "binary_editor.hpp"
+#include "binary_worker_pool.hpp"
+#include "binary_search.hpp"
+#include <array>
+#include <bit>
+
+namespace binary
+{
+    /**
+     * @brief A match found by an approximate search.
+     */
+    struct approximate_match
+    {
+        size_t offset;   ///< Start offset for find_hamming(), end offset (one past the last byte) for find_edit_distance()
+        size_t distance; ///< Number of mismatches or edits
+
+        bool operator==(const approximate_match &) const = default;
+    };
+
+    namespace detail
+    {
+        /**
+         * @brief Count mismatches of a pattern against consecutive windows and report those within a limit.
+         *
+         * Sixteen windows are compared at once: for each pattern byte, one vector compare marks the lanes that
+         * differ, and per-lane counters add them up. A block stops early once every lane is over the limit.
+         *
+         * @param pData The buffer; holds count + pattern.size() - 1 bytes.
+         * @param count Number of windows.
+         * @param pattern The pattern.
+         * @param maxMismatches The limit.
+         * @param base Offset of window 0.
+         * @param matches Receives the matches.
+         */
+        inline void hamming_scan(const uint8_t *pData, const size_t &count, std::span<const uint8_t> pattern, const size_t &maxMismatches, const size_t &base,
+                                 std::vector<approximate_match> &matches)
+        {
+            size_t i = 0;
+#if defined(BINARY_EDITOR_SSE2)
+            if (pattern.size() < 255 && maxMismatches < 255)
+            {
+                const __m128i one   = _mm_set1_epi8(1);
+                const __m128i limit = _mm_set1_epi8(static_cast<char>(maxMismatches + 1));
+                for (; i + 16 <= count; i += 16)
+                {
+                    __m128i mismatches = _mm_setzero_si128();
+                    for (size_t j = 0; j < pattern.size(); ++j)
+                    {
+                        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pData + i + j));
+                        __m128i equal = _mm_cmpeq_epi8(bytes, _mm_set1_epi8(static_cast<char>(pattern[j])));
+                        mismatches    = _mm_add_epi8(mismatches, _mm_andnot_si128(equal, one));
+                        if ((j & 7) == 7 && _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(mismatches, limit), limit)) == 0xFFFF)
+                        {
+                            break;
+                        }
+                    }
+                    // Lanes within the limit are those where min(mismatches, limit) != limit.
+                    uint32_t within = ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(mismatches, limit), limit))) & 0xFFFF;
+                    if (within != 0)
+                    {
+                        alignas(16) uint8_t counts[16];
+                        _mm_store_si128(reinterpret_cast<__m128i *>(counts), mismatches);
+                        while (within != 0)
+                        {
+                            size_t lane = std::countr_zero(within);
+                            matches.push_back({base + i + lane, counts[lane]});
+                            within &= within - 1;
+                        }
+                    }
+                }
+            }
+#endif
+            for (; i < count; ++i)
+            {
+                size_t mismatches = 0;
+                for (size_t j = 0; j < pattern.size() && mismatches <= maxMismatches; ++j)
+                {
+                    mismatches += pData[i + j] != pattern[j];
+                }
+                if (mismatches <= maxMismatches)
+                {
+                    matches.push_back({base + i, mismatches});
+                }
+            }
+        }
+
+        /**
+         * @brief Myers' bit-vector approximate matcher for patterns of up to 64 bytes.
+         *
+         * One 64-bit word holds the vertical delta vectors of the dynamic programming column, so each text
+         * byte costs a constant number of word operations.
+         */
+        class myers_matcher
+        {
+        private:
+            std::array<uint64_t, 256> m_peq{};
+            uint64_t                  m_last;
+            uint64_t                  m_pv = ~0ull;
+            uint64_t                  m_mv = 0;
+            size_t                    m_score;
+
+        public:
+            /**
+             * @brief Construct a matcher.
+             * @param pattern The pattern, 1 to 64 bytes.
+             */
+            explicit myers_matcher(std::span<const uint8_t> pattern) : m_last(1ull << (pattern.size() - 1)), m_score(pattern.size())
+            {
+                for (size_t i = 0; i < pattern.size(); ++i)
+                {
+                    m_peq[pattern[i]] |= 1ull << i;
+                }
+            }
+            /**
+             * @brief Consume one text byte.
+             * @param value The byte.
+             * @return The edit distance between the pattern and the best substring ending at this byte.
+             */
+            size_t step(const uint8_t &value)
+            {
+                uint64_t eq = m_peq[value];
+                uint64_t xv = eq | m_mv;
+                uint64_t xh = (((eq & m_pv) + m_pv) ^ m_pv) | eq;
+                uint64_t ph = m_mv | ~(xh | m_pv);
+                uint64_t mh = m_pv & xh;
+                if (ph & m_last)
+                {
+                    ++m_score;
+                }
+                else if (mh & m_last)
+                {
+                    --m_score;
+                }
+                ph <<= 1;
+                mh <<= 1;
+                m_pv = mh | ~(xv | ph);
+                m_mv = ph & xv;
+                return m_score;
+            }
+        };
+    }
+
+    /**
+     * @brief Find every window of an editor that differs from a pattern in at most k bytes.
+     *
+     * Ranges are searched in parallel, windows spanning chunks included.
+     *
+     * @param editor The editor to search; it must not be modified while searching.
+     * @param pattern The pattern.
+     * @param maxMismatches The maximum number of differing bytes k.
+     * @param pool The pool searching the ranges.
+     * @param rangeSize Window starts per task.
+     * @return The matches by start offset, in increasing order.
+     * @throws binary_exception if pattern is empty.
+     */
+    inline std::vector<approximate_match> find_hamming(const binary_editor &editor, std::span<const uint8_t> pattern, const size_t &maxMismatches,
+                                                       worker_pool &pool = worker_pool::shared(), const size_t &rangeSize = DEFAULT_RANGE_SIZE)
+    {
+        if (pattern.empty())
+        {
+            throw binary_exception("find_hamming err : pattern must not be empty!");
+        }
+        return pool.parallel_gather<approximate_match>(editor.size(), rangeSize,
+                                                       [&](size_t first, size_t last, std::vector<approximate_match> &out)
+                                                       {
+                                                           detail::for_each_window(editor, first, last, pattern.size(),
+                                                                                   [&](const uint8_t *pData, size_t count, size_t base)
+                                                                                   { detail::hamming_scan(pData, count, pattern, maxMismatches, base, out); });
+                                                       });
+    }
+
+    /**
+     * @brief Find every position of an editor where a substring ending there is within k edits of a pattern.
+     *
+     * Uses Myers' bit-vector algorithm. Ranges are searched in parallel; each task starts its matcher
+     * pattern.size() + k bytes early, which is enough to see every alignment with at most k edits.
+     *
+     * @param editor The editor to search; it must not be modified while searching.
+     * @param pattern The pattern, 1 to 64 bytes.
+     * @param maxDistance The maximum number of insertions, deletions and substitutions k.
+     * @param pool The pool searching the ranges.
+     * @param rangeSize End positions per task.
+     * @return The matches by end offset, in increasing order, with the smallest distance ending there.
+     * @throws binary_exception if pattern is empty or longer than 64 bytes.
+     */
+    inline std::vector<approximate_match> find_edit_distance(const binary_editor &editor, std::span<const uint8_t> pattern, const size_t &maxDistance,
+                                                             worker_pool &pool = worker_pool::shared(), const size_t &rangeSize = DEFAULT_RANGE_SIZE)
+    {
+        if (pattern.empty() || pattern.size() > 64)
+        {
+            throw binary_exception("find_edit_distance err : pattern size must be between 1 and 64!");
+        }
+        return pool.parallel_gather<approximate_match>(editor.size(), rangeSize,
+                                                       [&](size_t first, size_t last, std::vector<approximate_match> &out)
+                                                       {
+                                                           size_t                warmUp = std::min(first, pattern.size() + maxDistance);
+                                                           size_t                offset = first - warmUp;
+                                                           detail::myers_matcher matcher(pattern);
+                                                           editor.for_each_segment(offset, last - offset,
+                                                                                   [&](const uint8_t *pData, const size_t &size)
+                                                                                   {
+                                                                                       for (size_t j = 0; j < size; ++j)
+                                                                                       {
+                                                                                           size_t distance = matcher.step(pData[j]);
+                                                                                           ++offset;
+                                                                                           if (distance <= maxDistance && offset > first)
+                                                                                           {
+                                                                                               out.push_back({offset, distance});
+                                                                                           }
+                                                                                       }
+                                                                                   });
+                                                       });
+    }
+}
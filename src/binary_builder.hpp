@@ -0,0 +1,195 @@
+#pragma once
+#include "binary_editor.hpp"
+#include <bit>
+
+namespace writer
+{
+    namespace detail
+    {
+        /**
+         * @brief Unsigned integer with the size of T, used to serialize T bit by bit.
+         */
+        template <typename T>
+        using unsigned_of = std::conditional_t<sizeof(T) == 1, uint8_t, std::conditional_t<sizeof(T) == 2, uint16_t, std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>>;
+
+        /**
+         * @brief Check whether blob_builder can store a type.
+         */
+        template <typename T>
+        constexpr bool is_builder_field = (std::is_arithmetic_v<T> || std::is_enum_v<T>) && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+        /**
+         * @brief Store a value with a given byte order; usable in constant expressions.
+         * @tparam Endian The byte order.
+         * @param value The value.
+         * @param pOut Receives sizeof(T) bytes.
+         */
+        template <std::endian Endian, typename T>
+        constexpr void store_endian(const T &value, uint8_t *pOut)
+        {
+            auto bits = std::bit_cast<unsigned_of<T>>(value);
+            for (size_t i = 0; i < sizeof(T); ++i)
+            {
+                size_t shift = 8 * (Endian == std::endian::little ? i : sizeof(T) - 1 - i);
+                pOut[i]      = static_cast<uint8_t>(bits >> shift);
+            }
+        }
+    }
+
+    /**
+     * @brief Assembles a blob of fixed size from typed fields, at compile time when used in a constant expression.
+     *
+     * Each call returns a new builder whose size includes the appended field, so the final size is part of the
+     * type and bytes() is a plain std::array. Wrap the array with make_static_editor() to use it without copying.
+     *
+     * @code
+     * static constexpr auto HEADER = writer::blob_builder<>()
+     *                                    .append_string("RIFF")
+     *                                    .append<std::endian::little>(uint32_t{36})
+     *                                    .append_string("WAVE")
+     *                                    .bytes();
+     * writer::write_back_static(editor, HEADER);
+     * @endcode
+     *
+     * @tparam N The number of bytes assembled so far.
+     */
+    template <size_t N = 0>
+    class blob_builder
+    {
+        template <size_t>
+        friend class blob_builder;
+
+    private:
+        std::array<uint8_t, N> m_bytes{};
+
+        /**
+         * @brief Copy the bytes of another builder to the front of this one.
+         */
+        template <size_t M>
+        constexpr explicit blob_builder(const std::array<uint8_t, M> &prefix)
+        {
+            for (size_t i = 0; i < M; ++i)
+            {
+                m_bytes[i] = prefix[i];
+            }
+        }
+
+    public:
+        constexpr blob_builder() = default;
+
+        /**
+         * @brief Append a value.
+         * @tparam Endian The byte order of the value.
+         * @tparam T An integral, enumeration or floating-point type of 1, 2, 4 or 8 bytes.
+         * @param value The value.
+         * @return A builder holding these bytes followed by the value.
+         */
+        template <std::endian Endian = std::endian::little, typename T>
+        constexpr blob_builder<N + sizeof(T)> append(const T &value) const
+        {
+            static_assert(detail::is_builder_field<T>, "blob_builder::append requires an arithmetic or enumeration type of 1, 2, 4 or 8 bytes");
+            blob_builder<N + sizeof(T)> ret(m_bytes);
+            detail::store_endian<Endian>(value, ret.m_bytes.data() + N);
+            return ret;
+        }
+        /**
+         * @brief Append raw bytes.
+         * @param bytes The bytes.
+         * @return A builder holding these bytes followed by bytes.
+         */
+        template <size_t M>
+        constexpr blob_builder<N + M> append_bytes(const std::array<uint8_t, M> &bytes) const
+        {
+            blob_builder<N + M> ret(m_bytes);
+            for (size_t i = 0; i < M; ++i)
+            {
+                ret.m_bytes[N + i] = bytes[i];
+            }
+            return ret;
+        }
+        /**
+         * @brief Append the characters of a string literal, without its terminating zero.
+         * @param text The string literal.
+         * @return A builder holding these bytes followed by the characters.
+         */
+        template <size_t M>
+        constexpr blob_builder<N + M - 1> append_string(const char (&text)[M]) const
+        {
+            blob_builder<N + M - 1> ret(m_bytes);
+            for (size_t i = 0; i + 1 < M; ++i)
+            {
+                ret.m_bytes[N + i] = static_cast<uint8_t>(text[i]);
+            }
+            return ret;
+        }
+        /**
+         * @brief Append a run of identical bytes.
+         * @tparam M The number of bytes.
+         * @param fill The byte value.
+         * @return A builder holding these bytes followed by M copies of fill.
+         */
+        template <size_t M>
+        constexpr blob_builder<N + M> append_padding(const uint8_t &fill = 0) const
+        {
+            blob_builder<N + M> ret(m_bytes);
+            for (size_t i = 0; i < M; ++i)
+            {
+                ret.m_bytes[N + i] = fill;
+            }
+            return ret;
+        }
+        /**
+         * @brief Pad to a multiple of an alignment.
+         * @tparam Alignment The alignment, at least 1.
+         * @param fill The byte value of the padding.
+         * @return A builder whose size is the next multiple of Alignment.
+         */
+        template <size_t Alignment>
+        constexpr blob_builder<(N + Alignment - 1) / Alignment * Alignment> align(const uint8_t &fill = 0) const
+        {
+            static_assert(Alignment > 0, "blob_builder::align requires a non-zero alignment");
+            return append_padding<(N + Alignment - 1) / Alignment * Alignment - N>(fill);
+        }
+        /**
+         * @brief Get the number of bytes assembled.
+         * @return N.
+         */
+        static constexpr size_t size()
+        {
+            return N;
+        }
+        /**
+         * @brief Get the assembled bytes.
+         * @return The bytes.
+         */
+        constexpr const std::array<uint8_t, N> &bytes() const
+        {
+            return m_bytes;
+        }
+    };
+
+    /**
+     * @brief Create an editor referring to bytes with static storage duration, without copying them.
+     * @param blob The bytes, typically a static constexpr array from blob_builder; must outlive every editor
+     *             sharing the chunk.
+     * @return An editor holding one static chunk, or an empty editor if blob is empty.
+     */
+    inline binary::binary_editor make_static_editor(std::span<const uint8_t> blob)
+    {
+        if (blob.empty())
+        {
+            return binary::binary_editor();
+        }
+        return binary::binary_editor(std::make_shared<binary::binary_chunk_static>(blob.data(), blob.size()));
+    }
+
+    /**
+     * @brief Append bytes with static storage duration to an editor, without copying them.
+     * @param editor The editor.
+     * @param blob The bytes; must outlive every editor sharing the chunk.
+     */
+    inline void write_back_static(binary::binary_editor &editor, std::span<const uint8_t> blob)
+    {
+        editor.push_back(make_static_editor(blob));
+    }
+}
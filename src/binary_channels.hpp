@@ -0,0 +1,313 @@
+#pragma once
+#include "binary_editor.hpp"
+#include "binary_worker_pool.hpp"
+
+namespace binary
+{
+    namespace detail
+    {
+#if defined(BINARY_EDITOR_SSE2)
+        /**
+         * @brief Split the elements of two vectors by position parity.
+         * @tparam Size The element size: 1, 2, 4 or 8 bytes.
+         * @param lhs The first 16 bytes.
+         * @param rhs The next 16 bytes.
+         * @param even Receives elements 0, 2, 4, ... of lhs followed by those of rhs.
+         * @param odd Receives elements 1, 3, 5, ... of lhs followed by those of rhs.
+         */
+        template <size_t Size>
+        inline void split_lanes(const __m128i &lhs, const __m128i &rhs, __m128i &even, __m128i &odd)
+        {
+            if constexpr (Size == 1)
+            {
+                const __m128i low = _mm_set1_epi16(0x00FF);
+                even              = _mm_packus_epi16(_mm_and_si128(lhs, low), _mm_and_si128(rhs, low));
+                odd               = _mm_packus_epi16(_mm_srli_epi16(lhs, 8), _mm_srli_epi16(rhs, 8));
+            }
+            else if constexpr (Size == 2)
+            {
+                // Sign extension keeps the values inside the signed saturation range of packs.
+                even = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(lhs, 16), 16), _mm_srai_epi32(_mm_slli_epi32(rhs, 16), 16));
+                odd  = _mm_packs_epi32(_mm_srai_epi32(lhs, 16), _mm_srai_epi32(rhs, 16));
+            }
+            else if constexpr (Size == 4)
+            {
+                even = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(lhs), _mm_castsi128_ps(rhs), _MM_SHUFFLE(2, 0, 2, 0)));
+                odd  = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(lhs), _mm_castsi128_ps(rhs), _MM_SHUFFLE(3, 1, 3, 1)));
+            }
+            else
+            {
+                even = _mm_unpacklo_epi64(lhs, rhs);
+                odd  = _mm_unpackhi_epi64(lhs, rhs);
+            }
+        }
+        /**
+         * @brief Interleave the elements of two vectors, the inverse of split_lanes().
+         * @tparam Size The element size: 1, 2, 4 or 8 bytes.
+         * @param even The elements for the even positions.
+         * @param odd The elements for the odd positions.
+         * @param low Receives the first 16 interleaved bytes.
+         * @param high Receives the next 16 interleaved bytes.
+         */
+        template <size_t Size>
+        inline void merge_lanes(const __m128i &even, const __m128i &odd, __m128i &low, __m128i &high)
+        {
+            if constexpr (Size == 1)
+            {
+                low  = _mm_unpacklo_epi8(even, odd);
+                high = _mm_unpackhi_epi8(even, odd);
+            }
+            else if constexpr (Size == 2)
+            {
+                low  = _mm_unpacklo_epi16(even, odd);
+                high = _mm_unpackhi_epi16(even, odd);
+            }
+            else if constexpr (Size == 4)
+            {
+                low  = _mm_unpacklo_epi32(even, odd);
+                high = _mm_unpackhi_epi32(even, odd);
+            }
+            else
+            {
+                low  = _mm_unpacklo_epi64(even, odd);
+                high = _mm_unpackhi_epi64(even, odd);
+            }
+        }
+#endif
+
+        /**
+         * @brief Check whether the vector kernels handle an element size.
+         */
+        template <typename T>
+        constexpr bool is_lane_size = sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8;
+
+        /**
+         * @brief Deinterleave whole frames from a contiguous buffer.
+         *
+         * Two and four channels of 1, 2, 4 or 8 byte elements are split 32 or 64 bytes at a time with
+         * split_lanes(); four channels are two rounds of two-way splits. Other layouts are copied per element.
+         *
+         * @param pSrc The frames.
+         * @param frames Number of frames.
+         * @param channels The channel buffers.
+         * @param index Index in the channel buffers of the first frame.
+         */
+        template <typename T>
+        inline void deinterleave_frames(const uint8_t *pSrc, const size_t &frames, std::span<T *const> channels, const size_t &index)
+        {
+            const size_t channelCount = channels.size();
+            size_t       i            = 0;
+            if (channelCount == 1)
+            {
+                memcpy(channels[0] + index, pSrc, frames * sizeof(T));
+                return;
+            }
+#if defined(BINARY_EDITOR_SSE2)
+            if constexpr (is_lane_size<T>)
+            {
+                constexpr size_t LANES = 16 / sizeof(T);
+                if (channelCount == 2)
+                {
+                    for (; i + LANES <= frames; i += LANES)
+                    {
+                        const uint8_t *pFrame = pSrc + i * 2 * sizeof(T);
+                        __m128i        even, odd;
+                        split_lanes<sizeof(T)>(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pFrame)), _mm_loadu_si128(reinterpret_cast<const __m128i *>(pFrame + 16)), even,
+                                               odd);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(channels[0] + index + i), even);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(channels[1] + index + i), odd);
+                    }
+                }
+                else if (channelCount == 4)
+                {
+                    for (; i + LANES <= frames; i += LANES)
+                    {
+                        const uint8_t *pFrame = pSrc + i * 4 * sizeof(T);
+                        __m128i        even0, odd0, even1, odd1, channel0, channel1, channel2, channel3;
+                        split_lanes<sizeof(T)>(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pFrame)), _mm_loadu_si128(reinterpret_cast<const __m128i *>(pFrame + 16)),
+                                               even0, odd0);
+                        split_lanes<sizeof(T)>(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pFrame + 32)), _mm_loadu_si128(reinterpret_cast<const __m128i *>(pFrame + 48)),
+                                               even1, odd1);
+                        split_lanes<sizeof(T)>(even0, even1, channel0, channel2);
+                        split_lanes<sizeof(T)>(odd0, odd1, channel1, channel3);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(channels[0] + index + i), channel0);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(channels[1] + index + i), channel1);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(channels[2] + index + i), channel2);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(channels[3] + index + i), channel3);
+                    }
+                }
+            }
+#endif
+            for (; i < frames; ++i)
+            {
+                const uint8_t *pFrame = pSrc + i * channelCount * sizeof(T);
+                for (size_t c = 0; c < channelCount; ++c)
+                {
+                    memcpy(channels[c] + index + i, pFrame + c * sizeof(T), sizeof(T));
+                }
+            }
+        }
+
+        /**
+         * @brief Interleave whole frames into a contiguous buffer, the inverse of deinterleave_frames().
+         * @param channels The channel buffers.
+         * @param index Index in the channel buffers of the first frame.
+         * @param frames Number of frames.
+         * @param pDst Receives the frames.
+         */
+        template <typename T>
+        inline void interleave_frames(std::span<const T *const> channels, const size_t &index, const size_t &frames, uint8_t *pDst)
+        {
+            const size_t channelCount = channels.size();
+            size_t       i            = 0;
+            if (channelCount == 1)
+            {
+                memcpy(pDst, channels[0] + index, frames * sizeof(T));
+                return;
+            }
+#if defined(BINARY_EDITOR_SSE2)
+            if constexpr (is_lane_size<T>)
+            {
+                constexpr size_t LANES = 16 / sizeof(T);
+                if (channelCount == 2)
+                {
+                    for (; i + LANES <= frames; i += LANES)
+                    {
+                        uint8_t *pFrame = pDst + i * 2 * sizeof(T);
+                        __m128i  low, high;
+                        merge_lanes<sizeof(T)>(_mm_loadu_si128(reinterpret_cast<const __m128i *>(channels[0] + index + i)),
+                                               _mm_loadu_si128(reinterpret_cast<const __m128i *>(channels[1] + index + i)), low, high);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(pFrame), low);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(pFrame + 16), high);
+                    }
+                }
+                else if (channelCount == 4)
+                {
+                    for (; i + LANES <= frames; i += LANES)
+                    {
+                        uint8_t *pFrame = pDst + i * 4 * sizeof(T);
+                        __m128i  even0, even1, odd0, odd1, frame0, frame1, frame2, frame3;
+                        merge_lanes<sizeof(T)>(_mm_loadu_si128(reinterpret_cast<const __m128i *>(channels[0] + index + i)),
+                                               _mm_loadu_si128(reinterpret_cast<const __m128i *>(channels[2] + index + i)), even0, even1);
+                        merge_lanes<sizeof(T)>(_mm_loadu_si128(reinterpret_cast<const __m128i *>(channels[1] + index + i)),
+                                               _mm_loadu_si128(reinterpret_cast<const __m128i *>(channels[3] + index + i)), odd0, odd1);
+                        merge_lanes<sizeof(T)>(even0, odd0, frame0, frame1);
+                        merge_lanes<sizeof(T)>(even1, odd1, frame2, frame3);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(pFrame), frame0);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(pFrame + 16), frame1);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(pFrame + 32), frame2);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(pFrame + 48), frame3);
+                    }
+                }
+            }
+#endif
+            for (; i < frames; ++i)
+            {
+                uint8_t *pFrame = pDst + i * channelCount * sizeof(T);
+                for (size_t c = 0; c < channelCount; ++c)
+                {
+                    memcpy(pFrame + c * sizeof(T), channels[c] + index + i, sizeof(T));
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Split interleaved multichannel samples of an editor into one buffer per channel.
+     *
+     * Frame i is channels.size() elements starting at offset + i * channels.size() * sizeof(T); its element c
+     * is written to channels[c][i]. Ranges of frames are converted in parallel, reading the chunks in place;
+     * only frames spanning a chunk boundary are assembled in a small buffer.
+     *
+     * @code
+     * std::vector<int16_t> left(frames), right(frames);
+     * std::array<int16_t *, 2> channels = {left.data(), right.data()};
+     * binary::deinterleave<int16_t>(editor, dataOffset, channels, frames);
+     * @endcode
+     *
+     * @tparam T The trivially copyable element type; 1, 2, 4 and 8 byte elements in 2 or 4 channels are vectorized.
+     * @param editor The editor; it must not be modified while converting.
+     * @param offset Offset of the first frame.
+     * @param channels Buffers of at least frameCount elements each.
+     * @param frameCount Number of frames.
+     * @param pool The pool converting the ranges.
+     * @param rangeSize Bytes per task.
+     * @throws binary_exception if channels is empty or the frames exceed the editor.
+     */
+    template <typename T>
+    void deinterleave(const binary_editor &editor, const size_t &offset, std::span<T *const> channels, const size_t &frameCount, worker_pool &pool = worker_pool::shared(),
+                      const size_t &rangeSize = DEFAULT_RANGE_SIZE)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "deinterleave requires a trivially copyable type");
+        if (channels.empty())
+        {
+            throw binary_exception("deinterleave err : channels must not be empty!");
+        }
+        const size_t frameSize = channels.size() * sizeof(T);
+        if (offset > editor.size() || frameCount > (editor.size() - offset) / frameSize)
+        {
+            throw binary_exception("deinterleave err : (offset + frameCount * frame size) must not be greater than editor size!");
+        }
+        pool.parallel_for_ranges(frameCount, rangeSize / frameSize,
+                                 [&](size_t frame, size_t last)
+                                 {
+                                     std::vector<uint8_t> partial;
+                                     editor.for_each_segment(offset + frame * frameSize, (last - frame) * frameSize,
+                                                             [&](const uint8_t *pData, const size_t &size)
+                                                             {
+                                                                 size_t used = 0;
+                                                                 if (!partial.empty())
+                                                                 {
+                                                                     // Complete the frame spanning the previous segment.
+                                                                     used = std::min(frameSize - partial.size(), size);
+                                                                     partial.insert(partial.end(), pData, pData + used);
+                                                                     if (partial.size() < frameSize)
+                                                                     {
+                                                                         return;
+                                                                     }
+                                                                     detail::deinterleave_frames(partial.data(), 1, channels, frame++);
+                                                                     partial.clear();
+                                                                 }
+                                                                 size_t frames = (size - used) / frameSize;
+                                                                 detail::deinterleave_frames(pData + used, frames, channels, frame);
+                                                                 frame += frames;
+                                                                 used += frames * frameSize;
+                                                                 partial.insert(partial.end(), pData + used, pData + size);
+                                                             });
+                                 });
+    }
+
+    /**
+     * @brief Interleave one buffer per channel into a new editor holding a single chunk.
+     *
+     * The inverse of deinterleave(): element c of frame i is channels[c][i]. Ranges of frames are converted in
+     * parallel straight into the new chunk.
+     *
+     * @tparam T The trivially copyable element type; 1, 2, 4 and 8 byte elements in 2 or 4 channels are vectorized.
+     * @param channels Buffers of at least frameCount elements each.
+     * @param frameCount Number of frames.
+     * @param pool The pool converting the ranges.
+     * @param rangeSize Bytes per task.
+     * @return An editor of frameCount * channels.size() * sizeof(T) bytes.
+     * @throws binary_exception if channels is empty.
+     */
+    template <typename T>
+    binary_editor interleave(std::span<const T *const> channels, const size_t &frameCount, worker_pool &pool = worker_pool::shared(),
+                             const size_t &rangeSize = DEFAULT_RANGE_SIZE)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "interleave requires a trivially copyable type");
+        if (channels.empty())
+        {
+            throw binary_exception("interleave err : channels must not be empty!");
+        }
+        const size_t frameSize = channels.size() * sizeof(T);
+        if (frameCount == 0)
+        {
+            return binary_editor();
+        }
+        std::unique_ptr<uint8_t[]> pBlob(new uint8_t[frameCount * frameSize]);
+        pool.parallel_for_ranges(frameCount, rangeSize / frameSize,
+                                 [&](size_t first, size_t last) { detail::interleave_frames(channels, first, last - first, pBlob.get() + first * frameSize); });
+        return binary_editor(std::unique_ptr<const uint8_t[]>(std::move(pBlob)), frameCount * frameSize);
+    }
+}
@@ -0,0 +1,798 @@
+#pragma once
+#include "binary_editor.hpp"
+#include "binary_worker_pool.hpp"
+#include <list>
+#include <mutex>
+#include <ostream>
+#include <zlib.h>
+
+namespace binary
+{
+    /**
+     * @brief Seek index over a gzip or zlib stream, built while decompressing it.
+     *
+     * While the stream is inflated, a checkpoint is recorded at a deflate block boundary roughly every span_size
+     * output bytes, holding the compressed bit position and the 32 KiB window preceding it. Any span between two
+     * checkpoints can then be inflated on its own, so an editor created by create_editor() only keeps the
+     * compressed stream and the index resident and re-inflates spans on demand, caching the most recent ones.
+     *
+     * @code
+     * // decompress everything into memory chunks, keeping the index
+     * binary::binary_editor image;
+     * auto pIndex = binary::binary_inflate_index::build(compressed, binary::binary_inflate_index::DEFAULT_SPAN_SIZE, &image);
+     *
+     * // or open lazily: reads inflate only from the nearest checkpoint
+     * binary::binary_editor lazy = binary::binary_inflate_index::build(compressed)->create_editor();
+     * @endcode
+     */
+    class binary_inflate_index : public std::enable_shared_from_this<binary_inflate_index>
+    {
+    public:
+        /**
+         * @brief Size of the deflate window in bytes.
+         */
+        static constexpr size_t WINDOW_SIZE = 32768;
+        /**
+         * @brief Default distance between checkpoints in output bytes.
+         */
+        static constexpr size_t DEFAULT_SPAN_SIZE = 1024 * 1024;
+        /**
+         * @brief Default number of inflated spans kept in the cache.
+         */
+        static constexpr size_t DEFAULT_CACHE_CAPACITY = 8;
+
+        /**
+         * @brief A point from which inflating can start.
+         */
+        struct checkpoint
+        {
+            size_t               out_offset = 0; ///< Offset in the decompressed data
+            size_t               in_offset  = 0; ///< Offset of the first full byte in the compressed data
+            int                  bits       = 0; ///< Bits of the byte before in_offset that still belong to the stream
+            std::vector<uint8_t> window;         ///< Up to WINDOW_SIZE bytes of output preceding out_offset
+        };
+
+    private:
+        binary_editor           m_compressed;     ///< The compressed stream
+        std::vector<checkpoint> m_checkpoints;    ///< Checkpoints in order of out_offset
+        size_t                  m_size = 0;       ///< Decompressed size
+        size_t                  m_cache_capacity; ///< Maximum number of cached spans
+
+        mutable std::mutex m_cache_mutex;                                                          ///< Guards m_cache and m_live
+        mutable std::list<std::pair<size_t, std::shared_ptr<const std::vector<uint8_t>>>> m_cache; ///< Cached spans, most recent first
+        mutable std::vector<std::weak_ptr<const std::vector<uint8_t>>>                    m_live;  ///< Spans still held by the cache or a lease
+
+        /**
+         * @brief Feed the compressed data from an offset to inflate until it stops.
+         * @param strm The inflate stream.
+         * @param offset The compressed offset to start from.
+         * @param step Called after input was provided, returns false to stop.
+         */
+        template <typename Step>
+        void feed(z_stream &strm, const size_t &offset, Step &&step) const
+        {
+            m_compressed.for_each_segment(offset, m_compressed.size() - offset,
+                                          [&](const uint8_t *pData, const size_t &size)
+                                          {
+                                              for (size_t fed = 0; fed < size;)
+                                              {
+                                                  // avail_in is 32 bits wide
+                                                  size_t feedSize = std::min<size_t>(size - fed, UINT32_MAX);
+                                                  strm.next_in    = const_cast<Bytef *>(pData + fed);
+                                                  strm.avail_in   = static_cast<uInt>(feedSize);
+                                                  if (!step())
+                                                  {
+                                                      return false;
+                                                  }
+                                                  fed += feedSize - strm.avail_in;
+                                                  if (strm.avail_in != 0)
+                                                  {
+                                                      return false;
+                                                  }
+                                              }
+                                              return true;
+                                          });
+        }
+
+        /**
+         * @brief Inflate one span, starting from its checkpoint.
+         * @param index The span index.
+         * @return The decompressed span.
+         * @throws binary_exception if the stream is corrupt.
+         */
+        std::vector<uint8_t> inflate_span(const size_t &index) const
+        {
+            const checkpoint    &current = m_checkpoints[index];
+            std::vector<uint8_t> ret(span_size(index));
+            z_stream             strm{};
+            if (inflateInit2(&strm, -15) != Z_OK)
+            {
+                throw binary_exception("binary_inflate_index::inflate_span err : inflateInit2 failed!");
+            }
+
+            // restore the state of the checkpoint
+            int status = Z_OK;
+            if (current.bits != 0)
+            {
+                uint8_t byte = 0;
+                m_compressed.for_each_segment(current.in_offset - 1, 1, [&byte](const uint8_t *pData, const size_t &)
+                                              { byte = *pData; });
+                status = inflatePrime(&strm, current.bits, byte >> (8 - current.bits));
+            }
+            if (status == Z_OK && !current.window.empty())
+            {
+                status = inflateSetDictionary(&strm, current.window.data(), static_cast<uInt>(current.window.size()));
+            }
+
+            strm.next_out  = ret.data();
+            strm.avail_out = static_cast<uInt>(ret.size());
+            if (status == Z_OK && !ret.empty())
+            {
+                feed(strm, current.in_offset,
+                     [&]
+                     {
+                         status = inflate(&strm, Z_NO_FLUSH);
+                         return status == Z_OK && strm.avail_out != 0;
+                     });
+            }
+            inflateEnd(&strm);
+            if (strm.avail_out != 0 || (status != Z_OK && status != Z_STREAM_END))
+            {
+                throw binary_exception("binary_inflate_index::inflate_span err : corrupt stream!");
+            }
+            return ret;
+        }
+
+    public:
+        /**
+         * @brief Construct an empty index; use build() instead.
+         * @param compressed The compressed stream.
+         * @param cacheCapacity Maximum number of cached spans.
+         */
+        binary_inflate_index(binary_editor compressed, const size_t &cacheCapacity)
+            : m_compressed(std::move(compressed)), m_cache_capacity(std::max<size_t>(cacheCapacity, 1))
+        {
+        }
+
+        /**
+         * @brief Inflate a gzip or zlib stream, recording checkpoints as it goes.
+         * @param compressed The compressed stream; concatenated gzip members are inflated one after another.
+         * @param spanSize Minimum distance between checkpoints in output bytes.
+         * @param pOutput If not nullptr, receives the decompressed data as memory chunks of about spanSize bytes.
+         * @param cacheCapacity Maximum number of spans create_editor() chunks keep inflated.
+         * @return Shared pointer to the index.
+         * @throws binary_exception if spanSize is 0 or the stream is corrupt or truncated.
+         */
+        static std::shared_ptr<binary_inflate_index> build(const binary_editor &compressed, const size_t &spanSize = DEFAULT_SPAN_SIZE,
+                                                           binary_editor *pOutput = nullptr, const size_t &cacheCapacity = DEFAULT_CACHE_CAPACITY)
+        {
+            if (spanSize == 0)
+            {
+                throw binary_exception("binary_inflate_index::build err : spanSize must not be 0!");
+            }
+            auto     pIndex = std::make_shared<binary_inflate_index>(compressed, cacheCapacity);
+            z_stream strm{};
+            if (inflateInit2(&strm, 47) != Z_OK) // 32 + 15: detect gzip or zlib header
+            {
+                throw binary_exception("binary_inflate_index::build err : inflateInit2 failed!");
+            }
+
+            // output goes to a circular window, which is what a checkpoint needs to keep
+            std::vector<uint8_t>       window(WINDOW_SIZE);
+            std::unique_ptr<uint8_t[]> pBlob;
+            size_t                     blobSize = 0;
+            size_t                     totalIn  = 0;
+            size_t                     totalOut = 0;
+            size_t                     lastOut  = 0;
+            bool                       member   = true;
+            int                        status   = Z_OK;
+            auto                       step     = [&]
+            {
+                if (strm.avail_out == 0)
+                {
+                    strm.next_out  = window.data();
+                    strm.avail_out = static_cast<uInt>(WINDOW_SIZE);
+                }
+                uInt     availIn  = strm.avail_in;
+                uInt     availOut = strm.avail_out;
+                uint8_t *pOut     = strm.next_out;
+                status          = inflate(&strm, Z_BLOCK);
+                size_t produced   = availOut - strm.avail_out;
+                totalIn += availIn - strm.avail_in;
+                totalOut += produced;
+
+                // copy the new output into chunks
+                for (size_t copied = 0; pOutput != nullptr && copied < produced;)
+                {
+                    if (pBlob == nullptr)
+                    {
+                        pBlob    = std::make_unique<uint8_t[]>(spanSize);
+                        blobSize = 0;
+                    }
+                    size_t copySize = std::min(spanSize - blobSize, produced - copied);
+                    memcpy(pBlob.get() + blobSize, pOut + copied, copySize);
+                    blobSize += copySize;
+                    copied += copySize;
+                    if (blobSize == spanSize)
+                    {
+                        pOutput->emplace_back(std::unique_ptr<const uint8_t[]>(std::move(pBlob)), blobSize);
+                    }
+                }
+                if (status == Z_BUF_ERROR)
+                {
+                    // no progress possible, more input is needed
+                    status = Z_OK;
+                    return true;
+                }
+                if (status == Z_STREAM_END && totalIn < compressed.size())
+                {
+                    // another gzip member follows, spans must not cross the boundary
+                    if (inflateReset(&strm) != Z_OK)
+                    {
+                        return false;
+                    }
+                    status = Z_OK;
+                    member = true;
+                    return true;
+                }
+                if (status != Z_OK)
+                {
+                    return false;
+                }
+
+                // at a block boundary (not after the last block), record a checkpoint; the first block of each member
+                // always gets one since a raw inflate cannot go on past the end of a member
+                if ((strm.data_type & 128) && !(strm.data_type & 64) && (member || totalOut - lastOut >= spanSize))
+                {
+                    checkpoint current;
+                    current.out_offset = totalOut;
+                    current.in_offset  = totalIn;
+                    current.bits       = strm.data_type & 7;
+                    size_t position    = WINDOW_SIZE - strm.avail_out;
+                    if (totalOut >= WINDOW_SIZE)
+                    {
+                        current.window.assign(window.begin() + position, window.end());
+                        current.window.insert(current.window.end(), window.begin(), window.begin() + position);
+                    }
+                    else
+                    {
+                        current.window.assign(window.begin(), window.begin() + totalOut);
+                    }
+                    pIndex->m_checkpoints.push_back(std::move(current));
+                    lastOut = totalOut;
+                    member  = false;
+                }
+                return true;
+            };
+            pIndex->feed(strm, 0,
+                         [&]
+                         {
+                             while (strm.avail_in > 0 || strm.avail_out == 0)
+                             {
+                                 if (!step())
+                                 {
+                                     return false;
+                                 }
+                             }
+                             return true;
+                         });
+            // flush output still held by inflate
+            while (status == Z_OK && strm.avail_out == 0 && step())
+            {
+            }
+            inflateEnd(&strm);
+            if (status != Z_STREAM_END)
+            {
+                throw binary_exception("binary_inflate_index::build err : corrupt or truncated stream!");
+            }
+
+            if (pBlob != nullptr && blobSize > 0)
+            {
+                pOutput->emplace_back(std::unique_ptr<const uint8_t[]>(std::move(pBlob)), blobSize);
+            }
+            pIndex->m_size = totalOut;
+            return pIndex;
+        }
+
+        /**
+         * @brief Index a sequence of independent raw deflate frames, one span per frame.
+         * @param compressed The compressed data.
+         * @param frames (compressed offset, decompressed size) of each frame, in order.
+         * @param cacheCapacity Maximum number of spans create_editor() chunks keep inflated.
+         * @return Shared pointer to the index.
+         * @throws binary_exception if a frame starts outside the compressed data.
+         */
+        static std::shared_ptr<binary_inflate_index> from_frames(const binary_editor &compressed, const std::vector<std::pair<size_t, size_t>> &frames,
+                                                                 const size_t &cacheCapacity = DEFAULT_CACHE_CAPACITY)
+        {
+            auto pIndex = std::make_shared<binary_inflate_index>(compressed, cacheCapacity);
+            for (const auto &[inOffset, rawSize] : frames)
+            {
+                if (inOffset > compressed.size())
+                {
+                    throw binary_exception("binary_inflate_index::from_frames err : frame offset must not be greater than compressed size!");
+                }
+                checkpoint current;
+                current.in_offset  = inOffset;
+                current.out_offset = pIndex->m_size;
+                pIndex->m_checkpoints.push_back(std::move(current));
+                pIndex->m_size += rawSize;
+            }
+            return pIndex;
+        }
+
+        /**
+         * @brief Create an editor whose chunks inflate their span on demand, one chunk per span.
+         * @return The editor.
+         */
+        binary_editor create_editor() const;
+
+        /**
+         * @brief Get the decompressed size.
+         * @return The size in bytes.
+         */
+        size_t size() const
+        {
+            return m_size;
+        }
+        /**
+         * @brief Get the number of spans (checkpoints).
+         * @return The number of spans.
+         */
+        size_t span_count() const
+        {
+            return m_checkpoints.size();
+        }
+        /**
+         * @brief Get a checkpoint.
+         * @param index The span index.
+         * @return The checkpoint starting the span.
+         */
+        const checkpoint &get_checkpoint(const size_t &index) const
+        {
+            return m_checkpoints[index];
+        }
+        /**
+         * @brief Get the decompressed size of a span.
+         * @param index The span index.
+         * @return The size in bytes.
+         */
+        size_t span_size(const size_t &index) const
+        {
+            size_t end = index + 1 < m_checkpoints.size() ? m_checkpoints[index + 1].out_offset : m_size;
+            return end - m_checkpoints[index].out_offset;
+        }
+        /**
+         * @brief Get the number of inflated spans still in memory, held by the cache or by a chunk lease.
+         * @return The number of resident spans.
+         */
+        size_t resident_span_count() const
+        {
+            std::lock_guard<std::mutex> lock(m_cache_mutex);
+            return std::count_if(m_live.begin(), m_live.end(), [](const auto &pSpan) { return !pSpan.expired(); });
+        }
+        /**
+         * @brief Get a span, inflating it from its checkpoint unless it is cached or still leased.
+         *
+         * The least recently used span is evicted once the cache is full; the returned pointer keeps its span alive,
+         * and while it does, later calls return the same span.
+         *
+         * @param index The span index.
+         * @return Shared pointer to the decompressed span.
+         * @throws binary_exception if the stream is corrupt.
+         */
+        std::shared_ptr<const std::vector<uint8_t>> load_span(const size_t &index) const
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_cache_mutex);
+                for (auto iter = m_cache.begin(); iter != m_cache.end(); ++iter)
+                {
+                    if (iter->first == index)
+                    {
+                        m_cache.splice(m_cache.begin(), m_cache, iter);
+                        return m_cache.front().second;
+                    }
+                }
+                if (index < m_live.size())
+                {
+                    if (auto pSpan = m_live[index].lock())
+                    {
+                        cache_span(index, pSpan);
+                        return pSpan;
+                    }
+                }
+            }
+
+            auto                        pSpan = std::make_shared<const std::vector<uint8_t>>(inflate_span(index));
+            std::lock_guard<std::mutex> lock(m_cache_mutex);
+            if (m_live.size() < m_checkpoints.size())
+            {
+                m_live.resize(m_checkpoints.size());
+            }
+            m_live[index] = pSpan;
+            cache_span(index, pSpan);
+            return pSpan;
+        }
+        /**
+         * @brief Put a span at the front of the cache, evicting the least recently used one if it is full.
+         *
+         * The caller must hold m_cache_mutex.
+         *
+         * @param index The span index.
+         * @param pSpan The decompressed span.
+         */
+        void cache_span(const size_t &index, const std::shared_ptr<const std::vector<uint8_t>> &pSpan) const
+        {
+            m_cache.emplace_front(index, pSpan);
+            if (m_cache.size() > m_cache_capacity)
+            {
+                m_cache.pop_back();
+            }
+        }
+    };
+
+    /**
+     * @brief Implementation of a chunk that inflates a span of a binary_inflate_index on demand.
+     *
+     * get_data() takes the span from the index cache, inflating it on a miss. The pointer stays valid while a
+     * lease() of the chunk is held; segment walks and readers hold one while they use the data, so only leased and
+     * cached spans stay resident.
+     */
+    class binary_chunk_inflate : public binary_chunk_interface
+    {
+    private:
+        std::shared_ptr<const binary_inflate_index> m_pIndex = nullptr; ///< Index the span belongs to
+        size_t                                      m_span   = 0;       ///< Span index
+        size_t                                      m_size   = 0;
+        size_t                                      m_offset = 0;
+
+    public:
+        /**
+         * @brief Construct an inflate chunk.
+         * @param pIndex The index the span belongs to.
+         * @param span The span index.
+         * @param offset The offset in the span.
+         * @param size The size of the chunk.
+         * @throws binary_exception if pIndex is nullptr or the range exceeds the span.
+         */
+        binary_chunk_inflate(std::shared_ptr<const binary_inflate_index> pIndex, const size_t &span, const size_t &offset, const size_t &size)
+            : m_pIndex(std::move(pIndex)), m_span(span), m_size(size), m_offset(offset)
+        {
+            if (m_pIndex == nullptr)
+            {
+                throw binary_exception("binary_chunk_inflate::binary_chunk_inflate err : pIndex must not be nullptr!");
+            }
+            if (span >= m_pIndex->span_count() || offset + size > m_pIndex->span_size(span))
+            {
+                throw binary_exception("binary_chunk_inflate::binary_chunk_inflate err : (offset + size) must not be greater than span size!");
+            }
+        }
+        /**
+         * @copydoc binary_chunk_interface::create_sub_chunk
+         */
+        virtual std::shared_ptr<binary_chunk_interface> create_sub_chunk(const size_t &offset, const size_t &size) const override final
+        {
+            if (offset + size > m_size)
+            {
+                throw binary_exception("binary_chunk_inflate::create_sub_chunk err : (offset + size) must not be greater than m_Size!");
+            }
+            auto pRet = std::make_shared<binary_chunk_inflate>(*this);
+            pRet->m_offset += offset;
+            pRet->m_size = size;
+            return std::dynamic_pointer_cast<binary_chunk_interface>(pRet);
+        }
+        /**
+         * @copydoc binary_chunk_interface::size
+         */
+        virtual size_t size() const override final
+        {
+            return m_size;
+        }
+        /**
+         * @copydoc binary_chunk_interface::get_data
+         */
+        virtual const uint8_t *get_data() const override final
+        {
+            return m_pIndex->load_span(m_span)->data() + m_offset;
+        }
+        /**
+         * @copydoc binary_chunk_interface::lease
+         */
+        virtual std::shared_ptr<const void> lease() const override final
+        {
+            return m_pIndex->load_span(m_span);
+        }
+        /**
+         * @copydoc binary_chunk_interface::get_type
+         */
+        virtual CHUNK_TYPE get_type() const override final
+        {
+            return CHUNK_TYPE::COMPRESSED;
+        }
+        /**
+         * @copydoc binary_chunk_interface::clone
+         */
+        virtual std::unique_ptr<binary_chunk_interface> clone() const override
+        {
+            return std::make_unique<binary_chunk_inflate>(*this);
+        }
+        /**
+         * @copydoc binary_chunk_interface::downscale_size
+         */
+        virtual void downscale_size(const size_t &targeSize) override final
+        {
+            m_size = targeSize;
+        }
+    };
+
+    inline binary_editor binary_inflate_index::create_editor() const
+    {
+        binary_editor ret;
+        for (size_t i = 0; i < m_checkpoints.size(); ++i)
+        {
+            size_t spanSize = span_size(i);
+            if (spanSize == 0)
+            {
+                continue;
+            }
+            ret.push_back(binary_editor(std::make_shared<binary_chunk_inflate>(shared_from_this(), i, 0, spanSize)));
+        }
+        return ret;
+    }
+
+    /**
+     * @brief Saves editors as independently deflated blocks with a block index, and opens them lazily.
+     *
+     * Blocks are compressed in parallel on a worker_pool and written in order. The layout is:
+     * - the raw deflate frame of each block, back to back;
+     * - the index: (compressed size, decompressed size) of each block as little-endian uint64;
+     * - a footer: index offset and block count as little-endian uint64, followed by FOOTER_MAGIC.
+     *
+     * Since the blocks do not depend on each other, open() maps each one to a lazily inflated chunk.
+     *
+     * @code
+     * std::ofstream file("image.besd", std::ios::binary);
+     * binary::binary_seekable_deflate::save(editor, file);
+     *
+     * auto pSource = std::make_shared<binary::binary_file_source>("image.besd");
+     * binary::binary_editor image = binary::binary_seekable_deflate::open(binary::binary_editor(pSource));
+     * @endcode
+     */
+    class binary_seekable_deflate
+    {
+    public:
+        /**
+         * @brief Default block size in bytes.
+         */
+        static constexpr size_t DEFAULT_BLOCK_SIZE = 1024 * 1024;
+        /**
+         * @brief Magic ending the file.
+         */
+        static constexpr char FOOTER_MAGIC[8] = {'B', 'E', 'S', 'E', 'E', 'K', 'D', '1'};
+        /**
+         * @brief Size of the footer in bytes.
+         */
+        static constexpr size_t FOOTER_SIZE = 2 * sizeof(uint64_t) + sizeof(FOOTER_MAGIC);
+
+    private:
+        static constexpr uint64_t MAX_DEFLATE_RATIO = 1032; ///< Deflate encodes a 258 byte match in at least 2 bits
+
+        /**
+         * @brief Append a little-endian uint64.
+         * @param out The buffer.
+         * @param value The value.
+         */
+        static void put_uint64(std::vector<uint8_t> &out, uint64_t value)
+        {
+            for (size_t i = 0; i < sizeof(uint64_t); ++i)
+            {
+                out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+            }
+        }
+        /**
+         * @brief Read a little-endian uint64.
+         * @param pData The data pointer.
+         * @return The value.
+         */
+        static uint64_t get_uint64(const uint8_t *pData)
+        {
+            uint64_t value = 0;
+            for (size_t i = 0; i < sizeof(uint64_t); ++i)
+            {
+                value |= static_cast<uint64_t>(pData[i]) << (8 * i);
+            }
+            return value;
+        }
+        /**
+         * @brief Copy a range of an editor into a buffer.
+         * @param editor The editor.
+         * @param offset The offset of the range.
+         * @param size The size of the range.
+         * @return The bytes.
+         */
+        static std::vector<uint8_t> read_range(const binary_editor &editor, const size_t &offset, const size_t &size)
+        {
+            std::vector<uint8_t> ret;
+            ret.reserve(size);
+            editor.for_each_segment(offset, size, [&ret](const uint8_t *pData, const size_t &segmentSize)
+                                    { ret.insert(ret.end(), pData, pData + segmentSize); });
+            return ret;
+        }
+        /**
+         * @brief Deflate one block into a raw deflate frame, reading the segments in place.
+         * @param editor The editor.
+         * @param offset The offset of the block.
+         * @param size The size of the block.
+         * @param level The zlib compression level.
+         * @return The frame.
+         * @throws binary_exception if zlib fails.
+         */
+        static std::vector<uint8_t> deflate_block(const binary_editor &editor, const size_t &offset, const size_t &size, const int &level)
+        {
+            z_stream strm{};
+            if (deflateInit2(&strm, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            {
+                throw binary_exception("binary_seekable_deflate::deflate_block err : deflateInit2 failed!");
+            }
+            std::vector<uint8_t> ret(deflateBound(&strm, static_cast<uLong>(size)));
+            size_t               produced = 0;
+            auto                 step     = [&](const int &flush)
+            {
+                if (produced == ret.size())
+                {
+                    ret.resize(ret.size() * 2);
+                }
+                strm.next_out  = ret.data() + produced;
+                strm.avail_out = static_cast<uInt>(std::min<size_t>(ret.size() - produced, UINT32_MAX));
+                uInt availOut  = strm.avail_out;
+                int  status    = deflate(&strm, flush);
+                produced += availOut - strm.avail_out;
+                return status;
+            };
+
+            editor.for_each_segment(offset, size,
+                                    [&](const uint8_t *pData, const size_t &segmentSize)
+                                    {
+                                        for (size_t fed = 0; fed < segmentSize;)
+                                        {
+                                            // avail_in is 32 bits wide
+                                            size_t feedSize = std::min<size_t>(segmentSize - fed, UINT32_MAX);
+                                            strm.next_in    = const_cast<Bytef *>(pData + fed);
+                                            strm.avail_in   = static_cast<uInt>(feedSize);
+                                            while (strm.avail_in > 0)
+                                            {
+                                                step(Z_NO_FLUSH);
+                                            }
+                                            fed += feedSize;
+                                        }
+                                    });
+            int status = Z_OK;
+            while (status == Z_OK || status == Z_BUF_ERROR)
+            {
+                status = step(Z_FINISH);
+            }
+            deflateEnd(&strm);
+            if (status != Z_STREAM_END)
+            {
+                throw binary_exception("binary_seekable_deflate::deflate_block err : deflate failed!");
+            }
+            ret.resize(produced);
+            return ret;
+        }
+
+    public:
+        /**
+         * @brief Compress an editor block by block on a worker pool and write it in the seekable format.
+         *
+         * At most twice as many blocks as the pool has threads are in flight, so memory stays bounded.
+         *
+         * @param editor The editor to save; it must not be modified while saving.
+         * @param out The stream to write to.
+         * @param blockSize Decompressed size of each block (the last one may be shorter).
+         * @param level The zlib compression level.
+         * @param pool The pool compressing the blocks.
+         * @throws binary_exception if blockSize is 0, zlib fails or writing fails.
+         */
+        static void save(const binary_editor &editor, std::ostream &out, const size_t &blockSize = DEFAULT_BLOCK_SIZE,
+                         const int &level = Z_DEFAULT_COMPRESSION, worker_pool &pool = worker_pool::shared())
+        {
+            if (blockSize == 0)
+            {
+                throw binary_exception("binary_seekable_deflate::save err : blockSize must not be 0!");
+            }
+
+            std::vector<uint8_t>                           index;
+            std::deque<std::future<std::vector<uint8_t>>> inFlight;
+            uint64_t                                       written    = 0;
+            uint64_t                                       blockCount = 0;
+            size_t                                         offset     = 0;
+            auto                                           writeFront = [&]
+            {
+                std::vector<uint8_t> frame = pool.wait(inFlight.front());
+                inFlight.pop_front();
+                size_t rawSize = std::min(blockSize, editor.size() - blockCount * blockSize);
+                out.write(reinterpret_cast<const char *>(frame.data()), static_cast<std::streamsize>(frame.size()));
+                put_uint64(index, frame.size());
+                put_uint64(index, rawSize);
+                written += frame.size();
+                ++blockCount;
+            };
+
+            for (; offset < editor.size(); offset += blockSize)
+            {
+                if (inFlight.size() >= 2 * pool.size())
+                {
+                    writeFront();
+                }
+                size_t size = std::min(blockSize, editor.size() - offset);
+                inFlight.push_back(pool.submit([&editor, offset, size, level]
+                                               { return deflate_block(editor, offset, size, level); }));
+            }
+            while (!inFlight.empty())
+            {
+                writeFront();
+            }
+
+            put_uint64(index, written);
+            put_uint64(index, blockCount);
+            index.insert(index.end(), std::begin(FOOTER_MAGIC), std::end(FOOTER_MAGIC));
+            out.write(reinterpret_cast<const char *>(index.data()), static_cast<std::streamsize>(index.size()));
+            if (!out)
+            {
+                throw binary_exception("binary_seekable_deflate::save err : write failed!");
+            }
+        }
+
+        /**
+         * @brief Open data in the seekable format as an editor whose blocks inflate on demand.
+         * @param file The saved data, e.g. an editor over a binary_file_source.
+         * @param cacheCapacity Maximum number of blocks kept inflated.
+         * @return The editor.
+         * @throws binary_exception if the footer or index is invalid.
+         */
+        static binary_editor open(const binary_editor &file, const size_t &cacheCapacity = binary_inflate_index::DEFAULT_CACHE_CAPACITY)
+        {
+            if (file.size() < FOOTER_SIZE)
+            {
+                throw binary_exception("binary_seekable_deflate::open err : missing footer!");
+            }
+            auto footer = read_range(file, file.size() - FOOTER_SIZE, FOOTER_SIZE);
+            if (memcmp(footer.data() + 2 * sizeof(uint64_t), FOOTER_MAGIC, sizeof(FOOTER_MAGIC)) != 0)
+            {
+                throw binary_exception("binary_seekable_deflate::open err : bad footer magic!");
+            }
+            uint64_t indexOffset = get_uint64(footer.data());
+            uint64_t blockCount  = get_uint64(footer.data() + sizeof(uint64_t));
+            uint64_t indexSize   = blockCount * 2 * sizeof(uint64_t);
+            if (indexOffset > file.size() - FOOTER_SIZE || blockCount > (file.size() - FOOTER_SIZE - indexOffset) / (2 * sizeof(uint64_t)) ||
+                indexOffset + indexSize != file.size() - FOOTER_SIZE)
+            {
+                throw binary_exception("binary_seekable_deflate::open err : bad index!");
+            }
+
+            // Every block but the last holds the saved block size, and no deflate frame expands more than
+            // MAX_DEFLATE_RATIO times, so a corrupt index cannot make a block allocate more than its frame allows.
+            auto                                   index = read_range(file, indexOffset, indexSize);
+            std::vector<std::pair<size_t, size_t>> frames;
+            size_t                                 inOffset  = 0;
+            uint64_t                               blockSize = blockCount == 0 ? 0 : get_uint64(index.data() + sizeof(uint64_t));
+            for (size_t i = 0; i < blockCount; ++i)
+            {
+                uint64_t frameSize = get_uint64(index.data() + i * 2 * sizeof(uint64_t));
+                uint64_t rawSize   = get_uint64(index.data() + i * 2 * sizeof(uint64_t) + sizeof(uint64_t));
+                if (frameSize > indexOffset - inOffset || rawSize == 0 || rawSize > blockSize || (i + 1 < blockCount && rawSize != blockSize) ||
+                    rawSize / MAX_DEFLATE_RATIO > frameSize)
+                {
+                    throw binary_exception("binary_seekable_deflate::open err : bad block size!");
+                }
+                frames.emplace_back(inOffset, rawSize);
+                inOffset += frameSize;
+            }
+            if (inOffset != indexOffset)
+            {
+                throw binary_exception("binary_seekable_deflate::open err : bad index!");
+            }
+            return binary_inflate_index::from_frames(file.create_sub_editor(0, indexOffset), frames, cacheCapacity)->create_editor();
+        }
+    };
+}
@@ -0,0 +1,350 @@
+#pragma once
+#include "binary_editor.hpp"
+#include "binary_worker_pool.hpp"
+#include "binary_search.hpp"
+#include <bit>
+#include <numeric>
+
+namespace binary
+{
+    namespace detail
+    {
+        /**
+         * @brief Intersect two strictly increasing lists.
+         *
+         * Four values of each list are compared at once: one block is compared against the four rotations
+         * of the other, and the block with the smaller maximum is advanced.
+         *
+         * @param pLhs The first list.
+         * @param lhsSize The size of the first list.
+         * @param pRhs The second list.
+         * @param rhsSize The size of the second list.
+         * @param pOut Receives the common values in increasing order; may alias pLhs.
+         * @return The number of common values.
+         */
+        inline size_t intersect_sorted(const uint32_t *pLhs, const size_t &lhsSize, const uint32_t *pRhs, const size_t &rhsSize, uint32_t *pOut)
+        {
+            size_t i     = 0;
+            size_t j     = 0;
+            size_t count = 0;
+#if defined(BINARY_EDITOR_SSE2)
+            while (i + 4 <= lhsSize && j + 4 <= rhsSize)
+            {
+                __m128i  lhs    = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pLhs + i));
+                __m128i  rhs    = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pRhs + j));
+                __m128i  equal  = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi32(lhs, rhs), _mm_cmpeq_epi32(lhs, _mm_shuffle_epi32(rhs, _MM_SHUFFLE(0, 3, 2, 1)))),
+                                               _mm_or_si128(_mm_cmpeq_epi32(lhs, _mm_shuffle_epi32(rhs, _MM_SHUFFLE(1, 0, 3, 2))),
+                                                            _mm_cmpeq_epi32(lhs, _mm_shuffle_epi32(rhs, _MM_SHUFFLE(2, 1, 0, 3)))));
+                uint32_t mask   = static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(equal)));
+                uint32_t lhsMax = pLhs[i + 3];
+                uint32_t rhsMax = pRhs[j + 3];
+                // pOut may alias pLhs, but never runs ahead of i.
+                while (mask != 0)
+                {
+                    pOut[count++] = pLhs[i + std::countr_zero(mask)];
+                    mask &= mask - 1;
+                }
+                i += lhsMax <= rhsMax ? 4 : 0;
+                j += rhsMax <= lhsMax ? 4 : 0;
+            }
+#endif
+            while (i < lhsSize && j < rhsSize)
+            {
+                if (pLhs[i] < pRhs[j])
+                {
+                    ++i;
+                }
+                else if (pRhs[j] < pLhs[i])
+                {
+                    ++j;
+                }
+                else
+                {
+                    pOut[count++] = pLhs[i];
+                    ++i;
+                    ++j;
+                }
+            }
+            return count;
+        }
+    }
+
+    /**
+     * @brief Inverted index from byte 4-grams to the editors of a corpus containing them.
+     *
+     * Grams are extracted from the editors in parallel. Posting lists are stored delta and varint encoded in
+     * shards chosen by gram hash. A query intersects the postings of the pattern's grams, smallest first, and
+     * verifies the candidates with find(), so results are exact.
+     *
+     * The index keeps copies of the editors, which share their chunks; the chunks must not change afterwards.
+     *
+     * @code
+     * binary::binary_corpus_index index(editors);
+     * for (auto id : index.find(signature)) { report(id); }
+     * @endcode
+     */
+    class binary_corpus_index
+    {
+    public:
+        /**
+         * @brief Number of bytes per indexed gram.
+         */
+        static constexpr size_t GRAM_SIZE = 4;
+
+    private:
+        static constexpr size_t SHARD_COUNT = 256;
+
+        /**
+         * @brief Location of the posting list of one gram in its shard.
+         */
+        struct gram_entry
+        {
+            uint32_t gram;   ///< The gram, first byte most significant
+            uint32_t count;  ///< Number of editors containing it
+            size_t   offset; ///< Offset of the encoded list in the shard
+        };
+
+        /**
+         * @brief Grams with the same hash, sorted by gram, and their encoded posting lists.
+         */
+        struct shard
+        {
+            std::vector<gram_entry> entries;
+            std::vector<uint8_t>    postings;
+        };
+
+        std::vector<binary_editor> m_editors;
+        std::vector<shard>         m_shards;
+
+        /**
+         * @brief Get the shard of a gram.
+         */
+        static size_t shard_of(const uint32_t &gram)
+        {
+            return (gram * 0x9E3779B1u) >> 24;
+        }
+        /**
+         * @brief Collect the distinct grams of an editor, sorted by (shard, gram).
+         */
+        static std::vector<uint32_t> extract_grams(const binary_editor &editor)
+        {
+            std::vector<uint32_t> ret;
+            if (editor.size() < GRAM_SIZE)
+            {
+                return ret;
+            }
+            ret.reserve(editor.size() - GRAM_SIZE + 1);
+            uint32_t gram  = 0;
+            size_t   count = 0;
+            editor.for_each_segment(
+                [&](const uint8_t *pData, const size_t &size)
+                {
+                    for (size_t i = 0; i < size; ++i)
+                    {
+                        gram = gram << 8 | pData[i];
+                        if (++count >= GRAM_SIZE)
+                        {
+                            ret.push_back(gram);
+                        }
+                    }
+                });
+            std::sort(ret.begin(), ret.end(), [](const uint32_t &lhs, const uint32_t &rhs) { return std::pair(shard_of(lhs), lhs) < std::pair(shard_of(rhs), rhs); });
+            ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+            return ret;
+        }
+        /**
+         * @brief Find the entry of a gram.
+         * @return Pointer to the entry, or nullptr if no editor contains the gram.
+         */
+        const gram_entry *find_entry(const uint32_t &gram) const
+        {
+            const auto &entries = m_shards[shard_of(gram)].entries;
+            auto        iter    = std::lower_bound(entries.begin(), entries.end(), gram, [](const gram_entry &entry, const uint32_t &value) { return entry.gram < value; });
+            return iter != entries.end() && iter->gram == gram ? &*iter : nullptr;
+        }
+        /**
+         * @brief Decode the posting list of a gram.
+         */
+        std::vector<uint32_t> decode(const uint32_t &gram, const gram_entry &entry) const
+        {
+            const uint8_t        *pData = m_shards[shard_of(gram)].postings.data() + entry.offset;
+            std::vector<uint32_t> ret(entry.count);
+            uint32_t              value = 0;
+            for (auto &id : ret)
+            {
+                uint32_t delta = 0;
+                for (size_t shift = 0;; shift += 7)
+                {
+                    delta |= static_cast<uint32_t>(*pData & 0x7F) << shift;
+                    if ((*pData++ & 0x80) == 0)
+                    {
+                        break;
+                    }
+                }
+                value += delta;
+                id = value;
+            }
+            return ret;
+        }
+
+    public:
+        /**
+         * @brief Index a corpus.
+         * @param editors The editors; their positions are the ids returned by queries.
+         * @param pool The pool extracting grams and building shards.
+         * @throws binary_exception if there are 2^32 or more editors.
+         */
+        explicit binary_corpus_index(std::span<const binary_editor> editors, worker_pool &pool = worker_pool::shared())
+            : m_editors(editors.begin(), editors.end()), m_shards(SHARD_COUNT)
+        {
+            if (editors.size() > UINT32_MAX)
+            {
+                throw binary_exception("binary_corpus_index::binary_corpus_index err : too many editors!");
+            }
+            std::vector<std::vector<uint32_t>> grams(editors.size());
+            pool.parallel_for(editors.size(), [&](size_t i) { grams[i] = extract_grams(m_editors[i]); });
+
+            pool.parallel_for(SHARD_COUNT,
+                              [&](size_t shardIndex)
+                              {
+                                  // (gram, id) pairs of this shard, sorted so each gram's ids are increasing.
+                                  std::vector<uint64_t> pairs;
+                                  for (size_t id = 0; id < grams.size(); ++id)
+                                  {
+                                      auto first = std::partition_point(grams[id].begin(), grams[id].end(), [&](const uint32_t &gram) { return shard_of(gram) < shardIndex; });
+                                      auto last  = std::partition_point(first, grams[id].end(), [&](const uint32_t &gram) { return shard_of(gram) == shardIndex; });
+                                      for (; first != last; ++first)
+                                      {
+                                          pairs.push_back(static_cast<uint64_t>(*first) << 32 | id);
+                                      }
+                                  }
+                                  std::sort(pairs.begin(), pairs.end());
+
+                                  auto    &current  = m_shards[shardIndex];
+                                  uint32_t previous = 0;
+                                  for (const auto &pair : pairs)
+                                  {
+                                      uint32_t gram = static_cast<uint32_t>(pair >> 32);
+                                      uint32_t id   = static_cast<uint32_t>(pair);
+                                      if (current.entries.empty() || current.entries.back().gram != gram)
+                                      {
+                                          current.entries.push_back({gram, 0, current.postings.size()});
+                                          previous = 0;
+                                      }
+                                      ++current.entries.back().count;
+                                      for (uint32_t delta = id - previous;; delta >>= 7)
+                                      {
+                                          current.postings.push_back(static_cast<uint8_t>((delta & 0x7F) | (delta >= 0x80 ? 0x80 : 0)));
+                                          if (delta < 0x80)
+                                          {
+                                              break;
+                                          }
+                                      }
+                                      previous = id;
+                                  }
+                                  current.postings.shrink_to_fit();
+                              });
+        }
+        /**
+         * @brief Get the number of indexed editors.
+         * @return The editor count.
+         */
+        size_t editor_count() const
+        {
+            return m_editors.size();
+        }
+        /**
+         * @brief Get the number of distinct grams in the corpus.
+         * @return The gram count.
+         */
+        size_t gram_count() const
+        {
+            size_t ret = 0;
+            for (const auto &current : m_shards)
+            {
+                ret += current.entries.size();
+            }
+            return ret;
+        }
+        /**
+         * @brief Get the size of the encoded posting lists.
+         * @return The size in bytes.
+         */
+        size_t posting_size() const
+        {
+            size_t ret = 0;
+            for (const auto &current : m_shards)
+            {
+                ret += current.postings.size();
+            }
+            return ret;
+        }
+        /**
+         * @brief Get the editors that may contain a pattern, from the index alone.
+         * @param pattern The pattern; one shorter than GRAM_SIZE bytes makes every editor a candidate.
+         * @return The candidate ids in increasing order, a superset of the editors containing pattern.
+         */
+        std::vector<uint32_t> candidates(std::span<const uint8_t> pattern) const
+        {
+            std::vector<uint32_t> ret;
+            if (pattern.size() < GRAM_SIZE)
+            {
+                ret.resize(m_editors.size());
+                std::iota(ret.begin(), ret.end(), uint32_t{0});
+                return ret;
+            }
+            std::vector<std::pair<uint32_t, const gram_entry *>> lists;
+            uint32_t                                             gram = 0;
+            for (size_t i = 0; i < pattern.size(); ++i)
+            {
+                gram = gram << 8 | pattern[i];
+                if (i + 1 < GRAM_SIZE)
+                {
+                    continue;
+                }
+                const gram_entry *pEntry = find_entry(gram);
+                if (pEntry == nullptr)
+                {
+                    return ret;
+                }
+                lists.emplace_back(gram, pEntry);
+            }
+            std::sort(lists.begin(), lists.end(), [](const auto &lhs, const auto &rhs) { return lhs.second->count < rhs.second->count; });
+            lists.erase(std::unique(lists.begin(), lists.end()), lists.end());
+
+            ret = decode(lists.front().first, *lists.front().second);
+            for (size_t i = 1; i < lists.size() && !ret.empty(); ++i)
+            {
+                auto other = decode(lists[i].first, *lists[i].second);
+                ret.resize(detail::intersect_sorted(ret.data(), ret.size(), other.data(), other.size(), ret.data()));
+            }
+            return ret;
+        }
+        /**
+         * @brief Find the editors containing a pattern.
+         * @param pattern The pattern; an empty pattern matches nothing.
+         * @param pool The pool verifying candidates.
+         * @return The ids of the editors containing pattern, in increasing order.
+         */
+        std::vector<uint32_t> find(std::span<const uint8_t> pattern, worker_pool &pool = worker_pool::shared()) const
+        {
+            if (pattern.empty())
+            {
+                return {};
+            }
+            auto                 ids = candidates(pattern);
+            std::vector<uint8_t> found(ids.size());
+            pool.parallel_for(ids.size(), [&](size_t i) { found[i] = binary::find(m_editors[ids[i]], pattern).has_value(); });
+            size_t count = 0;
+            for (size_t i = 0; i < ids.size(); ++i)
+            {
+                if (found[i])
+                {
+                    ids[count++] = ids[i];
+                }
+            }
+            ids.resize(count);
+            return ids;
+        }
+    };
+}
@@ -0,0 +1,253 @@
+#pragma once
+#include "binary_editor.hpp"
+#include <bit>
+#include <unordered_map>
+
+namespace binary
+{
+    namespace detail
+    {
+        /**
+         * @brief Append the positions of a byte in a buffer.
+         * @param pData The buffer.
+         * @param size The size of the buffer.
+         * @param value The byte to look for.
+         * @param base Added to every position.
+         * @param positions Receives the positions in increasing order.
+         */
+        inline void find_byte_positions(const uint8_t *pData, const size_t &size, const uint8_t &value, const size_t &base, std::vector<size_t> &positions)
+        {
+            size_t i = 0;
+#if defined(BINARY_EDITOR_SSE2)
+            const __m128i needle = _mm_set1_epi8(static_cast<char>(value));
+            for (; i + 64 <= size; i += 64)
+            {
+                uint64_t mask = 0;
+                for (size_t j = 0; j < 64; j += 16)
+                {
+                    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pData + i + j));
+                    mask |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, needle)))) << j;
+                }
+                while (mask != 0)
+                {
+                    positions.push_back(base + i + std::countr_zero(mask));
+                    mask &= mask - 1;
+                }
+            }
+#endif
+            for (; i < size; ++i)
+            {
+                if (pData[i] == value)
+                {
+                    positions.push_back(base + i);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Index of the positions of a delimiter byte in an editor, giving O(1) access to token N.
+     *
+     * Tokens are the ranges between delimiters, so n delimiters make n + 1 tokens, the last of which is
+     * empty when the data ends with a delimiter. The index keeps the positions found in each chunk and
+     * follows edits of the editor: after the editor changes, only chunks it has not seen are scanned again,
+     * and the sorted positions are gathered from the per-chunk ones on the next lookup.
+     *
+     * @code
+     * binary::binary_delimiter_index lines(editor, '\n');
+     * binary::binary_editor line = lines.token(41); // zero-copy
+     * editor.insert(0, header);
+     * line = lines.token(41);                      // re-indexes only the new and split chunks
+     * @endcode
+     */
+    class binary_delimiter_index
+    {
+    private:
+        /**
+         * @brief Delimiter positions of one chunk, relative to the chunk.
+         */
+        struct chunk_positions
+        {
+            std::shared_ptr<binary_chunk_interface> pChunk;    ///< Keeps the chunk alive so its address stays unique
+            std::vector<size_t>                     positions; ///< Positions relative to the chunk
+        };
+
+        const binary_editor                                                *m_pEditor;
+        uint8_t                                                             m_delimiter;
+        uint64_t                                                            m_generation = 0;
+        std::unordered_map<const binary_chunk_interface *, chunk_positions> m_chunk_positions;
+        std::vector<const std::vector<size_t> *>                            m_chunks;        ///< Positions of each chunk, in editor order
+        std::vector<size_t>                                                 m_chunk_offsets; ///< Offset of each chunk in the editor
+        size_t                                                              m_count = 0;     ///< Number of delimiters
+        std::vector<size_t>                                                 m_positions;     ///< All positions, built on demand by positions()
+        uint64_t                                                            m_positions_generation = 0;
+
+        /**
+         * @brief Get the number of delimiters.
+         * @return The number of delimiters.
+         */
+        size_t delimiter_count() const
+        {
+            return m_count;
+        }
+
+    public:
+        /**
+         * @brief Index an editor.
+         * @param editor The editor; must outlive the index.
+         * @param delimiter The delimiter byte.
+         */
+        binary_delimiter_index(const binary_editor &editor, const uint8_t &delimiter) : m_pEditor(&editor), m_delimiter(delimiter)
+        {
+            rebuild();
+        }
+        /**
+         * @brief Bring the index up to date with the editor; cheap when the editor has not changed.
+         */
+        void refresh()
+        {
+            if (m_generation != m_pEditor->generation())
+            {
+                rebuild();
+            }
+        }
+        /**
+         * @brief Re-index the editor, reusing the positions of chunks indexed before.
+         */
+        void rebuild()
+        {
+            std::unordered_map<const binary_chunk_interface *, chunk_positions> chunkPositions;
+            m_chunks.clear();
+            m_chunk_offsets.clear();
+            m_count = 0;
+            size_t base = 0;
+            m_pEditor->for_each_chunk(
+                [&](const std::shared_ptr<binary_chunk_interface> &pChunk)
+                {
+                    auto iter = chunkPositions.find(pChunk.get());
+                    if (iter == chunkPositions.end())
+                    {
+                        auto known = m_chunk_positions.find(pChunk.get());
+                        if (known != m_chunk_positions.end())
+                        {
+                            iter = chunkPositions.emplace(pChunk.get(), std::move(known->second)).first;
+                        }
+                        else
+                        {
+                            chunk_positions current{pChunk, {}};
+                            auto            pLease = pChunk->lease();
+                            detail::find_byte_positions(pChunk->get_data(), pChunk->size(), m_delimiter, 0, current.positions);
+                            iter = chunkPositions.emplace(pChunk.get(), std::move(current)).first;
+                        }
+                    }
+                    // map nodes do not move, so the pointer stays valid until the next rebuild
+                    m_chunks.push_back(&iter->second.positions);
+                    m_chunk_offsets.push_back(base);
+                    m_count += iter->second.positions.size();
+                    base += pChunk->size();
+                });
+            m_chunk_positions = std::move(chunkPositions);
+            m_generation      = m_pEditor->generation();
+        }
+        /**
+         * @brief Get the delimiter byte.
+         * @return The delimiter.
+         */
+        uint8_t delimiter() const
+        {
+            return m_delimiter;
+        }
+        /**
+         * @brief Get the sorted delimiter positions, gathered from the chunks on the first call after a change.
+         * @return The positions.
+         */
+        const std::vector<size_t> &positions()
+        {
+            refresh();
+            if (m_positions_generation != m_generation)
+            {
+                m_positions.clear();
+                m_positions.reserve(delimiter_count());
+                for (size_t chunk = 0; chunk < m_chunks.size(); ++chunk)
+                {
+                    for (const auto &position : *m_chunks[chunk])
+                    {
+                        m_positions.push_back(m_chunk_offsets[chunk] + position);
+                    }
+                }
+                m_positions_generation = m_generation;
+            }
+            return m_positions;
+        }
+        /**
+         * @brief Get the number of tokens, one more than the number of delimiters.
+         * @return The number of tokens.
+         */
+        size_t token_count()
+        {
+            refresh();
+            return delimiter_count() + 1;
+        }
+        /**
+         * @brief Get the range of a token, excluding its delimiter.
+         * @param index The token index.
+         * @return The offset and size of the token.
+         * @throws binary_exception if index is not less than token_count().
+         */
+        std::pair<size_t, size_t> token_range(const size_t &index)
+        {
+            const auto &allPositions = positions();
+            if (index > allPositions.size())
+            {
+                throw binary_exception("binary_delimiter_index::token_range err : index must be less than token_count()!");
+            }
+            size_t first = index == 0 ? 0 : allPositions[index - 1] + 1;
+            size_t last  = index == allPositions.size() ? m_pEditor->size() : allPositions[index];
+            return {first, last - first};
+        }
+        /**
+         * @brief Get a token as a zero-copy sub-editor.
+         * @param index The token index.
+         * @return The token.
+         * @throws binary_exception if index is not less than token_count().
+         */
+        binary_editor token(const size_t &index)
+        {
+            auto [offset, size] = token_range(index);
+            return size == 0 ? binary_editor() : m_pEditor->create_sub_editor_unchecked(offset, size);
+        }
+    };
+
+    /**
+     * @brief Split an editor at every occurrence of a delimiter byte without copying.
+     * @param editor The editor to split.
+     * @param delimiter The delimiter byte.
+     * @return The tokens as sub-editors; n delimiters give n + 1 tokens.
+     */
+    inline std::vector<binary_editor> split(const binary_editor &editor, const uint8_t &delimiter)
+    {
+        std::vector<size_t> positions;
+        size_t              base = 0;
+        editor.for_each_segment(
+            [&](const uint8_t *pData, const size_t &size)
+            {
+                detail::find_byte_positions(pData, size, delimiter, base, positions);
+                base += size;
+            });
+
+        std::vector<binary_editor> ret;
+        ret.reserve(positions.size() + 1);
+        size_t first     = 0;
+        auto   pushToken = [&](const size_t &last)
+        {
+            ret.push_back(last == first ? binary_editor() : editor.create_sub_editor_unchecked(first, last - first));
+            first = last + 1;
+        };
+        for (const auto &position : positions)
+        {
+            pushToken(position);
+        }
+        pushToken(editor.size());
+        return ret;
+    }
+}
@@ -1,10 +1,31 @@
 #pragma once
 #include <memory>
+#include <array>
+#include <mutex>
 #include <string>
 #include <deque>
 #include <iterator>
 #include <cstring>
 #include <variant>
+#include <vector>
+#include <algorithm>
+#include <optional>
+#include <atomic>
+#include <span>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BINARY_EDITOR_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(__SSSE3__) || defined(__AVX__)
+#define BINARY_EDITOR_SSSE3 1
+#include <tmmintrin.h>
+#endif
 
 namespace binary
 {
@@ -48,15 +69,332 @@ namespace binary
      */
     enum class CHUNK_TYPE
     {
-        MEMORY ///< Memory chunk
+        MEMORY,     ///< Memory chunk
+        FILE,       ///< File-backed chunk
+        COMPRESSED, ///< Chunk decompressed on demand
+        STATIC      ///< Chunk referring to storage that outlives it
     };
 
+    // file-backed chunks and their source, see binary_file.hpp
+    class binary_file_source;
+    struct binary_file_changes;
+
+    namespace detail
+    {
+        /**
+         * @brief Assumed cache line size in bytes.
+         */
+        constexpr size_t CACHE_LINE_SIZE = 64;
+
+        /**
+         * @brief Identifies one state of an editor's chunk list.
+         *
+         * Every structural change takes a fresh value from a global counter, so caches keyed by it can never match
+         * a different chunk list. Copies share the value since they share the chunks; a moved-from object takes a
+         * fresh one.
+         */
+        class chunk_generation
+        {
+        private:
+            uint64_t m_value = next(); ///< Current generation
+
+            /**
+             * @brief Take the next value of the global counter.
+             * @return A value not used by any other generation.
+             */
+            static uint64_t next()
+            {
+                static std::atomic<uint64_t> counter{1};
+                return counter.fetch_add(1, std::memory_order_relaxed);
+            }
+
+        public:
+            chunk_generation() = default;
+            chunk_generation(const chunk_generation &) = default;
+            chunk_generation &operator=(const chunk_generation &) = default;
+            chunk_generation(chunk_generation &&other) noexcept
+                : m_value(other.m_value)
+            {
+                other.renew();
+            }
+            chunk_generation &operator=(chunk_generation &&other) noexcept
+            {
+                m_value = other.m_value;
+                other.renew();
+                return *this;
+            }
+            /**
+             * @brief Take a fresh value after a structural change.
+             */
+            void renew()
+            {
+                m_value = next();
+            }
+            /**
+             * @brief Get the current value.
+             * @return The generation value.
+             */
+            uint64_t value() const
+            {
+                return m_value;
+            }
+        };
+
+        /**
+         * @brief Hint the CPU to load the cache line holding an address.
+         * @param pAddress The address to prefetch.
+         */
+        inline void prefetch(const void *pAddress)
+        {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+            _mm_prefetch(static_cast<const char *>(pAddress), _MM_HINT_T0);
+#elif defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(pAddress);
+#else
+            (void)pAddress;
+#endif
+        }
+    }
+
+    /**
+     * @brief Summary of the bytes of a chunk, letting searches skip chunks that cannot contain a match.
+     *
+     * Both sets are supersets: a byte or pair reported absent never occurs, while a pair reported present
+     * may be a bloom filter collision.
+     */
+    struct chunk_summary
+    {
+        /**
+         * @brief Chunks smaller than this are scanned directly, a summary would not pay for itself.
+         */
+        static constexpr size_t MIN_CHUNK_SIZE = 4096;
+        /**
+         * @brief Number of bits of the bigram bloom filter.
+         */
+        static constexpr size_t BIGRAM_BITS = 4096;
+
+        std::array<uint64_t, 4>                bytes{};   ///< Bit b is set if byte b occurs
+        std::array<uint64_t, BIGRAM_BITS / 64> bigrams{}; ///< Bloom filter of adjacent byte pairs
+
+        /**
+         * @brief Get the bloom filter bit of a byte pair.
+         * @param first The first byte.
+         * @param second The byte following it.
+         * @return The bit index.
+         */
+        static constexpr size_t bigram_bit(const uint8_t &first, const uint8_t &second)
+        {
+            return (static_cast<uint32_t>(first << 8 | second) * 0x9E3779B1u) >> 20;
+        }
+        /**
+         * @brief Summarize a buffer.
+         * @param pData The data pointer.
+         * @param size The size of the data.
+         * @return The summary.
+         */
+        static chunk_summary compute(const uint8_t *pData, const size_t &size)
+        {
+            chunk_summary ret;
+            // Independent stores instead of read-modify-write on four words.
+            uint8_t seen[256] = {};
+            for (size_t i = 0; i < size; ++i)
+            {
+                seen[pData[i]] = 1;
+            }
+            for (size_t i = 0; i < 256; ++i)
+            {
+                ret.bytes[i >> 6] |= static_cast<uint64_t>(seen[i]) << (i & 63);
+            }
+            for (size_t i = 1; i < size; ++i)
+            {
+                size_t bit = bigram_bit(pData[i - 1], pData[i]);
+                ret.bigrams[bit >> 6] |= 1ull << (bit & 63);
+            }
+            return ret;
+        }
+        /**
+         * @brief Check whether a byte occurs.
+         * @param value The byte.
+         * @return True if it occurs.
+         */
+        bool contains(const uint8_t &value) const
+        {
+            return (bytes[value >> 6] >> (value & 63)) & 1;
+        }
+        /**
+         * @brief Check whether any byte of a set occurs.
+         * @param mask The set, bit b of word b / 64 standing for byte b.
+         * @return True if one of them occurs.
+         */
+        bool contains_any(const std::array<uint64_t, 4> &mask) const
+        {
+            return ((bytes[0] & mask[0]) | (bytes[1] & mask[1]) | (bytes[2] & mask[2]) | (bytes[3] & mask[3])) != 0;
+        }
+        /**
+         * @brief Check whether a byte sequence may occur.
+         * @param needle The bytes.
+         * @return False if the sequence certainly does not occur.
+         */
+        bool may_contain(std::span<const uint8_t> needle) const
+        {
+            for (size_t i = 0; i < needle.size(); ++i)
+            {
+                if (!contains(needle[i]))
+                {
+                    return false;
+                }
+                if (i > 0)
+                {
+                    size_t bit = bigram_bit(needle[i - 1], needle[i]);
+                    if (((bigrams[bit >> 6] >> (bit & 63)) & 1) == 0)
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+    };
+
+    namespace detail
+    {
+        /**
+         * @brief Lazily computed chunk_summary of a chunk.
+         *
+         * The summary is tied to the data pointer and size it was computed from, so a chunk that is downscaled
+         * or reloaded elsewhere recomputes it. Copies start empty, as sub-chunks cover different bytes. It is
+         * computed without holding a lock and published atomically, so readers never wait for another thread.
+         */
+        class chunk_summary_cache
+        {
+        private:
+            /**
+             * @brief A summary with the buffer it was computed from.
+             */
+            struct entry
+            {
+                const uint8_t *pData = nullptr; ///< Data pointer of the buffer
+                size_t         size  = 0;       ///< Size of the buffer
+                chunk_summary  summary;         ///< Summary of the buffer
+            };
+
+            mutable std::atomic<std::shared_ptr<const entry>> m_pEntry;            ///< Last published summary
+            mutable std::atomic<bool>                         m_computing = false; ///< Set while try_get() computes
+
+            /**
+             * @brief Get the published summary if it belongs to a buffer.
+             * @param pData The data pointer.
+             * @param size The size of the data.
+             * @return Shared pointer to the summary, or nullptr if none matches.
+             */
+            std::shared_ptr<const chunk_summary> load(const uint8_t *pData, const size_t &size) const
+            {
+                auto pEntry = m_pEntry.load(std::memory_order_acquire);
+                if (pEntry == nullptr || pEntry->pData != pData || pEntry->size != size)
+                {
+                    return nullptr;
+                }
+                return std::shared_ptr<const chunk_summary>(pEntry, &pEntry->summary);
+            }
+            /**
+             * @brief Publish a summary of a buffer.
+             * @param pData The data pointer.
+             * @param size The size of the data.
+             * @param summary The summary.
+             * @return Shared pointer to the published summary.
+             */
+            std::shared_ptr<const chunk_summary> publish(const uint8_t *pData, const size_t &size, const chunk_summary &summary) const
+            {
+                auto pEntry = std::make_shared<const entry>(entry{pData, size, summary});
+                m_pEntry.store(pEntry, std::memory_order_release);
+                return std::shared_ptr<const chunk_summary>(pEntry, &pEntry->summary);
+            }
+
+        public:
+            chunk_summary_cache() = default;
+            chunk_summary_cache(const chunk_summary_cache &)
+            {
+            }
+            chunk_summary_cache &operator=(const chunk_summary_cache &)
+            {
+                m_pEntry.store(nullptr, std::memory_order_release);
+                return *this;
+            }
+            /**
+             * @brief Get the summary of a buffer, computing it unless it is cached.
+             *
+             * Threads asking at the same time may each compute it; the last one published is kept.
+             *
+             * @param pData The data pointer.
+             * @param size The size of the data.
+             * @return Shared pointer to the summary.
+             */
+            std::shared_ptr<const chunk_summary> get(const uint8_t *pData, const size_t &size) const
+            {
+                auto ret = load(pData, size);
+                if (ret == nullptr)
+                {
+                    ret = publish(pData, size, chunk_summary::compute(pData, size));
+                }
+                return ret;
+            }
+            /**
+             * @brief Get the summary of a buffer if it is cached, optionally computing it.
+             * @param pData The data pointer.
+             * @param size The size of the data.
+             * @param compute Whether to compute a missing summary; skipped while another thread computes one.
+             * @return Shared pointer to the summary, or nullptr if it is not available.
+             */
+            std::shared_ptr<const chunk_summary> try_get(const uint8_t *pData, const size_t &size, const bool &compute) const
+            {
+                auto ret = load(pData, size);
+                if (ret != nullptr || !compute || m_computing.exchange(true, std::memory_order_acquire))
+                {
+                    return ret;
+                }
+                chunk_summary summary = chunk_summary::compute(pData, size);
+                m_computing.store(false, std::memory_order_release);
+                return publish(pData, size, summary);
+            }
+        };
+    }
+
     /**
      * @brief Interface for binary chunk.
      */
     class binary_chunk_interface
     {
+    private:
+        detail::chunk_summary_cache m_summary_cache; ///< Summary computed by the first search that asks for it
+
     public:
+        virtual ~binary_chunk_interface() = default;
+        /**
+         * @brief Get the summary of the chunk's bytes, computing it on first use.
+         *
+         * Computing reads the whole chunk once; later calls return the cached summary while the chunk is unchanged.
+         *
+         * @return Shared pointer to the summary.
+         */
+        std::shared_ptr<const chunk_summary> summary() const
+        {
+            auto pLease = lease();
+            return m_summary_cache.get(get_data(), size());
+        }
+        /**
+         * @brief Get the summary of the chunk's bytes if it is cached, optionally computing it.
+         *
+         * Searches that only read part of the chunk pass compute = false, so they never pay for reading all of it;
+         * while another thread computes the summary this returns nullptr rather than waiting.
+         *
+         * @param compute Whether to compute a missing summary.
+         * @return Shared pointer to the summary, or nullptr if it is not available.
+         */
+        std::shared_ptr<const chunk_summary> try_summary(const bool &compute) const
+        {
+            auto pLease = lease();
+            return m_summary_cache.try_get(get_data(), size(), compute);
+        }
         /**
          * @brief Create a sub-chunk from this chunk.
          * @param offset The offset to start from.
@@ -71,9 +409,28 @@ namespace binary
         virtual size_t size() const = 0;
         /**
          * @brief Get the data pointer of the chunk.
+         *
+         * Chunks that load their data on demand only guarantee the pointer while a lease() is held.
+         *
          * @return Pointer to the data.
          */
         virtual const uint8_t *get_data() const = 0;
+        /**
+         * @brief Keep the chunk's data resident while the returned handle lives.
+         * @return Handle to hold while using get_data(), or nullptr if the data lives as long as the chunk.
+         */
+        virtual std::shared_ptr<const void> lease() const
+        {
+            return nullptr;
+        }
+        /**
+         * @brief Get the file a chunk of type CHUNK_TYPE::FILE maps and the file offset it ends at.
+         * @return The source and the end offset, or {nullptr, 0} for chunks that do not map a file.
+         */
+        virtual std::pair<std::shared_ptr<const binary_file_source>, size_t> file_end() const
+        {
+            return {nullptr, 0};
+        }
         /**
          * @brief Get the type of the chunk.
          * @return The chunk type.
@@ -132,7 +489,7 @@ namespace binary
                 throw binary_exception("binary_chunk_memory::create_sub_chunk err : (offset + size) must not be greater than m_Size!");
             }
             auto pRet = std::make_shared<binary_chunk_memory>(*this);
-            pRet->m_offset = offset;
+            pRet->m_offset += offset;
             pRet->m_size = size;
             return std::dynamic_pointer_cast<binary_chunk_interface>(pRet);
         }
@@ -173,6 +530,80 @@ namespace binary
         }
     };
 
+    /**
+     * @brief Implementation of a chunk referring to storage it does not own, such as a static constexpr array.
+     *
+     * Nothing is copied or freed; the storage must stay valid and unchanged while any editor refers to the chunk.
+     */
+    class binary_chunk_static : public binary_chunk_interface
+    {
+    private:
+        const uint8_t *m_pData = nullptr;
+        size_t         m_size  = 0;
+
+    public:
+        /**
+         * @brief Construct a static chunk.
+         * @param pData The data pointer.
+         * @param size The size of the data.
+         * @throws binary_exception if pData is nullptr.
+         */
+        binary_chunk_static(const uint8_t *pData, const size_t &size)
+            : m_pData(pData), m_size(size)
+        {
+            if (pData == nullptr)
+            {
+                throw binary_exception("binary_chunk_static::binary_chunk_static err : pData must not be nullptr!");
+            }
+        }
+        /**
+         * @copydoc binary_chunk_interface::create_sub_chunk
+         */
+        virtual std::shared_ptr<binary_chunk_interface> create_sub_chunk(const size_t &offset, const size_t &size) const override final
+        {
+            if (offset + size > m_size)
+            {
+                throw binary_exception("binary_chunk_static::create_sub_chunk err : (offset + size) must not be greater than m_Size!");
+            }
+            return std::make_shared<binary_chunk_static>(m_pData + offset, size);
+        }
+        /**
+         * @copydoc binary_chunk_interface::size
+         */
+        virtual size_t size() const override final
+        {
+            return m_size;
+        }
+        /**
+         * @copydoc binary_chunk_interface::get_data
+         */
+        virtual const uint8_t *get_data() const override final
+        {
+            return m_pData;
+        }
+        /**
+         * @copydoc binary_chunk_interface::get_type
+         */
+        virtual CHUNK_TYPE get_type() const override final
+        {
+            return CHUNK_TYPE::STATIC;
+        }
+        /**
+         * @copydoc binary_chunk_interface::clone
+         */
+        virtual std::unique_ptr<binary_chunk_interface> clone() const override
+        {
+            return std::make_unique<binary_chunk_static>(*this);
+        }
+        /**
+         * @copydoc binary_chunk_interface::downscale_size
+         */
+        virtual void downscale_size(const size_t &targeSize) override final
+        {
+            m_size = targeSize;
+        }
+    };
+
     /**
      * @brief Factory for creating binary chunks.
      */
@@ -211,6 +642,21 @@ namespace binary
                 throw binary_exception("binary_chunk_factory::create_chunk err : unknown create strategy!");
             }
         }
+        /**
+         * @brief Create a chunk without throwing on invalid arguments.
+         * @param pBlob The data pointer.
+         * @param size The size of the data.
+         * @param offset The offset in the data.
+         * @return Shared pointer to the created chunk, or nullptr if offset > size or pBlob is nullptr.
+         */
+        std::shared_ptr<binary_chunk_interface> try_create_chunk(std::unique_ptr<const uint8_t[]> &&pBlob, const size_t &size, const size_t &offset = 0) const
+        {
+            if (offset > size || pBlob == nullptr)
+            {
+                return nullptr;
+            }
+            return create_chunk(std::move(pBlob), size, offset);
+        }
     };
 
     /**
@@ -218,16 +664,154 @@ namespace binary
      */
     class binary_editor
     {
+    public:
+        /**
+         * @brief Default number of cache lines prefetched ahead when walking segments.
+         */
+        static constexpr size_t DEFAULT_PREFETCH_DISTANCE = 4;
+
     private:
         mutable std::deque<std::shared_ptr<binary_chunk_interface>> m_pChunks; ///< Chunks managed by the editor
         binary_chunk_factory m_binary_chunk_factory;                           ///< Factory for creating chunks
         bool m_auto_tidy = false;                                              ///< Whether to auto tidy chunks
         size_t m_auto_tidy_size = 0;                                           ///< Auto tidy threshold
+        size_t m_prefetch_distance = DEFAULT_PREFETCH_DISTANCE;                ///< Cache lines prefetched ahead by segment walks
+        size_t m_size = 0;                                                     ///< Total size of all chunks
+        mutable detail::chunk_generation m_generation;                         ///< Renewed on every change to m_pChunks
+
+        /**
+         * @brief A file chunk merged by tidy_chunks() as the last chunk, so apply_file_changes() can still follow the file.
+         */
+        struct merged_tail
+        {
+            std::weak_ptr<const binary_file_source> pSource;        ///< Source of the merged chunk
+            size_t                                  file_end   = 0; ///< File offset the merged chunk ended at
+            uint64_t                                generation = 0; ///< Generation right after merging
+        };
+        mutable merged_tail m_merged_tail; ///< Valid while the generation is unchanged
+
+        /**
+         * @brief How many requests ahead read_many() prefetches.
+         */
+        static constexpr size_t READ_PREFETCH_DISTANCE = 8;
+
+        /**
+         * @brief Last chunk hit by an offset lookup on this thread.
+         */
+        struct finger
+        {
+            uint64_t generation = 0; ///< Generation of the editor the finger points into
+            size_t   index      = 0; ///< Chunk index
+            size_t   base       = 0; ///< Offset of the chunk in the editor
+        };
+
+        /**
+         * @brief Get the finger of the calling thread.
+         *
+         * Being thread-local, concurrent const readers of one editor do not race on it; being keyed by generation,
+         * it is ignored after any structural change or when another editor was looked up last.
+         *
+         * @return Reference to the finger.
+         */
+        static finger &thread_finger()
+        {
+            static thread_local finger instance;
+            return instance;
+        }
+
+        /**
+         * @brief Find the chunk containing an offset, starting from the finger when it is valid.
+         *
+         * Lookups near the previous one walk only the chunks in between, so clustered edits and reads resolve in
+         * O(1) amortized instead of searching from the front.
+         *
+         * @param offset The offset to find, must not be greater than size().
+         * @return (index, base) of the chunk containing offset, or (chunk count, size()) if offset == size().
+         */
+        std::pair<size_t, size_t> locate(const size_t &offset) const
+        {
+            auto  &current = thread_finger();
+            size_t index   = 0;
+            size_t base    = 0;
+            if (current.generation == m_generation.value())
+            {
+                index = current.index;
+                base  = current.base;
+            }
+            while (index > 0 && base > offset)
+            {
+                --index;
+                base -= m_pChunks[index]->size();
+            }
+            while (index < m_pChunks.size() && base + m_pChunks[index]->size() <= offset)
+            {
+                base += m_pChunks[index]->size();
+                ++index;
+            }
+            current = {m_generation.value(), index, base};
+            return {index, base};
+        }
+
+        /**
+         * @brief Insert chunks covering a file range, one per block.
+         * @param iter Position to insert at.
+         * @param pSource The file source.
+         * @param offset The file offset to start from.
+         * @param size The size of the range.
+         */
+        void insert_file_range(std::deque<std::shared_ptr<binary_chunk_interface>>::iterator iter,
+                               const std::shared_ptr<binary_file_source> &pSource, size_t offset, size_t size);
+
     public:
         /**
          * @brief Default constructor.
          */
         binary_editor() = default;
+        /**
+         * @brief Copy constructor, sharing the chunks.
+         */
+        binary_editor(const binary_editor &) = default;
+        /**
+         * @brief Copy assignment operator, sharing the chunks.
+         */
+        binary_editor &operator=(const binary_editor &) = default;
+        /**
+         * @brief Move constructor, leaving other empty.
+         * @param other The editor to move from.
+         */
+        binary_editor(binary_editor &&other)
+            : m_pChunks(std::move(other.m_pChunks)),
+              m_binary_chunk_factory(other.m_binary_chunk_factory),
+              m_auto_tidy(other.m_auto_tidy),
+              m_auto_tidy_size(other.m_auto_tidy_size),
+              m_prefetch_distance(other.m_prefetch_distance),
+              m_size(std::exchange(other.m_size, 0)),
+              m_generation(std::move(other.m_generation)),
+              m_merged_tail(std::move(other.m_merged_tail))
+        {
+            other.m_pChunks.clear();
+        }
+        /**
+         * @brief Move assignment operator, leaving other empty.
+         * @param other The editor to move from.
+         * @return Reference to this editor.
+         */
+        binary_editor &operator=(binary_editor &&other)
+        {
+            if (this != &other)
+            {
+                m_pChunks              = std::move(other.m_pChunks);
+                m_binary_chunk_factory = other.m_binary_chunk_factory;
+                m_auto_tidy            = other.m_auto_tidy;
+                m_auto_tidy_size       = other.m_auto_tidy_size;
+                m_prefetch_distance    = other.m_prefetch_distance;
+                m_size                 = std::exchange(other.m_size, 0);
+                m_generation           = std::move(other.m_generation);
+                m_merged_tail          = std::move(other.m_merged_tail);
+                other.m_pChunks.clear();
+            }
+            return *this;
+        }
         /**
          * @brief Construct editor from a blob.
          * @param pBlob The data pointer.
@@ -236,6 +820,7 @@ namespace binary
         binary_editor(std::unique_ptr<const uint8_t[]> &&pBlob, const size_t &size)
         {
             m_pChunks.push_back(m_binary_chunk_factory.create_chunk(std::move(pBlob), size));
+            m_size = size;
         }
 
         /**
@@ -249,33 +834,75 @@ namespace binary
             memcpy(buffer.get(), pBlob, size);
             *this = binary_editor(std::move(buffer), size);
         }
+        /**
+         * @brief Construct editor holding a single chunk.
+         * @param pChunk The chunk.
+         * @throws binary_exception if pChunk is nullptr.
+         */
+        binary_editor(std::shared_ptr<binary_chunk_interface> pChunk)
+        {
+            if (pChunk == nullptr)
+            {
+                throw binary_exception("binary_editor::binary_editor err : pChunk must not be nullptr!");
+            }
+            m_size = pChunk->size();
+            m_pChunks.push_back(std::move(pChunk));
+        }
+        /**
+         * @brief Construct editor from a file source, one chunk per block.
+         * @param pSource The file source.
+         * @throws binary_exception if pSource is nullptr.
+         */
+        binary_editor(const std::shared_ptr<binary_file_source> &pSource);
         /**
          * @brief Get the total size of all chunks.
          * @return Total size in bytes.
          */
         size_t size() const
         {
-            size_t ret = 0;
-            for (auto &pChunk : m_pChunks)
-            {
-                ret += pChunk->size();
-            }
-            return ret;
+            return m_size;
+        }
+        /**
+         * @brief Check whether a range lies within the editor.
+         * @param offset The offset of the range.
+         * @param size The size of the range.
+         * @return True if (offset + size) does not exceed size() and does not overflow.
+         */
+        bool is_valid_range(const size_t &offset, const size_t &size) const
+        {
+            size_t currentSize = this->size();
+            return offset <= currentSize && size <= currentSize - offset;
         }
         /**
          * @brief Merge all chunks into one.
          */
         void tidy_chunks() const
         {
+            if (m_pChunks.size() == 1)
+            {
+                return;
+            }
+            merged_tail tail;
+            if (!m_pChunks.empty() && m_pChunks.back()->get_type() == CHUNK_TYPE::FILE)
+            {
+                auto [pSource, fileEnd] = m_pChunks.back()->file_end();
+                tail.pSource            = pSource;
+                tail.file_end           = fileEnd;
+            }
             size_t totalSize = size();
             std::unique_ptr<uint8_t[]> pBlob = std::make_unique<uint8_t[]>(totalSize);
             auto pCurrent = pBlob.get();
-            for (auto &pChunk : m_pChunks)
-            {
-                memcpy(pCurrent, pChunk->get_data(), pChunk->size());
-                pCurrent += pChunk->size();
-            }
-            *const_cast<binary_editor *>(this) = binary_editor(std::move(pBlob), totalSize);
+            for_each_segment(
+                [&pCurrent](const uint8_t *pData, const size_t &size)
+                {
+                    memcpy(pCurrent, pData, size);
+                    pCurrent += size;
+                });
+            m_pChunks.clear();
+            m_pChunks.push_back(m_binary_chunk_factory.create_chunk(std::move(pBlob), totalSize));
+            m_generation.renew();
+            tail.generation = m_generation.value();
+            m_merged_tail   = std::move(tail);
         }
         /**
          * @brief Get the pointer to the merged data.
@@ -286,6 +913,17 @@ namespace binary
             tidy_chunks();
             return m_pChunks.front()->get_data();
         }
+        /**
+         * @brief Get the pointer to the merged data together with a lease keeping it resident.
+         * @param lease Receives the merged chunk's lease(); the pointer stays valid while it is held.
+         * @return Pointer to the data.
+         */
+        const void *get_data(std::shared_ptr<const void> &lease) const
+        {
+            tidy_chunks();
+            lease = m_pChunks.front()->lease();
+            return m_pChunks.front()->get_data();
+        }
         /**
          * @brief Create a sub-editor from a range.
          * @param offset The offset to start from.
@@ -295,46 +933,350 @@ namespace binary
          */
         binary_editor create_sub_editor(const size_t &offset, const size_t size) const
         {
-            // check size
-            size_t currentSize = this->size();
-            if (offset + size > currentSize)
+            if (!is_valid_range(offset, size))
             {
                 throw binary_exception("binary_editor::create_sub_editor err : (offset + size) must not be greater than m_Size!");
             }
-
-            // clone data
-            size_t currentOffset = 0;
-            size_t currentChunkSize = 0;
+            return create_sub_editor_unchecked(offset, size);
+        }
+        /**
+         * @brief Create a sub-editor from a range without throwing on an invalid range.
+         * @param offset The offset to start from.
+         * @param size The size of the sub-editor.
+         * @return The sub-editor, or std::nullopt if range is invalid.
+         */
+        std::optional<binary_editor> try_create_sub_editor(const size_t &offset, const size_t size) const
+        {
+            if (!is_valid_range(offset, size))
+            {
+                return std::nullopt;
+            }
+            return create_sub_editor_unchecked(offset, size);
+        }
+        /**
+         * @brief Create a sub-editor from a range the caller has already validated.
+         * @param offset The offset to start from.
+         * @param size The size of the sub-editor, (offset + size) must not be greater than size().
+         * @return The sub-editor.
+         */
+        binary_editor create_sub_editor_unchecked(const size_t &offset, const size_t size) const
+        {
+            auto [index, base]  = locate(offset);
+            size_t chunkOffset  = offset - base;
+            size_t remainSize   = size;
             binary_editor ret;
-            for (const auto &pChunk : m_pChunks)
+            for (auto iter = m_pChunks.begin() + index; remainSize > 0; ++iter, chunkOffset = 0)
+            {
+                // clone the overlapping part of the chunk
+                size_t needSize = std::min(remainSize, (*iter)->size() - chunkOffset);
+                ret.m_pChunks.push_back((*iter)->create_sub_chunk(chunkOffset, needSize));
+                remainSize -= needSize;
+            }
+            ret.m_size = size;
+
+            return ret;
+        }
+        /**
+         * @brief Walk the contiguous segments (chunk data) covering a range.
+         *
+         * Before func is called for a segment, the first prefetch_distance() cache lines of the next segment are
+         * prefetched, so the jump to the next chunk does not stall the hardware prefetcher. pData is only valid
+         * while func runs; the chunk's lease() is held for that long.
+         *
+         * @tparam Func Callable as func(const uint8_t *pData, const size_t &size); may return bool, false stops the walk.
+         * @param offset The offset to start from.
+         * @param size The size of the range.
+         * @param func Called for each segment in order.
+         * @throws binary_exception if range is invalid.
+         */
+        template <typename Func>
+        void for_each_segment(const size_t &offset, const size_t &size, Func &&func) const
+        {
+            if (!is_valid_range(offset, size))
             {
-                // check whether push in chunk is needed
-                if (currentOffset + pChunk->size() <= offset)
+                throw binary_exception("binary_editor::for_each_segment err : (offset + size) must not be greater than m_Size!");
+            }
+            for_each_chunk_segment(offset, size,
+                                   [&func](const binary_chunk_interface &, const uint8_t *pSegment, const size_t &segmentSize)
+                                   {
+                                       if constexpr (std::is_same_v<std::invoke_result_t<Func &, const uint8_t *, const size_t &>, bool>)
+                                       {
+                                           return func(pSegment, segmentSize);
+                                       }
+                                       else
+                                       {
+                                           func(pSegment, segmentSize);
+                                           return true;
+                                       }
+                                   });
+        }
+        /**
+         * @brief Walk the contiguous segments covering a range together with the chunks holding them.
+         *
+         * Prefetches like for_each_segment(). The chunk gives access to its summary(), which covers every
+         * segment taken from it; computing it reads the whole chunk, so prefer try_summary() for partial segments.
+         *
+         * @tparam Func Callable as func(const binary_chunk_interface &chunk, const uint8_t *pData, const size_t &size);
+         *              may return bool, false stops the walk.
+         * @param offset The offset to start from.
+         * @param size The size of the range.
+         * @param func Called for each segment in order.
+         * @throws binary_exception if range is invalid.
+         */
+        template <typename Func>
+        void for_each_chunk_segment(const size_t &offset, const size_t &size, Func &&func) const
+        {
+            if (!is_valid_range(offset, size))
+            {
+                throw binary_exception("binary_editor::for_each_chunk_segment err : (offset + size) must not be greater than m_Size!");
+            }
+
+            auto [index, base] = locate(offset);
+            auto   iter        = m_pChunks.begin() + index;
+            size_t chunkOffset = offset - base;
+            size_t remainSize  = size;
+            for (; remainSize > 0; ++iter, chunkOffset = 0)
+            {
+                size_t segmentSize = std::min(remainSize, (*iter)->size() - chunkOffset);
+                if (segmentSize == 0)
                 {
-                    currentOffset += pChunk->size();
                     continue;
                 }
+                remainSize -= segmentSize;
+                // compressed chunks are not resident, touching them would decompress
+                if (remainSize > 0 && std::next(iter) != m_pChunks.end() && (*std::next(iter))->get_type() != CHUNK_TYPE::COMPRESSED)
+                {
+                    const auto &pNextChunk = *std::next(iter);
+                    size_t      nextSize   = std::min(remainSize, pNextChunk->size());
+                    size_t      nextLines  = std::min(m_prefetch_distance, (nextSize + detail::CACHE_LINE_SIZE - 1) / detail::CACHE_LINE_SIZE);
+                    for (size_t line = 0; line < nextLines; ++line)
+                    {
+                        detail::prefetch(pNextChunk->get_data() + line * detail::CACHE_LINE_SIZE);
+                    }
+                }
 
-                // clone chunk and resize
+                auto           pLease   = (*iter)->lease();
+                const uint8_t *pSegment = (*iter)->get_data() + chunkOffset;
+                if constexpr (std::is_same_v<std::invoke_result_t<Func &, const binary_chunk_interface &, const uint8_t *, const size_t &>, bool>)
+                {
+                    if (!func(**iter, pSegment, segmentSize))
+                    {
+                        return;
+                    }
+                }
+                else
+                {
+                    func(**iter, pSegment, segmentSize);
+                }
+            }
+        }
+        /**
+         * @brief Walk the contiguous segments (chunk data) covering a range from the last to the first.
+         *
+         * Before func is called for a segment, the last prefetch_distance() cache lines of the previous segment
+         * are prefetched.
+         *
+         * @tparam Func Callable as func(const uint8_t *pData, const size_t &size); may return bool, false stops the walk.
+         * @param offset The offset of the range.
+         * @param size The size of the range.
+         * @param func Called for each segment in reverse order.
+         * @throws binary_exception if range is invalid.
+         */
+        template <typename Func>
+        void for_each_segment_reverse(const size_t &offset, const size_t &size, Func &&func) const
+        {
+            if (!is_valid_range(offset, size))
+            {
+                throw binary_exception("binary_editor::for_each_segment_reverse err : (offset + size) must not be greater than m_Size!");
+            }
+            if (size == 0)
+            {
+                return;
+            }
 
-                std::shared_ptr<binary_chunk_interface> pNewChunk;
-                auto needSize = size - currentChunkSize;
-                if (needSize > pChunk->size())
+            auto [index, base] = locate(offset + size - 1);
+            size_t chunkEnd    = offset + size - base;
+            size_t remainSize  = size;
+            while (true)
+            {
+                size_t segmentSize = std::min(remainSize, chunkEnd);
+                remainSize -= segmentSize;
+                // compressed chunks are not resident, touching them would decompress
+                if (remainSize > 0 && index > 0 && m_pChunks[index - 1]->get_type() != CHUNK_TYPE::COMPRESSED)
                 {
-                    needSize = pChunk->size();
+                    const auto &pPreviousChunk = m_pChunks[index - 1];
+                    size_t      previousSize   = std::min(remainSize, pPreviousChunk->size());
+                    size_t      previousLines  = std::min(m_prefetch_distance, (previousSize + detail::CACHE_LINE_SIZE - 1) / detail::CACHE_LINE_SIZE);
+                    for (size_t line = 0; line < previousLines; ++line)
+                    {
+                        detail::prefetch(pPreviousChunk->get_data() + pPreviousChunk->size() - std::min(pPreviousChunk->size(), (line + 1) * detail::CACHE_LINE_SIZE));
+                    }
                 }
-                pNewChunk = pChunk->create_sub_chunk(offset - currentOffset, needSize);
-                currentChunkSize += needSize;
 
-                // push in chunk and check the size
-                ret.m_pChunks.push_back(std::move(pNewChunk));
-                if (currentChunkSize == size)
+                if (segmentSize > 0)
                 {
-                    break;
+                    auto           pLease   = m_pChunks[index]->lease();
+                    const uint8_t *pSegment = m_pChunks[index]->get_data() + chunkEnd - segmentSize;
+                    if constexpr (std::is_same_v<std::invoke_result_t<Func &, const uint8_t *, const size_t &>, bool>)
+                    {
+                        if (!func(pSegment, segmentSize))
+                        {
+                            return;
+                        }
+                    }
+                    else
+                    {
+                        func(pSegment, segmentSize);
+                    }
                 }
+                if (remainSize == 0)
+                {
+                    return;
+                }
+                --index;
+                chunkEnd = m_pChunks[index]->size();
+            }
+        }
+        /**
+         * @brief Walk all contiguous segments (chunk data) of the editor.
+         * @tparam Func Callable as func(const uint8_t *pData, const size_t &size); may return bool, false stops the walk.
+         * @param func Called for each segment in order.
+         */
+        template <typename Func>
+        void for_each_segment(Func &&func) const
+        {
+            for_each_segment(0, size(), std::forward<Func>(func));
+        }
+        /**
+         * @brief Walk the chunks of the editor.
+         * @tparam Func Callable as func(const std::shared_ptr<binary_chunk_interface> &pChunk).
+         * @param func Called for each chunk in order.
+         */
+        template <typename Func>
+        void for_each_chunk(Func &&func) const
+        {
+            for (const auto &pChunk : m_pChunks)
+            {
+                func(pChunk);
+            }
+        }
+        /**
+         * @brief Get a value that changes whenever the chunks of the editor change.
+         * @return The generation value.
+         */
+        uint64_t generation() const
+        {
+            return m_generation.value();
+        }
+        /**
+         * @brief Set how many cache lines of the next segment for_each_segment() prefetches.
+         * @param lines Number of cache lines, 0 disables prefetching.
+         */
+        void set_prefetch_distance(const size_t &lines)
+        {
+            m_prefetch_distance = lines;
+        }
+        /**
+         * @brief Get how many cache lines of the next segment for_each_segment() prefetches.
+         * @return Number of cache lines.
+         */
+        size_t prefetch_distance() const
+        {
+            return m_prefetch_distance;
+        }
+        /**
+         * @brief Read many values of type T at scattered offsets.
+         *
+         * Requests are sorted by offset and resolved in a single walk over the chunks, while a second cursor walks
+         * READ_PREFETCH_DISTANCE requests ahead and prefetches them, in whichever chunk they lie; the values are
+         * scattered back to out in the original request order.
+         * Values spanning a chunk boundary are assembled from both chunks.
+         *
+         * @tparam T The trivially copyable type to read.
+         * @param offsets Offsets of the values.
+         * @param out Receives the value read at offsets[i] in out[i].
+         * @throws binary_exception if out and offsets differ in size or an offset is out of range.
+         */
+        template <typename T>
+        void read_many(std::span<const size_t> offsets, std::span<T> out) const
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "binary_editor::read_many requires a trivially copyable type");
+            if (offsets.size() != out.size())
+            {
+                throw binary_exception("binary_editor::read_many err : offsets and out must have the same size!");
+            }
+            if (offsets.empty())
+            {
+                return;
             }
 
-            return ret;
+            // sort requests by offset
+            std::vector<size_t> order(offsets.size());
+            std::iota(order.begin(), order.end(), size_t{0});
+            if (!std::is_sorted(offsets.begin(), offsets.end()))
+            {
+                std::sort(order.begin(), order.end(), [&offsets](const size_t &a, const size_t &b)
+                          { return offsets[a] < offsets[b]; });
+            }
+            if (!is_valid_range(offsets[order.back()], sizeof(T)))
+            {
+                throw binary_exception("binary_editor::read_many err : (offset + sizeof(T)) must not be greater than m_Size!");
+            }
+
+            // resolve all requests in one walk, starting from the first one
+            auto [index, chunkBase] = locate(offsets[order.front()]);
+            auto chunkIter          = m_pChunks.begin() + index;
+            auto pLease             = (*chunkIter)->lease();
+            auto aheadIter          = chunkIter;
+            auto aheadBase          = chunkBase;
+            for (size_t i = 0; i < order.size(); ++i)
+            {
+                size_t offset = offsets[order[i]];
+                if (chunkBase + (*chunkIter)->size() <= offset)
+                {
+                    while (chunkBase + (*chunkIter)->size() <= offset)
+                    {
+                        chunkBase += (*chunkIter)->size();
+                        ++chunkIter;
+                    }
+                    pLease = (*chunkIter)->lease();
+                }
+                const uint8_t *pChunkData = (*chunkIter)->get_data();
+                size_t         chunkSize  = (*chunkIter)->size();
+                if (i + READ_PREFETCH_DISTANCE < order.size())
+                {
+                    // a second cursor follows the request ahead, which may lie in a later chunk
+                    size_t aheadOffset = offsets[order[i + READ_PREFETCH_DISTANCE]];
+                    while (aheadBase + (*aheadIter)->size() <= aheadOffset)
+                    {
+                        aheadBase += (*aheadIter)->size();
+                        ++aheadIter;
+                    }
+                    // compressed chunks are not resident, touching them would decompress
+                    if ((*aheadIter)->get_type() != CHUNK_TYPE::COMPRESSED)
+                    {
+                        detail::prefetch((*aheadIter)->get_data() + (aheadOffset - aheadBase));
+                    }
+                }
+
+                auto  *pDest       = reinterpret_cast<uint8_t *>(&out[order[i]]);
+                size_t chunkOffset = offset - chunkBase;
+                if (chunkOffset + sizeof(T) <= chunkSize)
+                {
+                    memcpy(pDest, pChunkData + chunkOffset, sizeof(T));
+                    continue;
+                }
+
+                // the value spans a chunk boundary
+                size_t copiedSize = 0;
+                for (auto iter = chunkIter; copiedSize < sizeof(T); ++iter, chunkOffset = 0)
+                {
+                    size_t needSize   = std::min(sizeof(T) - copiedSize, (*iter)->size() - chunkOffset);
+                    auto   pPartLease = (*iter)->lease();
+                    memcpy(pDest + copiedSize, (*iter)->get_data() + chunkOffset, needSize);
+                    copiedSize += needSize;
+                }
+            }
         }
         /**
          * @brief Append another editor's chunks to the back.
@@ -343,6 +1285,8 @@ namespace binary
         void push_back(const binary_editor &backEditor)
         {
             std::copy(backEditor.m_pChunks.begin(), backEditor.m_pChunks.end(), std::back_inserter(m_pChunks));
+            m_size += backEditor.m_size;
+            m_generation.renew();
         }
         /**
          * @brief Emplace a new chunk at the back.
@@ -361,6 +1305,8 @@ namespace binary
         void push_front(const binary_editor &frontEditor)
         {
             std::copy(frontEditor.m_pChunks.rbegin(), frontEditor.m_pChunks.rend(), std::front_inserter(m_pChunks));
+            m_size += frontEditor.m_size;
+            m_generation.renew();
         }
         /**
          * @brief Emplace a new chunk at the front.
@@ -384,45 +1330,79 @@ namespace binary
             {
                 throw binary_exception("binary_editor::insert err : offset must not be greater than m_Size!");
             }
-
-            size_t currentOffset = 0;
-            for (auto iter = m_pChunks.begin(); iter != m_pChunks.end(); ++iter)
+            insert_unchecked(offset, editor);
+        }
+        /**
+         * @brief Insert another editor's chunks without throwing on an invalid offset.
+         * @param offset The offset to insert at.
+         * @param editor The editor whose chunks to insert.
+         * @return False if offset is invalid, in which case nothing is inserted.
+         */
+        bool try_insert(const size_t &offset, const binary_editor &editor)
+        {
+            if (offset > size())
             {
-                if (currentOffset + (*iter)->size() <= offset)
-                {
-                    currentOffset += (*iter)->size();
-                    continue;
-                }
+                return false;
+            }
+            insert_unchecked(offset, editor);
+            return true;
+        }
+        /**
+         * @brief Insert another editor's chunks at an offset the caller has already validated.
+         * @param offset The offset to insert at, must not be greater than size().
+         * @param editor The editor whose chunks to insert.
+         */
+        void insert_unchecked(const size_t &offset, const binary_editor &editor)
+        {
+            auto [index, currentOffset] = locate(offset);
+            auto iter                   = m_pChunks.begin() + index;
+            if (currentOffset == offset)
+            {
+                // Insert editor's chunks at current position (or append at the end)
+                m_pChunks.insert(iter, editor.m_pChunks.begin(), editor.m_pChunks.end());
+            }
+            else
+            {
+                // Split current chunk into two parts
+                auto pBeginChunk = (*iter)->create_sub_chunk(0, offset - currentOffset);
+                auto pEndChunk = (*iter)->create_sub_chunk(offset - currentOffset, (*iter)->size() - (offset - currentOffset));
 
-                if (currentOffset == offset)
-                {
-                    // Insert editor's chunks at current position
-                    m_pChunks.insert(iter, editor.m_pChunks.begin(), editor.m_pChunks.end());
-                }
-                else
-                {
-                    // Split current chunk into two parts
-                    auto pBeginChunk = (*iter)->create_sub_chunk(0, offset - currentOffset);
-                    auto pEndChunk = (*iter)->create_sub_chunk(offset - currentOffset, (*iter)->size() - (offset - currentOffset));
-
-                    // Replace current chunk and insert editor's chunks
-                    iter = m_pChunks.erase(iter);
-                    iter = ++m_pChunks.insert(iter, pBeginChunk);
-                    iter = ++m_pChunks.insert(iter, editor.m_pChunks.begin(), editor.m_pChunks.end());
-                    iter = ++m_pChunks.insert(iter, pEndChunk);
-                }
-                return; // Exit after insertion
+                // Replace current chunk and insert editor's chunks, back to front at the same position
+                iter = m_pChunks.erase(iter);
+                iter = m_pChunks.insert(iter, pEndChunk);
+                iter = m_pChunks.insert(iter, editor.m_pChunks.begin(), editor.m_pChunks.end());
+                m_pChunks.insert(iter, pBeginChunk);
+                ++index;
             }
+            m_size += editor.m_size;
+            m_generation.renew();
 
-            // If offset is at the end, just append editor's chunks
-            m_pChunks.insert(m_pChunks.end(), editor.m_pChunks.begin(), editor.m_pChunks.end());
+            // keep the finger on the inserted chunks, which start at offset
+            thread_finger() = {m_generation.value(), index, offset};
         }
+        /**
+         * @brief Remap file chunks after binary_file_source::refresh().
+         *
+         * Chunks pointing into modified blocks are replaced with chunks of the new blocks covering the same file
+         * range; chunks of unchanged blocks and chunks from other sources (the user's edits) are kept. If a chunk
+         * ends at the old end of file, it is extended over the appended bytes of its block and chunks for the
+         * remaining appended bytes are inserted right after it, so readers of the editor see them without copying.
+         * The appended bytes are also added at the end of the editor when the file was empty before, or when
+         * get_data() merged the chunk ending at the old end of file and the editor was not changed since.
+         *
+         * @param pSource The refreshed file source.
+         * @param changes The changes returned by refresh().
+         * @return Number of conflicting chunks, whose file range no longer exists; they keep their old data.
+         */
+        size_t apply_file_changes(const std::shared_ptr<binary_file_source> &pSource, const binary_file_changes &changes);
         /**
          * @brief Clear all chunks.
          */
         void clear()
         {
             m_pChunks.clear();
+            m_size = 0;
+            m_generation.renew();
         }
     };
 }
@@ -503,6 +1483,10 @@ namespace reader
          * @brief Reference to the binary_editor instance.
          */
         binary::binary_editor &editor;
+        /**
+         * @brief Keeps the data of the last get() resident while the returned reference is in use.
+         */
+        std::shared_ptr<const void> lease;
 
         /**
          * @brief Calculates the offset for reading the value.
@@ -554,7 +1538,7 @@ namespace reader
          */
         const T &get()
         {
-            const void *data = editor.get_data();
+            const void *data = editor.get_data(lease);
             return *((T *)((const char *)data + GetOffset()));
         }
 
@@ -564,7 +1548,7 @@ namespace reader
          */
         operator const T &()
         {
-            const void *data = editor.get_data();
+            const void *data = editor.get_data(lease);
             return *((T *)((const char *)data + GetOffset()));
         }
 
@@ -612,6 +1596,14 @@ namespace reader
          * @brief Number of elements.
          */
         size_t element_size = 0;      ///< Size of the data to read.
+        /**
+         * @brief Merged data of the sub-editor, shared by copies of the container.
+         */
+        const T *pData = nullptr;
+        /**
+         * @brief Keeps pData resident for as long as the container lives.
+         */
+        std::shared_ptr<const void> lease;
     public:
         /**
          * @brief Random access iterator for STL-style traversal.
@@ -620,9 +1612,9 @@ namespace reader
         {
         private:
             /**
-             * @brief Reference to the sub-editor.
+             * @brief Merged data of the sub-editor.
              */
-            const binary::binary_editor &editor;
+            const T *pData = nullptr;
             /**
              * @brief Current iterator index.
              */
@@ -637,20 +1629,20 @@ namespace reader
 
             /**
              * @brief Construct an iterator.
-             * @param editor_ Reference to the sub-editor.
+             * @param pData_ Merged data of the sub-editor.
              * @param index_ Starting index.
              */
-            iterator(const binary::binary_editor &editor_, size_t index_)
-                : editor(editor_), index(index_)
+            iterator(const T *pData_, size_t index_)
+                : pData(pData_), index(index_)
             {
             }
             /**
              * @brief Dereference to get the current element.
              * @return Const reference to the element of type T.
              */
-            const T &operator*() const
+            const T &operator*() const noexcept
             {
-                return *(((T *)editor.get_data()) + index);
+                return pData[index];
             }
             /**
              * @brief Post-increment (increments by value).
@@ -718,6 +1710,7 @@ namespace reader
         binary_container_reader(binary::binary_editor &editor_, size_t offset, size_t element_size_)
             : editor(editor_.create_sub_editor(offset, sizeof(T) * element_size_)), element_size(element_size_)
         {
+            pData = static_cast<const T *>(editor.get_data(lease));
         }
         /**
          * @brief Get iterator to the beginning.
@@ -725,7 +1718,7 @@ namespace reader
          */
         iterator begin() const
         {
-            return iterator(editor, 0);
+            return iterator(pData, 0);
         }
         /**
          * @brief Get iterator to the end.
@@ -733,7 +1726,7 @@ namespace reader
          */
         iterator end() const
         {
-            return iterator(editor, element_size);
+            return iterator(pData, element_size);
         }
         /**
          * @brief Random access to elements.
@@ -747,7 +1740,7 @@ namespace reader
             {
                 throw reader_exception("binary_container_reader::operator[] err : index out of range!");
             }
-            return *(((T *)editor.get_data()) + index);
+            return pData[index];
         }
         /**
          * @brief Random access with bounds checking.
@@ -761,7 +1754,29 @@ namespace reader
             {
                 throw reader_exception("binary_container_reader::at err : index out of range!");
             }
-            return *(((T *)editor.get_data()) + index);
+            return pData[index];
+        }
+        /**
+         * @brief Random access without throwing on an out-of-range index.
+         * @param index Element index.
+         * @return Value of the element, or std::nullopt if index is out of range.
+         */
+        std::optional<T> try_at(size_t index) const noexcept
+        {
+            if (index >= element_size)
+            {
+                return std::nullopt;
+            }
+            return pData[index];
+        }
+        /**
+         * @brief Random access without bounds checking.
+         * @param index Element index, must be less than size().
+         * @return Value of the element.
+         */
+        T unchecked_at(size_t index) const noexcept
+        {
+            return pData[index];
         }
         /**
          * @brief Get the number of elements.
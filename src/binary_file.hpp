@@ -0,0 +1,687 @@
+#pragma once
+#include "binary_editor.hpp"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace binary
+{
+    namespace detail
+    {
+        /**
+         * @brief Hash a byte range, eight bytes per step.
+         * @param pData The data pointer.
+         * @param size The size of the data.
+         * @return 64-bit hash of the data.
+         */
+        inline uint64_t hash_bytes(const uint8_t *pData, const size_t &size)
+        {
+            uint64_t hash = 0x9E3779B97F4A7C15ull ^ size;
+            size_t   i    = 0;
+            for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+            {
+                uint64_t word;
+                memcpy(&word, pData + i, sizeof(uint64_t));
+                hash = (hash ^ word) * 0xBF58476D1CE4E5B9ull;
+                hash ^= hash >> 31;
+            }
+            uint64_t tail = 0;
+            memcpy(&tail, pData + i, size - i);
+            hash = (hash ^ tail) * 0x94D049BB133111EBull;
+            hash ^= hash >> 29;
+            return hash;
+        }
+    }
+
+    /**
+     * @brief Changes detected by binary_file_source::refresh() or follow().
+     */
+    struct binary_file_changes
+    {
+        size_t                                 old_size = 0; ///< File size before the refresh
+        size_t                                 new_size = 0; ///< File size after the refresh
+        std::vector<std::pair<size_t, size_t>> modified;     ///< (offset, size) of modified regions within old_size
+
+        /**
+         * @brief Check whether the file is unchanged.
+         * @return True if nothing was modified, appended or truncated.
+         */
+        bool empty() const
+        {
+            return modified.empty() && old_size == new_size;
+        }
+    };
+
+    /**
+     * @brief A block of file contents loaded by binary_file_source.
+     */
+    struct binary_file_block
+    {
+        std::unique_ptr<uint8_t[]> data;            ///< Block contents
+        size_t                     file_offset = 0; ///< Offset of the block in the file
+        size_t                     size        = 0; ///< Size of the block in bytes
+        size_t                     capacity    = 0; ///< Allocated size of data, bytes past size may be filled in place
+        uint64_t                   hash        = 0; ///< Hash of the block contents
+    };
+
+    /**
+     * @brief Loads a file as fixed-size blocks and detects external changes to it.
+     *
+     * Blocks whose size and hash are unchanged across refresh() are kept as-is, so editors only need to remap
+     * the chunks that point into modified or appended blocks. For files that only grow (logs, captures),
+     * follow() reads just the new bytes, filling the last block in place before starting new ones.
+     *
+     * @code
+     * auto pSource = std::make_shared<binary::binary_file_source>("capture.bin");
+     * binary::binary_editor editor(pSource);
+     * // ... the file is modified by another tool ...
+     * auto changes = pSource->refresh();
+     * editor.apply_file_changes(pSource, changes);
+     * @endcode
+     */
+    class binary_file_source
+    {
+    public:
+        /**
+         * @brief Default block size in bytes.
+         */
+        static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+        /**
+         * @brief Changes detected by refresh().
+         */
+        using change_set = binary_file_changes;
+
+    private:
+        std::string                                     m_path;       ///< Path of the file
+        size_t                                          m_block_size; ///< Block size in bytes
+        size_t                                          m_size = 0;   ///< Current file size
+        std::vector<std::shared_ptr<binary_file_block>> m_pBlocks;    ///< Current blocks
+
+        /**
+         * @brief Create a block holding the data read into pBuffer.
+         * @param pBuffer Buffer of m_block_size bytes, moved into the block.
+         * @param offset The file offset of the block.
+         * @param size The number of valid bytes.
+         * @param hash Hash of the valid bytes.
+         * @return Shared pointer to the block.
+         */
+        std::shared_ptr<binary_file_block> make_block(std::unique_ptr<uint8_t[]> &&pBuffer, const size_t &offset, const size_t &size,
+                                                      const uint64_t &hash) const
+        {
+            auto pBlock         = std::make_shared<binary_file_block>();
+            pBlock->data        = std::move(pBuffer);
+            pBlock->file_offset = offset;
+            pBlock->size        = size;
+            pBlock->capacity    = m_block_size;
+            pBlock->hash        = hash;
+            return pBlock;
+        }
+
+    public:
+        /**
+         * @brief Construct a file source and load the file.
+         * @param path Path of the file.
+         * @param blockSize Block size in bytes.
+         * @throws binary_exception if blockSize is 0 or the file cannot be opened.
+         */
+        binary_file_source(const std::string &path, const size_t &blockSize = DEFAULT_BLOCK_SIZE)
+            : m_path(path), m_block_size(blockSize)
+        {
+            if (blockSize == 0)
+            {
+                throw binary_exception("binary_file_source::binary_file_source err : blockSize must not be 0!");
+            }
+            refresh();
+        }
+        /**
+         * @brief Re-read the file and replace the blocks whose size or hash changed.
+         * @return The detected changes.
+         * @throws binary_exception if the file cannot be opened.
+         */
+        change_set refresh()
+        {
+            std::ifstream file(m_path, std::ios::binary);
+            if (!file)
+            {
+                throw binary_exception("binary_file_source::refresh err : unable to open file!");
+            }
+
+            change_set ret;
+            ret.old_size = m_size;
+            std::vector<std::shared_ptr<binary_file_block>> pBlocks;
+            auto   pBuffer = std::make_unique<uint8_t[]>(m_block_size);
+            size_t offset  = 0;
+            while (file)
+            {
+                file.read(reinterpret_cast<char *>(pBuffer.get()), m_block_size);
+                size_t readSize = static_cast<size_t>(file.gcount());
+                if (readSize == 0)
+                {
+                    break;
+                }
+
+                // keep the old block when it is unchanged
+                uint64_t hash  = detail::hash_bytes(pBuffer.get(), readSize);
+                size_t   index = pBlocks.size();
+                if (index < m_pBlocks.size() && m_pBlocks[index]->size == readSize && m_pBlocks[index]->hash == hash)
+                {
+                    pBlocks.push_back(m_pBlocks[index]);
+                }
+                else
+                {
+                    pBlocks.push_back(make_block(std::move(pBuffer), offset, readSize, hash));
+                    pBuffer = std::make_unique<uint8_t[]>(m_block_size);
+                    if (offset < m_size)
+                    {
+                        ret.modified.emplace_back(offset, std::min(readSize, m_size - offset));
+                    }
+                }
+                offset += readSize;
+            }
+
+            ret.new_size = offset;
+            m_size       = offset;
+            m_pBlocks    = std::move(pBlocks);
+            return ret;
+        }
+        /**
+         * @brief Read only the bytes appended since the last refresh or follow.
+         *
+         * The spare capacity of the last block is filled in place, so chunks already pointing at it stay valid
+         * and can simply be extended; the remaining bytes go to new blocks. If the file shrank it is no longer
+         * append-only and a full refresh() is done instead.
+         *
+         * @return The detected changes.
+         * @throws binary_exception if the file cannot be opened.
+         */
+        change_set follow()
+        {
+            std::error_code ec;
+            size_t          fileSize = static_cast<size_t>(std::filesystem::file_size(m_path, ec));
+            if (ec)
+            {
+                throw binary_exception("binary_file_source::follow err : unable to open file!");
+            }
+            if (fileSize < m_size)
+            {
+                return refresh();
+            }
+
+            change_set ret;
+            ret.old_size = m_size;
+            if (fileSize == m_size)
+            {
+                ret.new_size = m_size;
+                return ret;
+            }
+            std::ifstream file(m_path, std::ios::binary);
+            if (!file)
+            {
+                throw binary_exception("binary_file_source::follow err : unable to open file!");
+            }
+            file.seekg(static_cast<std::streamoff>(m_size));
+
+            // fill the last block in place
+            if (!m_pBlocks.empty() && m_pBlocks.back()->size < m_pBlocks.back()->capacity)
+            {
+                auto &pBlock = m_pBlocks.back();
+                file.read(reinterpret_cast<char *>(pBlock->data.get() + pBlock->size), pBlock->capacity - pBlock->size);
+                size_t readSize = static_cast<size_t>(file.gcount());
+                pBlock->size += readSize;
+                pBlock->hash = detail::hash_bytes(pBlock->data.get(), pBlock->size);
+                m_size += readSize;
+            }
+
+            // then start new blocks
+            while (file)
+            {
+                auto pBuffer = std::make_unique<uint8_t[]>(m_block_size);
+                file.read(reinterpret_cast<char *>(pBuffer.get()), m_block_size);
+                size_t readSize = static_cast<size_t>(file.gcount());
+                if (readSize == 0)
+                {
+                    break;
+                }
+                uint64_t hash = detail::hash_bytes(pBuffer.get(), readSize);
+                m_pBlocks.push_back(make_block(std::move(pBuffer), m_size, readSize, hash));
+                m_size += readSize;
+            }
+
+            ret.new_size = m_size;
+            return ret;
+        }
+        /**
+         * @brief Get the path of the file.
+         * @return The path.
+         */
+        const std::string &path() const
+        {
+            return m_path;
+        }
+        /**
+         * @brief Get the file size as of the last refresh.
+         * @return The size in bytes.
+         */
+        size_t size() const
+        {
+            return m_size;
+        }
+        /**
+         * @brief Get the block size.
+         * @return The block size in bytes.
+         */
+        size_t block_size() const
+        {
+            return m_block_size;
+        }
+        /**
+         * @brief Get the number of blocks.
+         * @return The number of blocks.
+         */
+        size_t block_count() const
+        {
+            return m_pBlocks.size();
+        }
+        /**
+         * @brief Get a block by index.
+         * @param index The block index.
+         * @return Shared pointer to the block, or nullptr if index is out of range.
+         */
+        std::shared_ptr<const binary_file_block> get_block(const size_t &index) const
+        {
+            return index < m_pBlocks.size() ? m_pBlocks[index] : nullptr;
+        }
+    };
+
+    /**
+     * @brief Implementation of a chunk that points into a block of a binary_file_source.
+     */
+    class binary_chunk_file : public binary_chunk_interface
+    {
+    private:
+        std::shared_ptr<const binary_file_source> m_pSource = nullptr; ///< Source the block belongs to
+        std::shared_ptr<const binary_file_block>  m_pBlock  = nullptr; ///< Block holding the data
+        size_t                                    m_size    = 0;
+        size_t                                    m_offset  = 0;
+
+    public:
+        /**
+         * @brief Construct a file chunk.
+         * @param pSource The source the block belongs to.
+         * @param pBlock The block holding the data.
+         * @param offset The offset in the block.
+         * @param size The size of the chunk.
+         * @throws binary_exception if the range exceeds the block or a pointer is nullptr.
+         */
+        binary_chunk_file(std::shared_ptr<const binary_file_source> pSource, std::shared_ptr<const binary_file_block> pBlock,
+                          const size_t &offset, const size_t &size)
+            : m_pSource(std::move(pSource)), m_pBlock(std::move(pBlock)), m_size(size), m_offset(offset)
+        {
+            if (m_pSource == nullptr || m_pBlock == nullptr)
+            {
+                throw binary_exception("binary_chunk_file::binary_chunk_file err : pSource and pBlock must not be nullptr!");
+            }
+            if (offset + size > m_pBlock->size)
+            {
+                throw binary_exception("binary_chunk_file::binary_chunk_file err : (offset + size) must not be greater than block size!");
+            }
+        }
+        /**
+         * @copydoc binary_chunk_interface::create_sub_chunk
+         */
+        virtual std::shared_ptr<binary_chunk_interface> create_sub_chunk(const size_t &offset, const size_t &size) const override final
+        {
+            if (offset + size > m_size)
+            {
+                throw binary_exception("binary_chunk_file::create_sub_chunk err : (offset + size) must not be greater than m_Size!");
+            }
+            auto pRet = std::make_shared<binary_chunk_file>(*this);
+            pRet->m_offset += offset;
+            pRet->m_size = size;
+            return std::dynamic_pointer_cast<binary_chunk_interface>(pRet);
+        }
+        /**
+         * @copydoc binary_chunk_interface::size
+         */
+        virtual size_t size() const override final
+        {
+            return m_size;
+        }
+        /**
+         * @copydoc binary_chunk_interface::get_data
+         */
+        virtual const uint8_t *get_data() const override final
+        {
+            return m_pBlock->data.get() + m_offset;
+        }
+        /**
+         * @copydoc binary_chunk_interface::get_type
+         */
+        virtual CHUNK_TYPE get_type() const override final
+        {
+            return CHUNK_TYPE::FILE;
+        }
+        /**
+         * @copydoc binary_chunk_interface::clone
+         */
+        virtual std::unique_ptr<binary_chunk_interface> clone() const override
+        {
+            return std::make_unique<binary_chunk_file>(*this);
+        }
+        /**
+         * @copydoc binary_chunk_interface::downscale_size
+         */
+        virtual void downscale_size(const size_t &targeSize) override final
+        {
+            m_size = targeSize;
+        }
+        /**
+         * @brief Get the source the chunk belongs to.
+         * @return Shared pointer to the source.
+         */
+        const std::shared_ptr<const binary_file_source> &get_source() const
+        {
+            return m_pSource;
+        }
+        /**
+         * @brief Get the block holding the data.
+         * @return Shared pointer to the block.
+         */
+        const std::shared_ptr<const binary_file_block> &get_block() const
+        {
+            return m_pBlock;
+        }
+        /**
+         * @brief Get the offset of the chunk in the file.
+         * @return The file offset.
+         */
+        size_t file_offset() const
+        {
+            return m_pBlock->file_offset + m_offset;
+        }
+        /**
+         * @copydoc binary_chunk_interface::file_end
+         */
+        virtual std::pair<std::shared_ptr<const binary_file_source>, size_t> file_end() const override final
+        {
+            return {m_pSource, file_offset() + m_size};
+        }
+    };
+
+    inline void binary_editor::insert_file_range(std::deque<std::shared_ptr<binary_chunk_interface>>::iterator iter,
+                                                 const std::shared_ptr<binary_file_source> &pSource, size_t offset, size_t size)
+    {
+        while (size > 0)
+        {
+            auto   pBlock      = pSource->get_block(offset / pSource->block_size());
+            size_t blockOffset = offset - pBlock->file_offset;
+            size_t needSize    = std::min(size, pBlock->size - blockOffset);
+            iter = ++m_pChunks.insert(iter, std::make_shared<binary_chunk_file>(pSource, pBlock, blockOffset, needSize));
+            offset += needSize;
+            size -= needSize;
+            m_size += needSize;
+        }
+        m_generation.renew();
+    }
+
+    inline binary_editor::binary_editor(const std::shared_ptr<binary_file_source> &pSource)
+    {
+        if (pSource == nullptr)
+        {
+            throw binary_exception("binary_editor::binary_editor err : pSource must not be nullptr!");
+        }
+        insert_file_range(m_pChunks.end(), pSource, 0, pSource->size());
+    }
+
+    inline size_t binary_editor::apply_file_changes(const std::shared_ptr<binary_file_source> &pSource, const binary_file_changes &changes)
+    {
+        size_t conflicts = 0;
+        auto   tailIter  = m_pChunks.end();
+        for (auto iter = m_pChunks.begin(); iter != m_pChunks.end(); ++iter)
+        {
+            if ((*iter)->get_type() != CHUNK_TYPE::FILE)
+            {
+                continue;
+            }
+            auto pFileChunk = std::static_pointer_cast<binary_chunk_file>(*iter);
+            if (pFileChunk->get_source() != pSource)
+            {
+                continue;
+            }
+
+            // remap the chunk when its block was replaced
+            size_t fileOffset = pFileChunk->file_offset();
+            size_t chunkSize  = pFileChunk->size();
+            auto   pBlock     = pSource->get_block(pFileChunk->get_block()->file_offset / pSource->block_size());
+            if (pBlock != pFileChunk->get_block())
+            {
+                if (pBlock == nullptr || fileOffset + chunkSize > pBlock->file_offset + pBlock->size)
+                {
+                    ++conflicts;
+                    continue;
+                }
+                *iter = std::make_shared<binary_chunk_file>(pSource, pBlock, fileOffset - pBlock->file_offset, chunkSize);
+                m_generation.renew();
+            }
+            if (fileOffset + chunkSize == changes.old_size)
+            {
+                tailIter = iter;
+            }
+        }
+
+        if (tailIter != m_pChunks.end() && changes.new_size > changes.old_size)
+        {
+            // extend the tail chunk within its block, then append the rest
+            auto   pTailChunk = std::static_pointer_cast<binary_chunk_file>(*tailIter);
+            auto   pBlock     = pTailChunk->get_block();
+            size_t growSize   = std::min(changes.new_size, pBlock->file_offset + pBlock->size) - changes.old_size;
+            if (growSize > 0)
+            {
+                *tailIter = std::make_shared<binary_chunk_file>(pSource, pBlock, pTailChunk->file_offset() - pBlock->file_offset,
+                                                                pTailChunk->size() + growSize);
+                m_size += growSize;
+                m_generation.renew();
+            }
+            insert_file_range(++tailIter, pSource, changes.old_size + growSize, changes.new_size - changes.old_size - growSize);
+        }
+        else if (changes.new_size > changes.old_size &&
+                 (changes.old_size == 0 || (m_merged_tail.generation == m_generation.value() && m_merged_tail.file_end == changes.old_size &&
+                                            m_merged_tail.pSource.lock() == pSource)))
+        {
+            // no chunk holds the old end of file, it was empty or merged into a memory chunk at the end
+            insert_file_range(m_pChunks.end(), pSource, changes.old_size, changes.new_size - changes.old_size);
+        }
+        return conflicts;
+    }
+
+    /**
+     * @brief Watches a file for modifications made by other tools.
+     *
+     * Uses inotify on Linux; elsewhere falls back to comparing the size and last write time.
+     * A detected change is meant to trigger binary_file_source::refresh().
+     */
+    class binary_file_watcher
+    {
+    private:
+        std::string m_path; ///< Path of the watched file
+#if defined(__linux__)
+        int m_fd = -1; ///< inotify instance
+        int m_wd = -1; ///< Watch on m_path, -1 while the file is missing
+        /**
+         * @brief Events that count as a change.
+         */
+        static constexpr uint32_t WATCH_MASK = IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF;
+#else
+        std::filesystem::file_time_type m_last_write_time; ///< Last seen write time
+        std::uintmax_t                  m_last_size = 0;   ///< Last seen size
+#endif
+
+    public:
+        /**
+         * @brief Start watching a file.
+         * @param path Path of the file.
+         * @throws binary_exception if the watch cannot be created.
+         */
+        explicit binary_file_watcher(const std::string &path)
+            : m_path(path)
+        {
+#if defined(__linux__)
+            m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (m_fd < 0 || (m_wd = inotify_add_watch(m_fd, m_path.c_str(), WATCH_MASK)) < 0)
+            {
+                if (m_fd >= 0)
+                {
+                    close(m_fd);
+                }
+                throw binary_exception("binary_file_watcher::binary_file_watcher err : unable to watch file!");
+            }
+#else
+            std::error_code ec;
+            m_last_write_time = std::filesystem::last_write_time(m_path, ec);
+            m_last_size       = std::filesystem::file_size(m_path, ec);
+            if (ec)
+            {
+                throw binary_exception("binary_file_watcher::binary_file_watcher err : unable to watch file!");
+            }
+#endif
+        }
+        /**
+         * @brief Stop watching.
+         */
+        ~binary_file_watcher()
+        {
+#if defined(__linux__)
+            close(m_fd);
+#endif
+        }
+        /**
+         * @brief Check without blocking whether the file changed since the last check.
+         * @return True if the file changed.
+         */
+        bool poll()
+        {
+#if defined(__linux__)
+            bool    changed = false;
+            bool    rewatch = false;
+            alignas(inotify_event) char buffer[4096];
+            ssize_t length;
+            while ((length = read(m_fd, buffer, sizeof(buffer))) > 0)
+            {
+                for (char *pCurrent = buffer; pCurrent < buffer + length;)
+                {
+                    // events of watches removed below, such as their IN_IGNORED, are stale
+                    auto *pEvent = reinterpret_cast<inotify_event *>(pCurrent);
+                    if (pEvent->wd == m_wd)
+                    {
+                        changed |= (pEvent->mask & WATCH_MASK) != 0;
+                        rewatch |= (pEvent->mask & (IN_MOVE_SELF | IN_DELETE_SELF | IN_IGNORED)) != 0;
+                    }
+                    pCurrent += sizeof(inotify_event) + pEvent->len;
+                }
+            }
+            // the file was replaced (e.g. saved through a rename), drop the watch that still follows the old
+            // inode and watch the new one; retry later if the path does not exist yet
+            if (rewatch || m_wd < 0)
+            {
+                bool missing = m_wd < 0;
+                if (!missing)
+                {
+                    inotify_rm_watch(m_fd, m_wd);
+                }
+                m_wd = inotify_add_watch(m_fd, m_path.c_str(), WATCH_MASK);
+                // a file that appears again after it was missing has changed, its events were never seen
+                changed |= missing && m_wd >= 0;
+            }
+            return changed;
+#else
+            std::error_code ec;
+            auto            writeTime = std::filesystem::last_write_time(m_path, ec);
+            auto            size      = std::filesystem::file_size(m_path, ec);
+            if (ec || (writeTime == m_last_write_time && size == m_last_size))
+            {
+                return false;
+            }
+            m_last_write_time = writeTime;
+            m_last_size       = size;
+            return true;
+#endif
+        }
+        /**
+         * @brief Block until the file changes or the timeout expires.
+         *
+         * While the file is missing there is nothing to wait on, so poll() is retried every few milliseconds until
+         * the file appears again.
+         *
+         * @param timeout Maximum time to wait.
+         * @return True if the file changed.
+         */
+        bool wait(const std::chrono::milliseconds &timeout)
+        {
+#if defined(__linux__)
+            auto deadline = std::chrono::steady_clock::now() + timeout;
+            while (true)
+            {
+                auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+                if (m_wd < 0)
+                {
+                    if (poll())
+                    {
+                        return true;
+                    }
+                    if (remaining.count() <= 0)
+                    {
+                        return false;
+                    }
+                    std::this_thread::sleep_for(std::min(remaining, std::chrono::milliseconds(10)));
+                    continue;
+                }
+
+                pollfd pfd{m_fd, POLLIN, 0};
+                if (::poll(&pfd, 1, static_cast<int>(std::max<int64_t>(remaining.count(), 0))) <= 0)
+                {
+                    return false;
+                }
+                if (poll())
+                {
+                    return true;
+                }
+            }
+#else
+            auto deadline = std::chrono::steady_clock::now() + timeout;
+            while (!poll())
+            {
+                if (std::chrono::steady_clock::now() >= deadline)
+                {
+                    return false;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            return true;
+#endif
+        }
+        /**
+         * @brief Get the path of the watched file.
+         * @return The path.
+         */
+        const std::string &path() const
+        {
+            return m_path;
+        }
+
+        /**
+         * @brief Deleted copy constructor.
+         */
+        binary_file_watcher(const binary_file_watcher &) = delete;
+        /**
+         * @brief Deleted copy assignment operator.
+         */
+        binary_file_watcher &operator=(const binary_file_watcher &) = delete;
+    };
+}
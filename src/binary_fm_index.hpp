@@ -0,0 +1,1017 @@
+#pragma once
+#include "binary_editor.hpp"
+#include "binary_worker_pool.hpp"
+#include <bit>
+#include <istream>
+#include <ostream>
+#include <queue>
+
+namespace binary
+{
+    namespace detail
+    {
+        /**
+         * @brief Marks an unset suffix array slot during SA-IS.
+         */
+        constexpr size_t SAIS_EMPTY = SIZE_MAX;
+
+        /**
+         * @brief Top level SA-IS text: the bytes shifted up by one, followed by a 0 sentinel.
+         */
+        struct sais_byte_text
+        {
+            const uint8_t *pData;
+            size_t         size;
+
+            size_t operator()(const size_t &i) const
+            {
+                return i == size ? 0 : pData[i] + size_t{1};
+            }
+        };
+
+        /**
+         * @brief Reduced SA-IS text: the names of the LMS substrings, in text order.
+         */
+        struct sais_name_text
+        {
+            const size_t *pData;
+
+            size_t operator()(const size_t &i) const
+            {
+                return pData[i];
+            }
+        };
+
+        /**
+         * @brief Build a suffix array by induced sorting (SA-IS), in linear time.
+         * @tparam Text Callable as text(i) returning the symbol at i.
+         * @param text The text; its last symbol must be 0 and occur nowhere else.
+         * @param size The length of the text including the sentinel, at least 1.
+         * @param alphabet One more than the largest symbol.
+         * @param pSA Receives the suffix array, size entries.
+         */
+        template <typename Text>
+        void sais(const Text &text, const size_t &size, const size_t &alphabet, size_t *pSA)
+        {
+            if (size == 1)
+            {
+                pSA[0] = 0;
+                return;
+            }
+            // S-type suffixes are smaller than the suffix following them.
+            std::vector<bool> stype(size);
+            stype[size - 1] = true;
+            for (size_t i = size - 1; i-- > 0;)
+            {
+                stype[i] = text(i) < text(i + 1) || (text(i) == text(i + 1) && stype[i + 1]);
+            }
+            auto isLms = [&stype](const size_t &i) { return i > 0 && stype[i] && !stype[i - 1]; };
+
+            std::vector<size_t> counts(alphabet);
+            std::vector<size_t> bucket(alphabet);
+            for (size_t i = 0; i < size; ++i)
+            {
+                ++counts[text(i)];
+            }
+            auto bucketStarts = [&]()
+            {
+                for (size_t c = 0, sum = 0; c < alphabet; sum += counts[c], ++c)
+                {
+                    bucket[c] = sum;
+                }
+            };
+            auto bucketEnds = [&]()
+            {
+                for (size_t c = 0, sum = 0; c < alphabet; ++c)
+                {
+                    sum += counts[c];
+                    bucket[c] = sum;
+                }
+            };
+            auto induce = [&]()
+            {
+                bucketStarts();
+                for (size_t i = 0; i < size; ++i)
+                {
+                    size_t j = pSA[i];
+                    if (j != SAIS_EMPTY && j > 0 && !stype[j - 1])
+                    {
+                        pSA[bucket[text(j - 1)]++] = j - 1;
+                    }
+                }
+                bucketEnds();
+                for (size_t i = size; i-- > 0;)
+                {
+                    size_t j = pSA[i];
+                    if (j != SAIS_EMPTY && j > 0 && stype[j - 1])
+                    {
+                        pSA[--bucket[text(j - 1)]] = j - 1;
+                    }
+                }
+            };
+
+            // Sort the LMS substrings by inducing from LMS positions at their bucket ends.
+            std::fill(pSA, pSA + size, SAIS_EMPTY);
+            bucketEnds();
+            for (size_t i = 1; i < size; ++i)
+            {
+                if (isLms(i))
+                {
+                    pSA[--bucket[text(i)]] = i;
+                }
+            }
+            induce();
+
+            // Name the sorted LMS substrings; equal substrings share a name.
+            size_t lmsCount = 0;
+            for (size_t i = 0; i < size; ++i)
+            {
+                if (isLms(pSA[i]))
+                {
+                    pSA[lmsCount++] = pSA[i];
+                }
+            }
+            std::fill(pSA + lmsCount, pSA + size, SAIS_EMPTY);
+            size_t name     = 0;
+            size_t previous = SAIS_EMPTY;
+            for (size_t i = 0; i < lmsCount; ++i)
+            {
+                size_t position = pSA[i];
+                bool   differ   = false;
+                for (size_t d = 0;; ++d)
+                {
+                    if (previous == SAIS_EMPTY || text(position + d) != text(previous + d) || stype[position + d] != stype[previous + d])
+                    {
+                        differ = true;
+                        break;
+                    }
+                    if (d > 0 && (isLms(position + d) || isLms(previous + d)))
+                    {
+                        break;
+                    }
+                }
+                if (differ)
+                {
+                    ++name;
+                    previous = position;
+                }
+                // LMS positions are at least two apart, so position / 2 is a unique slot.
+                pSA[lmsCount + position / 2] = name - 1;
+            }
+            for (size_t i = size, j = size; i-- > lmsCount;)
+            {
+                if (pSA[i] != SAIS_EMPTY)
+                {
+                    pSA[--j] = pSA[i];
+                }
+            }
+
+            // Sort the LMS suffixes, recursing while names repeat.
+            size_t *pReduced = pSA + size - lmsCount;
+            if (name < lmsCount)
+            {
+                sais(sais_name_text{pReduced}, lmsCount, name, pSA);
+            }
+            else
+            {
+                for (size_t i = 0; i < lmsCount; ++i)
+                {
+                    pSA[pReduced[i]] = i;
+                }
+            }
+
+            // Induce the full suffix array from the sorted LMS suffixes.
+            for (size_t i = 1, j = 0; i < size; ++i)
+            {
+                if (isLms(i))
+                {
+                    pReduced[j++] = i;
+                }
+            }
+            for (size_t i = 0; i < lmsCount; ++i)
+            {
+                pSA[i] = pReduced[pSA[i]];
+            }
+            std::fill(pSA + lmsCount, pSA + size, SAIS_EMPTY);
+            bucketEnds();
+            for (size_t i = lmsCount; i-- > 0;)
+            {
+                size_t j               = pSA[i];
+                pSA[i]                 = SAIS_EMPTY;
+                pSA[--bucket[text(j)]] = j;
+            }
+            induce();
+        }
+
+        /**
+         * @brief Replace a suffix array with Φ: for each text position, the position of the suffix sorted right before it.
+         *
+         * Below 2^32 rows the buffer is used as twice as many 32-bit halves: the suffix array is narrowed into the
+         * first half, Φ is scattered into the second half and then widened back in place. Larger texts build Φ in a
+         * second array.
+         *
+         * @param suffixes The suffix array, including the sentinel row; receives Φ. A value not below
+         *                 suffixes.size() - 1 means the suffix has no predecessor.
+         */
+        inline void suffix_predecessors(std::vector<size_t> &suffixes)
+        {
+            size_t rows = suffixes.size();
+            if (sizeof(size_t) == 2 * sizeof(uint32_t) && rows < UINT32_MAX)
+            {
+                constexpr uint32_t NONE   = UINT32_MAX;
+                auto              *pHalf  = reinterpret_cast<unsigned char *>(suffixes.data());
+                auto               load   = [pHalf](const size_t &i)
+                {
+                    uint32_t value;
+                    memcpy(&value, pHalf + i * sizeof(uint32_t), sizeof(uint32_t));
+                    return value;
+                };
+                auto store = [pHalf](const size_t &i, const uint32_t &value) { memcpy(pHalf + i * sizeof(uint32_t), &value, sizeof(uint32_t)); };
+
+                // half i lies in slot i / 2, which was already read
+                for (size_t row = 0; row < rows; ++row)
+                {
+                    store(row, static_cast<uint32_t>(suffixes[row]));
+                }
+                for (size_t row = 0; row < rows; ++row)
+                {
+                    store(rows + load(row), row == 0 ? NONE : load(row - 1));
+                }
+                // slot i covers halves 2i and 2i + 1, which hold no Φ entry still to be widened
+                for (size_t i = 0; i < rows; ++i)
+                {
+                    uint32_t value = load(rows + i);
+                    suffixes[i]    = value == NONE ? SAIS_EMPTY : value;
+                }
+                return;
+            }
+            std::vector<size_t> previous(rows, SAIS_EMPTY);
+            for (size_t row = 1; row < rows; ++row)
+            {
+                previous[suffixes[row]] = suffixes[row - 1];
+            }
+            suffixes = std::move(previous);
+        }
+
+        /**
+         * @brief Bit vector with constant time rank: a 64-bit count of the set bits before every 512 bits.
+         */
+        class rank_bit_vector
+        {
+        private:
+            static constexpr size_t WORDS_PER_BLOCK = 8;
+
+            std::vector<uint64_t> m_words; ///< The bits, bit i in word i / 64
+            std::vector<uint64_t> m_ranks; ///< Set bits before each block of WORDS_PER_BLOCK words
+
+        public:
+            rank_bit_vector() = default;
+            /**
+             * @brief Take the bits and count them.
+             * @param words The bits, bit i in word i / 64.
+             */
+            explicit rank_bit_vector(std::vector<uint64_t> &&words)
+                : m_words(std::move(words)), m_ranks(m_words.size() / WORDS_PER_BLOCK + 1)
+            {
+                for (size_t block = 0, sum = 0; block < m_ranks.size(); ++block)
+                {
+                    m_ranks[block] = sum;
+                    for (size_t i = block * WORDS_PER_BLOCK; i < std::min(m_words.size(), (block + 1) * WORDS_PER_BLOCK); ++i)
+                    {
+                        sum += std::popcount(m_words[i]);
+                    }
+                }
+            }
+            /**
+             * @brief Get a bit.
+             * @param i The bit index.
+             * @return The bit.
+             */
+            bool get(const size_t &i) const
+            {
+                return (m_words[i / 64] >> (i % 64)) & 1;
+            }
+            /**
+             * @brief Count the set bits before a bit.
+             * @param i The bit index, at most the number of bits.
+             * @return The count.
+             */
+            size_t rank(const size_t &i) const
+            {
+                size_t word = i / 64;
+                size_t ret  = m_ranks[word / WORDS_PER_BLOCK];
+                for (size_t j = word - word % WORDS_PER_BLOCK; j < word; ++j)
+                {
+                    ret += std::popcount(m_words[j]);
+                }
+                if (i % 64 != 0)
+                {
+                    ret += std::popcount(m_words[word] & ((uint64_t{1} << (i % 64)) - 1));
+                }
+                return ret;
+            }
+            /**
+             * @brief Get the bits.
+             * @return The bits, bit i in word i / 64.
+             */
+            const std::vector<uint64_t> &words() const
+            {
+                return m_words;
+            }
+            /**
+             * @brief Get the memory held by the bits and counts.
+             * @return The size in bytes.
+             */
+            size_t memory_size() const
+            {
+                return (m_words.size() + m_ranks.size()) * sizeof(uint64_t);
+            }
+        };
+
+        /**
+         * @brief Huffman-shaped wavelet tree over a byte sequence, answering rank and access in O(code length).
+         *
+         * Each internal node keeps one bit per byte of its subtree, telling on which side the byte's Huffman code
+         * continues; the bits of all nodes are concatenated in one rank_bit_vector. The tree takes at most
+         * H0 + 1 bits per byte plus an eighth for the counts, H0 being the entropy of the byte distribution.
+         */
+        class huffman_wavelet_tree
+        {
+        private:
+            static constexpr size_t MAX_CODE_LENGTH = 64;
+
+            /**
+             * @brief An internal node.
+             */
+            struct node
+            {
+                size_t  offset      = 0;  ///< First bit of the node in m_bits
+                size_t  ones        = 0;  ///< Set bits of m_bits before offset
+                int32_t children[2] = {}; ///< Child node index, or -1 - byte for a leaf
+            };
+
+            std::vector<node>         m_nodes;     ///< Internal nodes, the root first
+            std::array<uint64_t, 256> m_codes{};   ///< Code of each byte, the branch from the root in bit 0
+            std::array<uint8_t, 256>  m_lengths{}; ///< Code length of each byte, 0 if it does not occur
+            rank_bit_vector           m_bits;      ///< Bits of all nodes
+
+            /**
+             * @brief Build the Huffman tree and the codes, flattening the weights until no code is longer than MAX_CODE_LENGTH.
+             * @param counts Occurrences of each byte.
+             */
+            void build_tree(const std::array<uint64_t, 256> &counts)
+            {
+                // a node needs two children, absent bytes fill in as empty leaves
+                std::vector<size_t> symbols;
+                for (size_t c = 0; c < 256; ++c)
+                {
+                    if (counts[c] > 0 || symbols.size() + (256 - c) <= 2)
+                    {
+                        symbols.push_back(c);
+                    }
+                }
+                std::array<uint64_t, 256> weights{};
+                for (const auto &c : symbols)
+                {
+                    weights[c] = std::max<uint64_t>(counts[c], 1);
+                }
+
+                using item = std::pair<uint64_t, int32_t>;
+                for (bool fits = false; !fits;)
+                {
+                    std::priority_queue<item, std::vector<item>, std::greater<item>> heap;
+                    for (const auto &c : symbols)
+                    {
+                        heap.emplace(weights[c], -1 - static_cast<int32_t>(c));
+                    }
+                    // merged bottom-up, then reversed so that the root comes first and parents precede children
+                    std::vector<node> nodes;
+                    while (heap.size() > 1)
+                    {
+                        auto [firstWeight, first]   = heap.top();
+                        heap.pop();
+                        auto [secondWeight, second] = heap.top();
+                        heap.pop();
+                        nodes.push_back(node{0, 0, {first, second}});
+                        heap.emplace(firstWeight + secondWeight, static_cast<int32_t>(nodes.size() - 1));
+                    }
+                    m_nodes.assign(nodes.rbegin(), nodes.rend());
+                    for (auto &current : m_nodes)
+                    {
+                        for (auto &child : current.children)
+                        {
+                            child = child < 0 ? child : static_cast<int32_t>(m_nodes.size()) - 1 - child;
+                        }
+                    }
+
+                    std::vector<std::pair<uint64_t, size_t>> paths(m_nodes.size()); // (code, depth) of each node
+                    m_codes.fill(0);
+                    m_lengths.fill(0);
+                    fits = true;
+                    for (size_t index = 0; index < m_nodes.size() && fits; ++index)
+                    {
+                        auto [code, depth] = paths[index];
+                        fits               = depth < MAX_CODE_LENGTH;
+                        for (uint64_t bit = 0; bit < 2 && fits; ++bit)
+                        {
+                            int32_t child = m_nodes[index].children[bit];
+                            if (child < 0)
+                            {
+                                m_codes[-1 - child]   = code | bit << depth;
+                                m_lengths[-1 - child] = static_cast<uint8_t>(depth + 1);
+                            }
+                            else
+                            {
+                                paths[child] = {code | bit << depth, depth + 1};
+                            }
+                        }
+                    }
+                    for (const auto &c : symbols)
+                    {
+                        weights[c] = weights[c] >> 1 | 1;
+                    }
+                }
+            }
+            /**
+             * @brief Call a function for each internal node on the path of a byte's code.
+             * @param value The byte; must have a code.
+             * @param func Called as func(size_t node, uint64_t bit) from the root down.
+             */
+            template <typename Func>
+            void for_each_node(const uint8_t &value, Func &&func) const
+            {
+                uint64_t code = m_codes[value];
+                for (size_t depth = 0, index = 0; depth < m_lengths[value]; ++depth, code >>= 1)
+                {
+                    func(index, code & 1);
+                    index = static_cast<size_t>(m_nodes[index].children[code & 1]);
+                }
+            }
+
+        public:
+            huffman_wavelet_tree() = default;
+            /**
+             * @brief Build the tree of a byte sequence.
+             * @param pData The bytes.
+             * @param size The number of bytes.
+             * @param pool The pool building the bits, one range of bytes per task.
+             * @param rangeSize The number of bytes per task.
+             */
+            huffman_wavelet_tree(const uint8_t *pData, const size_t &size, worker_pool &pool, const size_t &rangeSize)
+            {
+                size_t                                 rangeCount = (size + rangeSize - 1) / rangeSize;
+                std::vector<std::array<uint64_t, 256>> before(rangeCount + 1);
+                pool.parallel_for(rangeCount,
+                                  [&](size_t range)
+                                  {
+                                      for (size_t i = range * rangeSize; i < std::min(size, (range + 1) * rangeSize); ++i)
+                                      {
+                                          ++before[range + 1][pData[i]];
+                                      }
+                                  });
+                for (size_t range = 1; range <= rangeCount; ++range)
+                {
+                    for (size_t c = 0; c < 256; ++c)
+                    {
+                        before[range][c] += before[range - 1][c];
+                    }
+                }
+                build_tree(before[rangeCount]);
+
+                // bits of each node, in order; leaves of absent bytes hold nothing
+                std::vector<uint64_t> sizes(m_nodes.size());
+                auto                  subtreeSize = [&](const int32_t &child) { return child < 0 ? before[rangeCount][-1 - child] : sizes[child]; };
+                for (size_t index = m_nodes.size(); index-- > 0;)
+                {
+                    sizes[index] = subtreeSize(m_nodes[index].children[0]) + subtreeSize(m_nodes[index].children[1]);
+                }
+                size_t totalBits = 0;
+                for (size_t index = 0; index < m_nodes.size(); ++index)
+                {
+                    m_nodes[index].offset = totalBits;
+                    totalBits += sizes[index];
+                }
+
+                // Each task writes a contiguous run of every node; only the words at both ends of a run may be
+                // shared with another task.
+                std::vector<uint64_t> words((totalBits + 63) / 64);
+                pool.parallel_for(rangeCount,
+                                  [&](size_t range)
+                                  {
+                                      std::vector<size_t> cursors(m_nodes.size());
+                                      std::vector<size_t> ends(m_nodes.size());
+                                      for (size_t index = 0; index < m_nodes.size(); ++index)
+                                      {
+                                          cursors[index] = ends[index] = m_nodes[index].offset;
+                                      }
+                                      for (size_t c = 0; c < 256; ++c)
+                                      {
+                                          if (m_lengths[c] == 0)
+                                          {
+                                              continue;
+                                          }
+                                          for_each_node(static_cast<uint8_t>(c),
+                                                        [&](const size_t &index, const uint64_t &)
+                                                        {
+                                                            cursors[index] += before[range][c];
+                                                            ends[index] += before[range + 1][c];
+                                                        });
+                                      }
+                                      std::vector<std::pair<size_t, size_t>> shared(m_nodes.size());
+                                      for (size_t index = 0; index < m_nodes.size(); ++index)
+                                      {
+                                          shared[index] = {cursors[index] / 64, (std::max(ends[index], size_t{1}) - 1) / 64};
+                                      }
+                                      for (size_t i = range * rangeSize; i < std::min(size, (range + 1) * rangeSize); ++i)
+                                      {
+                                          for_each_node(pData[i],
+                                                        [&](const size_t &index, const uint64_t &bit)
+                                                        {
+                                                            size_t position = cursors[index]++;
+                                                            if (bit == 0)
+                                                            {
+                                                                return;
+                                                            }
+                                                            uint64_t &word = words[position / 64];
+                                                            if (position / 64 == shared[index].first || position / 64 == shared[index].second)
+                                                            {
+                                                                std::atomic_ref<uint64_t>(word).fetch_or(uint64_t{1} << (position % 64), std::memory_order_relaxed);
+                                                            }
+                                                            else
+                                                            {
+                                                                word |= uint64_t{1} << (position % 64);
+                                                            }
+                                                        });
+                                      }
+                                  });
+                m_bits = rank_bit_vector(std::move(words));
+                for (auto &current : m_nodes)
+                {
+                    current.ones = m_bits.rank(current.offset);
+                }
+            }
+            /**
+             * @brief Count a byte before a position.
+             * @param value The byte.
+             * @param i The position, at most the sequence size.
+             * @return The number of occurrences of value in [0, i).
+             */
+            size_t rank(const uint8_t &value, size_t i) const
+            {
+                if (m_lengths[value] == 0)
+                {
+                    return 0;
+                }
+                for_each_node(value,
+                              [&](const size_t &index, const uint64_t &bit)
+                              {
+                                  size_t ones = m_bits.rank(m_nodes[index].offset + i) - m_nodes[index].ones;
+                                  i           = bit ? ones : i - ones;
+                              });
+                return i;
+            }
+            /**
+             * @brief Get the byte at a position together with its rank.
+             * @param i The position, less than the sequence size.
+             * @return The byte and the number of its occurrences in [0, i).
+             */
+            std::pair<uint8_t, size_t> access_rank(size_t i) const
+            {
+                for (int32_t index = 0;;)
+                {
+                    const node &current = m_nodes[index];
+                    bool        bit     = m_bits.get(current.offset + i);
+                    size_t      ones    = m_bits.rank(current.offset + i) - current.ones;
+                    i                   = bit ? ones : i - ones;
+                    index               = current.children[bit];
+                    if (index < 0)
+                    {
+                        return {static_cast<uint8_t>(-1 - index), i};
+                    }
+                }
+            }
+            /**
+             * @brief Get the memory held by the tree.
+             * @return The size in bytes.
+             */
+            size_t memory_size() const
+            {
+                return m_bits.memory_size() + m_nodes.size() * sizeof(node);
+            }
+        };
+
+        /**
+         * @brief Write values as little-endian uint64.
+         * @param out The stream.
+         * @param pValues The values.
+         * @param count The number of values.
+         */
+        inline void write_uint64s(std::ostream &out, const uint64_t *pValues, const size_t &count)
+        {
+            std::vector<uint8_t> buffer;
+            for (size_t i = 0; i < count;)
+            {
+                size_t step = std::min<size_t>(count - i, 8192);
+                buffer.resize(step * sizeof(uint64_t));
+                for (size_t j = 0; j < step; ++j)
+                {
+                    for (size_t k = 0; k < sizeof(uint64_t); ++k)
+                    {
+                        buffer[j * sizeof(uint64_t) + k] = static_cast<uint8_t>(pValues[i + j] >> (8 * k));
+                    }
+                }
+                out.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+                i += step;
+            }
+        }
+
+        /**
+         * @brief Read little-endian uint64 values.
+         * @param in The stream.
+         * @param pValues Receives the values.
+         * @param count The number of values.
+         * @return False if the stream ended early.
+         */
+        inline bool read_uint64s(std::istream &in, uint64_t *pValues, const size_t &count)
+        {
+            std::vector<uint8_t> buffer;
+            for (size_t i = 0; i < count;)
+            {
+                size_t step = std::min<size_t>(count - i, 8192);
+                buffer.resize(step * sizeof(uint64_t));
+                if (!in.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(buffer.size())))
+                {
+                    return false;
+                }
+                for (size_t j = 0; j < step; ++j)
+                {
+                    uint64_t value = 0;
+                    for (size_t k = 0; k < sizeof(uint64_t); ++k)
+                    {
+                        value |= static_cast<uint64_t>(buffer[j * sizeof(uint64_t) + k]) << (8 * k);
+                    }
+                    pValues[i + j] = value;
+                }
+                i += step;
+            }
+            return true;
+        }
+    }
+
+    /**
+     * @brief FM-index of a frozen editor snapshot, answering substring queries without the text.
+     *
+     * The index holds the Burrows-Wheeler transform of the snapshot as a Huffman-shaped wavelet tree and every
+     * sample_rate-th suffix array entry by text position: at most (H0 + 2) * 9 / 64 + 8 / sample_rate bytes per
+     * input byte, H0 being the entropy of the byte distribution in bits, so about 1.3 + 8 / sample_rate for
+     * random bytes and less for skewed data. count() takes O(m) rank lookups for a pattern of m bytes and
+     * locate() O(sample_rate) more per occurrence, both independent of the snapshot size; each lookup walks
+     * the code of a byte, O(H0) on average. The longest repeated substring is found once while building.
+     *
+     * The index describes the bytes at construction time; later edits to the editor are not reflected.
+     *
+     * @code
+     * binary::binary_fm_index index(editor);
+     * size_t hits = index.count(pattern);
+     * std::ofstream out(path + ".fmi", std::ios::binary);
+     * index.save(out);
+     * @endcode
+     */
+    class binary_fm_index
+    {
+    public:
+        /**
+         * @brief Default distance in text positions between suffix array samples.
+         */
+        static constexpr size_t DEFAULT_SAMPLE_RATE = 32;
+
+    private:
+        static constexpr char MAGIC[8] = {'B', 'E', 'F', 'M', 'I', 'D', 'X', '1'};
+
+        size_t                       m_size        = 0;                   ///< Text length; the BWT has m_size + 1 rows
+        size_t                       m_sample_rate = DEFAULT_SAMPLE_RATE; ///< Text positions between samples
+        size_t                       m_primary     = 0;                   ///< Row of the whole text, holding the sentinel
+        std::pair<size_t, size_t>    m_longest_repeat{0, 0};              ///< (offset, length) of the longest repeat
+        std::array<size_t, 256>      m_before{};                          ///< First row of suffixes starting with each byte
+        detail::huffman_wavelet_tree m_bwt;                               ///< BWT, the sentinel stored as 0
+        detail::rank_bit_vector      m_sampled;                           ///< Bit per row, set if the row has a sample
+        std::vector<uint64_t>        m_samples;                           ///< Text position of each sampled row
+
+        binary_fm_index() = default;
+
+        /**
+         * @brief Build m_bwt, m_before and m_sampled from the BWT and the sample marks.
+         * @param bwt The BWT, the sentinel stored as 0.
+         * @param sampled Bit per row, set if the row has a sample.
+         * @param pool The pool building the wavelet tree.
+         */
+        void build_ranks(std::span<const uint8_t> bwt, std::vector<uint64_t> &&sampled, worker_pool &pool)
+        {
+            m_bwt = detail::huffman_wavelet_tree(bwt.data(), bwt.size(), pool, DEFAULT_RANGE_SIZE);
+
+            // The sentinel row counts as byte 0 in the tree; rank() removes it.
+            for (size_t c = 0, sum = 1; c < 256; ++c)
+            {
+                m_before[c] = sum;
+                sum += m_bwt.rank(static_cast<uint8_t>(c), bwt.size()) - (c == 0);
+            }
+            m_sampled = detail::rank_bit_vector(std::move(sampled));
+        }
+        /**
+         * @brief Count a byte in the BWT rows before a row, the sentinel excluded.
+         * @param value The byte.
+         * @param row The row, at most size() + 1.
+         * @return The count.
+         */
+        size_t rank(const uint8_t &value, const size_t &row) const
+        {
+            size_t ret = m_bwt.rank(value, row);
+            return value == 0 && m_primary < row ? ret - 1 : ret;
+        }
+        /**
+         * @brief Get the text position of a row by walking to the nearest sampled row.
+         * @param row The row, not 0.
+         * @return The text position of the row's suffix.
+         * @throws binary_exception if no sample is reached within sample_rate steps, which means the index is corrupt.
+         */
+        size_t position(size_t row) const
+        {
+            size_t steps = 0;
+            while (!m_sampled.get(row))
+            {
+                if (steps == m_sample_rate)
+                {
+                    throw binary_exception("binary_fm_index::position err : no sample within sample rate steps, corrupt index!");
+                }
+                auto [value, count] = m_bwt.access_rank(row);
+                row                 = m_before[value] + (value == 0 && m_primary < row ? count - 1 : count);
+                ++steps;
+            }
+            return m_samples[m_sampled.rank(row)] + steps;
+        }
+        /**
+         * @brief Find the rows of the suffixes starting with a pattern by backward search.
+         * @param pattern The pattern.
+         * @return The row range [first, last).
+         */
+        std::pair<size_t, size_t> rows(std::span<const uint8_t> pattern) const
+        {
+            size_t first = 0;
+            size_t last  = m_size + 1;
+            for (size_t i = pattern.size(); i-- > 0 && first < last;)
+            {
+                first = m_before[pattern[i]] + rank(pattern[i], first);
+                last  = m_before[pattern[i]] + rank(pattern[i], last);
+            }
+            return {first, last};
+        }
+
+    public:
+        /**
+         * @brief Build the index of an editor snapshot.
+         *
+         * The suffix array is built by SA-IS, which is sequential; the BWT, the samples and the wavelet tree
+         * derived from it are built in parallel. The longest repeat reuses the suffix array's memory for Φ.
+         * Construction needs about 11 bytes per input byte temporarily, 8 more for texts of 4 GiB or more.
+         *
+         * @param editor The editor; only read during construction.
+         * @param sampleRate Distance in text positions between suffix array samples.
+         * @param pool The pool building the derived tables.
+         * @throws binary_exception if sampleRate is 0.
+         */
+        explicit binary_fm_index(const binary_editor &editor, const size_t &sampleRate = DEFAULT_SAMPLE_RATE, worker_pool &pool = worker_pool::shared())
+            : m_size(editor.size()), m_sample_rate(sampleRate)
+        {
+            if (sampleRate == 0)
+            {
+                throw binary_exception("binary_fm_index::binary_fm_index err : sampleRate must not be 0!");
+            }
+            std::vector<uint8_t> text(m_size);
+            size_t               copied = 0;
+            editor.for_each_segment(
+                [&](const uint8_t *pData, const size_t &size)
+                {
+                    memcpy(text.data() + copied, pData, size);
+                    copied += size;
+                });
+
+            size_t              rows = m_size + 1;
+            std::vector<size_t> suffixes(rows);
+            detail::sais(detail::sais_byte_text{text.data(), m_size}, rows, 257, suffixes.data());
+
+            // BWT and sample marks, one range of whole m_sampled words per task.
+            std::vector<uint8_t>  bwt(rows);
+            std::vector<uint64_t> sampled((rows + 63) / 64);
+            pool.parallel_for_ranges(rows, DEFAULT_RANGE_SIZE,
+                                     [&](size_t first, size_t last)
+                                     {
+                                         for (size_t row = first; row < last; ++row)
+                                         {
+                                             bwt[row] = suffixes[row] == 0 ? 0 : text[suffixes[row] - 1];
+                                             if (suffixes[row] % m_sample_rate == 0)
+                                             {
+                                                 sampled[row / 64] |= 1ull << (row % 64);
+                                             }
+                                         }
+                                     });
+            m_primary = static_cast<size_t>(std::find(suffixes.begin(), suffixes.end(), 0) - suffixes.begin());
+            build_ranks(bwt, std::move(sampled), pool);
+            bwt = std::vector<uint8_t>();
+            m_samples.resize(m_sampled.rank(rows));
+            pool.parallel_for_ranges(rows, DEFAULT_RANGE_SIZE,
+                                     [&](size_t first, size_t last)
+                                     {
+                                         size_t next = m_sampled.rank(first);
+                                         for (size_t row = first; row < last; ++row)
+                                         {
+                                             if (suffixes[row] % m_sample_rate == 0)
+                                             {
+                                                 m_samples[next++] = suffixes[row];
+                                             }
+                                         }
+                                     });
+
+            // Longest repeat: the largest LCP of suffixes adjacent in the suffix array, computed in text
+            // order from the previous suffix of each one (PLCP), which shrinks by at most 1 per step.
+            detail::suffix_predecessors(suffixes);
+            for (size_t i = 0, common = 0; i < m_size; ++i)
+            {
+                if (suffixes[i] >= m_size)
+                {
+                    common = 0;
+                    continue;
+                }
+                size_t j = suffixes[i];
+                while (i + common < m_size && j + common < m_size && text[i + common] == text[j + common])
+                {
+                    ++common;
+                }
+                if (common > m_longest_repeat.second)
+                {
+                    m_longest_repeat = {i, common};
+                }
+                common -= common > 0;
+            }
+        }
+        /**
+         * @brief Get the number of indexed bytes.
+         * @return The snapshot size.
+         */
+        size_t size() const
+        {
+            return m_size;
+        }
+        /**
+         * @brief Get the distance between suffix array samples.
+         * @return The sample rate.
+         */
+        size_t sample_rate() const
+        {
+            return m_sample_rate;
+        }
+        /**
+         * @brief Count the occurrences of a pattern.
+         * @param pattern The pattern; an empty pattern matches nothing.
+         * @return The number of occurrences, overlapping ones included.
+         */
+        size_t count(std::span<const uint8_t> pattern) const
+        {
+            if (pattern.empty())
+            {
+                return 0;
+            }
+            auto [first, last] = rows(pattern);
+            return last - first;
+        }
+        /**
+         * @brief Find the offsets of the occurrences of a pattern.
+         * @param pattern The pattern; an empty pattern matches nothing.
+         * @param maxCount Stop after this many occurrences, which are then not necessarily the first ones.
+         * @return The offsets in increasing order.
+         * @throws binary_exception if the index is corrupt.
+         */
+        std::vector<size_t> locate(std::span<const uint8_t> pattern, const size_t &maxCount = SIZE_MAX) const
+        {
+            std::vector<size_t> ret;
+            if (pattern.empty())
+            {
+                return ret;
+            }
+            auto [first, last] = rows(pattern);
+            for (size_t row = first; row < last && ret.size() < maxCount; ++row)
+            {
+                ret.push_back(position(row));
+            }
+            std::sort(ret.begin(), ret.end());
+            return ret;
+        }
+        /**
+         * @brief Get the memory held by the index.
+         * @return The size in bytes.
+         */
+        size_t memory_size() const
+        {
+            return m_bwt.memory_size() + m_sampled.memory_size() + m_samples.size() * sizeof(uint64_t);
+        }
+        /**
+         * @brief Get the longest substring occurring at least twice, occurrences may overlap.
+         * @return (offset, length) of one occurrence, length 0 if no byte repeats.
+         */
+        std::pair<size_t, size_t> longest_repeat() const
+        {
+            return m_longest_repeat;
+        }
+        /**
+         * @brief Write the index to a stream.
+         *
+         * Layout: MAGIC, then size, sample rate, primary row, longest repeat offset and length as
+         * little-endian uint64, the BWT bytes, the sample mark words and the samples. The wavelet tree is
+         * rebuilt by load().
+         *
+         * @param out The stream.
+         * @throws binary_exception if writing fails.
+         */
+        void save(std::ostream &out) const
+        {
+            out.write(MAGIC, sizeof(MAGIC));
+            uint64_t header[] = {m_size, m_sample_rate, m_primary, m_longest_repeat.first, m_longest_repeat.second};
+            detail::write_uint64s(out, header, std::size(header));
+            std::vector<uint8_t> buffer;
+            for (size_t row = 0; row < m_size + 1;)
+            {
+                buffer.resize(std::min<size_t>(m_size + 1 - row, 65536));
+                for (auto &value : buffer)
+                {
+                    value = m_bwt.access_rank(row++).first;
+                }
+                out.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+            }
+            detail::write_uint64s(out, m_sampled.words().data(), m_sampled.words().size());
+            detail::write_uint64s(out, m_samples.data(), m_samples.size());
+            if (!out)
+            {
+                throw binary_exception("binary_fm_index::save err : failed to write the index!");
+            }
+        }
+        /**
+         * @brief Read an index written by save().
+         * @param in The stream.
+         * @param pool The pool rebuilding the rank tables.
+         * @return The index.
+         * @throws binary_exception if the stream does not hold a valid index.
+         */
+        static binary_fm_index load(std::istream &in, worker_pool &pool = worker_pool::shared())
+        {
+            char     magic[sizeof(MAGIC)];
+            uint64_t header[5];
+            if (!in.read(magic, sizeof(magic)) || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || !detail::read_uint64s(in, header, std::size(header)))
+            {
+                throw binary_exception("binary_fm_index::load err : not an index!");
+            }
+            binary_fm_index ret;
+            ret.m_size           = header[0];
+            ret.m_sample_rate    = header[1];
+            ret.m_primary        = header[2];
+            ret.m_longest_repeat = {header[3], header[4]};
+            if (ret.m_size == SIZE_MAX || ret.m_sample_rate == 0 || ret.m_primary > ret.m_size || ret.m_longest_repeat.second > ret.m_size)
+            {
+                throw binary_exception("binary_fm_index::load err : invalid header!");
+            }
+            // The BWT grows with the bytes actually read, so a corrupt size fails on the stream length rather than
+            // allocating it up front; the other parts are bounded by the BWT.
+            size_t               rows = ret.m_size + 1;
+            std::vector<uint8_t> bwt;
+            for (size_t read = 0; read < rows;)
+            {
+                size_t step = std::min<size_t>(rows - read, DEFAULT_RANGE_SIZE);
+                bwt.resize(read + step);
+                if (!in.read(reinterpret_cast<char *>(bwt.data() + read), static_cast<std::streamsize>(step)))
+                {
+                    throw binary_exception("binary_fm_index::load err : truncated index!");
+                }
+                read += step;
+            }
+            std::vector<uint64_t> sampled((rows + 63) / 64);
+            if (!detail::read_uint64s(in, sampled.data(), sampled.size()))
+            {
+                throw binary_exception("binary_fm_index::load err : truncated index!");
+            }
+            if (bwt[ret.m_primary] != 0)
+            {
+                throw binary_exception("binary_fm_index::load err : invalid BWT!");
+            }
+            ret.build_ranks(bwt, std::move(sampled), pool);
+            ret.m_samples.resize(ret.m_sampled.rank(rows));
+            if (ret.m_samples.size() != ret.m_size / ret.m_sample_rate + 1 || !ret.m_sampled.get(ret.m_primary) ||
+                !detail::read_uint64s(in, ret.m_samples.data(), ret.m_samples.size()))
+            {
+                throw binary_exception("binary_fm_index::load err : truncated index!");
+            }
+            if (std::any_of(ret.m_samples.begin(), ret.m_samples.end(), [&ret](const uint64_t &sample) { return sample > ret.m_size; }))
+            {
+                throw binary_exception("binary_fm_index::load err : invalid samples!");
+            }
+            return ret;
+        }
+    };
+}
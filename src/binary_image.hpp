@@ -0,0 +1,321 @@
+#pragma once
+#include "binary_editor.hpp"
+
+namespace binary
+{
+    /**
+     * @brief Two-dimensional view of raw pixels stored in an editor with a row stride.
+     *
+     * Row y starts at offset + y * stride and holds width pixels; bytes between the end of a row and the start
+     * of the next are left alone. Rows and rectangles are read straight from the chunks, so the buffer is never
+     * flattened. The view refers to the editor, which must outlive it.
+     *
+     * @code
+     * binary::binary_image_view<uint32_t> frame(editor, 640, 480, 2560, headerSize);
+     * std::vector<uint32_t> scratch;
+     * auto row = frame.row(10, scratch);
+     * @endcode
+     *
+     * @tparam Pixel The trivially copyable pixel type.
+     */
+    template <typename Pixel>
+    class binary_image_view
+    {
+        static_assert(std::is_trivially_copyable_v<Pixel>, "binary_image_view requires a trivially copyable pixel type");
+
+    private:
+        binary_editor &m_editor;
+        size_t         m_width;
+        size_t         m_height;
+        size_t         m_stride;
+        size_t         m_offset;
+
+        /**
+         * @brief Check that a rectangle lies within the image.
+         */
+        bool is_valid_rect(const size_t &x, const size_t &y, const size_t &width, const size_t &height) const
+        {
+            return x <= m_width && width <= m_width - x && y <= m_height && height <= m_height - y;
+        }
+        /**
+         * @brief Get the editor offset of a pixel.
+         */
+        size_t offset_of(const size_t &x, const size_t &y) const
+        {
+            return m_offset + y * m_stride + x * sizeof(Pixel);
+        }
+        /**
+         * @brief Copy a range of the editor to a buffer.
+         */
+        void read_range(const size_t &offset, const size_t &size, uint8_t *pOut) const
+        {
+            m_editor.for_each_segment(offset, size,
+                                      [&pOut](const uint8_t *pData, const size_t &segmentSize)
+                                      {
+                                          memcpy(pOut, pData, segmentSize);
+                                          pOut += segmentSize;
+                                      });
+        }
+
+    public:
+        /**
+         * @brief Create a view.
+         * @param editor The editor holding the pixels.
+         * @param width Pixels per row.
+         * @param height Number of rows.
+         * @param stride Bytes from the start of a row to the start of the next.
+         * @param offset Offset of the first row.
+         * @throws binary_exception if stride is smaller than a row or the rows exceed the editor.
+         */
+        binary_image_view(binary_editor &editor, const size_t &width, const size_t &height, const size_t &stride, const size_t &offset = 0)
+            : m_editor(editor), m_width(width), m_height(height), m_stride(stride), m_offset(offset)
+        {
+            if (width > SIZE_MAX / sizeof(Pixel) || stride < width * sizeof(Pixel))
+            {
+                throw binary_exception("binary_image_view::binary_image_view err : stride must not be smaller than width * sizeof(Pixel)!");
+            }
+            if (height != 0 && (height - 1 > (SIZE_MAX - width * sizeof(Pixel)) / std::max<size_t>(stride, 1) ||
+                                !editor.is_valid_range(offset, (height - 1) * stride + width * sizeof(Pixel))))
+            {
+                throw binary_exception("binary_image_view::binary_image_view err : rows must not exceed the editor!");
+            }
+        }
+        /**
+         * @brief Get the number of pixels per row.
+         * @return The width.
+         */
+        size_t width() const
+        {
+            return m_width;
+        }
+        /**
+         * @brief Get the number of rows.
+         * @return The height.
+         */
+        size_t height() const
+        {
+            return m_height;
+        }
+        /**
+         * @brief Get the number of bytes from the start of a row to the start of the next.
+         * @return The stride.
+         */
+        size_t stride() const
+        {
+            return m_stride;
+        }
+        /**
+         * @brief Get the offset of the first row in the editor.
+         * @return The offset.
+         */
+        size_t offset() const
+        {
+            return m_offset;
+        }
+        /**
+         * @brief Read one pixel.
+         * @param x The column.
+         * @param y The row.
+         * @return The pixel.
+         * @throws binary_exception if the pixel lies outside the image.
+         */
+        Pixel at(const size_t &x, const size_t &y) const
+        {
+            if (x >= m_width || y >= m_height)
+            {
+                throw binary_exception("binary_image_view::at err : pixel must lie within the image!");
+            }
+            Pixel ret;
+            read_range(offset_of(x, y), sizeof(Pixel), reinterpret_cast<uint8_t *>(&ret));
+            return ret;
+        }
+        /**
+         * @brief Get the pixels of a row.
+         *
+         * A row lying inside one suitably aligned chunk is returned in place; otherwise it is assembled in scratch.
+         *
+         * @param y The row.
+         * @param scratch Buffer used when the row cannot be returned in place.
+         * @return The width pixels of the row, valid until the editor or scratch changes.
+         * @throws binary_exception if y is not less than height().
+         */
+        std::span<const Pixel> row(const size_t &y, std::vector<Pixel> &scratch) const
+        {
+            if (y >= m_height)
+            {
+                throw binary_exception("binary_image_view::row err : y must be less than height!");
+            }
+            size_t         rowSize = m_width * sizeof(Pixel);
+            const uint8_t *pRow    = nullptr;
+            m_editor.for_each_segment(offset_of(0, y), rowSize,
+                                      [&](const uint8_t *pData, const size_t &size)
+                                      {
+                                          if (size == rowSize)
+                                          {
+                                              pRow = pData;
+                                          }
+                                          return false;
+                                      });
+            if (pRow != nullptr && reinterpret_cast<uintptr_t>(pRow) % alignof(Pixel) == 0)
+            {
+                return std::span<const Pixel>(reinterpret_cast<const Pixel *>(pRow), m_width);
+            }
+            scratch.resize(m_width);
+            read_range(offset_of(0, y), rowSize, reinterpret_cast<uint8_t *>(scratch.data()));
+            return scratch;
+        }
+        /**
+         * @brief Walk the rows in order.
+         * @tparam Func Callable as func(size_t y, std::span<const Pixel> row); may return bool, false stops the walk.
+         * @param func Called for each row, with rows as returned by row().
+         */
+        template <typename Func>
+        void for_each_row(Func &&func) const
+        {
+            std::vector<Pixel> scratch;
+            for (size_t y = 0; y < m_height; ++y)
+            {
+                if constexpr (std::is_same_v<std::invoke_result_t<Func &, size_t, std::span<const Pixel>>, bool>)
+                {
+                    if (!func(y, row(y, scratch)))
+                    {
+                        return;
+                    }
+                }
+                else
+                {
+                    func(y, row(y, scratch));
+                }
+            }
+        }
+        /**
+         * @brief Copy a rectangle out of the image.
+         * @param x The left column.
+         * @param y The top row.
+         * @param width The rectangle width.
+         * @param height The rectangle height.
+         * @param out Receives the rectangle row by row, width * height pixels.
+         * @throws binary_exception if the rectangle lies outside the image or out is too small.
+         */
+        void copy_out(const size_t &x, const size_t &y, const size_t &width, const size_t &height, std::span<Pixel> out) const
+        {
+            if (!is_valid_rect(x, y, width, height))
+            {
+                throw binary_exception("binary_image_view::copy_out err : rectangle must lie within the image!");
+            }
+            if (out.size() < width * height)
+            {
+                throw binary_exception("binary_image_view::copy_out err : out must hold width * height pixels!");
+            }
+            for (size_t row = 0; row < height; ++row)
+            {
+                read_range(offset_of(x, y + row), width * sizeof(Pixel), reinterpret_cast<uint8_t *>(out.data() + row * width));
+            }
+        }
+        /**
+         * @brief Copy a rectangle into the image.
+         *
+         * The chunks are immutable, so the bytes of the rectangle are replaced with new chunks; the rest of the
+         * editor keeps its chunks. Rows separated by gaps no wider than a row share one new chunk that also
+         * copies the gaps, at most twice the rectangle's bytes; rows separated by wider gaps get a chunk each,
+         * so a narrow rectangle costs only its own bytes plus one chunk per row.
+         *
+         * @param x The left column.
+         * @param y The top row.
+         * @param width The rectangle width.
+         * @param height The rectangle height.
+         * @param in The rectangle row by row, width * height pixels.
+         * @throws binary_exception if the rectangle lies outside the image or in is too small.
+         */
+        void copy_in(const size_t &x, const size_t &y, const size_t &width, const size_t &height, std::span<const Pixel> in)
+        {
+            if (!is_valid_rect(x, y, width, height))
+            {
+                throw binary_exception("binary_image_view::copy_in err : rectangle must lie within the image!");
+            }
+            if (in.size() < width * height)
+            {
+                throw binary_exception("binary_image_view::copy_in err : in must hold width * height pixels!");
+            }
+            if (width == 0 || height == 0)
+            {
+                return;
+            }
+            size_t        rowSize = width * sizeof(Pixel);
+            size_t        gap     = m_stride - rowSize;
+            size_t        first   = offset_of(x, y);
+            size_t        last    = first + (height - 1) * m_stride + rowSize;
+            binary_editor ret     = m_editor.create_sub_editor(0, first);
+            if (gap <= rowSize)
+            {
+                auto pBlob = std::make_unique<uint8_t[]>(last - first);
+                for (size_t row = 0; row < height; ++row)
+                {
+                    memcpy(pBlob.get() + row * m_stride, in.data() + row * width, rowSize);
+                    if (row + 1 < height && gap != 0)
+                    {
+                        read_range(first + row * m_stride + rowSize, gap, pBlob.get() + row * m_stride + rowSize);
+                    }
+                }
+                ret.emplace_back(std::unique_ptr<const uint8_t[]>(std::move(pBlob)), last - first);
+            }
+            else
+            {
+                for (size_t row = 0; row < height; ++row)
+                {
+                    auto pRow = std::make_unique<uint8_t[]>(rowSize);
+                    memcpy(pRow.get(), in.data() + row * width, rowSize);
+                    ret.emplace_back(std::unique_ptr<const uint8_t[]>(std::move(pRow)), rowSize);
+                    if (row + 1 < height)
+                    {
+                        ret.push_back(m_editor.create_sub_editor(first + row * m_stride + rowSize, gap));
+                    }
+                }
+            }
+            ret.push_back(m_editor.create_sub_editor(last, m_editor.size() - last));
+            m_editor = std::move(ret);
+        }
+        /**
+         * @brief Walk the image in tiles, left to right then top to bottom.
+         *
+         * Tiles on the right and bottom edges are clipped to the image.
+         *
+         * @tparam Func Callable as func(size_t x, size_t y, size_t width, size_t height, std::span<const Pixel> tile),
+         *              where tile holds the pixels row by row; may return bool, false stops the walk.
+         * @param tileWidth The tile width.
+         * @param tileHeight The tile height.
+         * @param func Called for each tile.
+         * @throws binary_exception if tileWidth or tileHeight is 0.
+         */
+        template <typename Func>
+        void for_each_tile(const size_t &tileWidth, const size_t &tileHeight, Func &&func) const
+        {
+            if (tileWidth == 0 || tileHeight == 0)
+            {
+                throw binary_exception("binary_image_view::for_each_tile err : tile size must not be 0!");
+            }
+            std::vector<Pixel> tile;
+            for (size_t y = 0; y < m_height; y += tileHeight)
+            {
+                size_t height = std::min(tileHeight, m_height - y);
+                for (size_t x = 0; x < m_width; x += tileWidth)
+                {
+                    size_t width = std::min(tileWidth, m_width - x);
+                    tile.resize(width * height);
+                    copy_out(x, y, width, height, tile);
+                    if constexpr (std::is_same_v<std::invoke_result_t<Func &, size_t, size_t, size_t, size_t, std::span<const Pixel>>, bool>)
+                    {
+                        if (!func(x, y, width, height, std::span<const Pixel>(tile)))
+                        {
+                            return;
+                        }
+                    }
+                    else
+                    {
+                        func(x, y, width, height, std::span<const Pixel>(tile));
+                    }
+                }
+            }
+        }
+    };
+}
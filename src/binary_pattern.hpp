@@ -0,0 +1,560 @@
+#pragma once
+#include "binary_editor.hpp"
+#include "binary_search.hpp"
+#include <bit>
+#include <string_view>
+#include <utility>
+
+namespace binary
+{
+    namespace detail
+    {
+        /**
+         * @brief String literal usable as a template argument.
+         * @tparam N Size of the literal including the terminating zero.
+         */
+        template <size_t N>
+        struct fixed_string
+        {
+            char value[N] = {};
+
+            constexpr fixed_string(const char (&text)[N])
+            {
+                std::copy(text, text + N, value);
+            }
+            constexpr std::string_view view() const
+            {
+                return std::string_view(value, N - 1);
+            }
+        };
+
+        /**
+         * @brief Parse one pattern nibble.
+         * @param c The character: a hex digit or '?'.
+         * @param value Receives the nibble value.
+         * @param mask Receives 0xF for a hex digit, 0 for '?'.
+         * @return False if c is neither.
+         */
+        constexpr bool parse_pattern_nibble(const char &c, uint8_t &value, uint8_t &mask)
+        {
+            mask = 0xF;
+            if (c >= '0' && c <= '9')
+            {
+                value = static_cast<uint8_t>(c - '0');
+            }
+            else if (c >= 'a' && c <= 'f')
+            {
+                value = static_cast<uint8_t>(c - 'a' + 10);
+            }
+            else if (c >= 'A' && c <= 'F')
+            {
+                value = static_cast<uint8_t>(c - 'A' + 10);
+            }
+            else if (c == '?')
+            {
+                value = 0;
+                mask  = 0;
+            }
+            else
+            {
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Tokenize a signature such as "48 8B ?? E8 4?".
+         *
+         * Tokens are separated by whitespace. A token is two characters, each a hex digit or '?' matching any
+         * nibble, or a single '?' matching any byte.
+         *
+         * @tparam Func The callback type.
+         * @param text The signature.
+         * @param func Called as func(index, value, mask) for each byte, value has the wildcard bits cleared.
+         * @return The number of bytes.
+         * @throws binary_exception if the signature is empty or malformed; a compile error when evaluated at compile time.
+         */
+        template <typename Func>
+        constexpr size_t for_each_pattern_byte(std::string_view text, Func &&func)
+        {
+            size_t count = 0;
+            size_t i     = 0;
+            while (true)
+            {
+                while (i < text.size() && (text[i] == ' ' || text[i] == '\t' || text[i] == '\n' || text[i] == '\r'))
+                {
+                    ++i;
+                }
+                if (i == text.size())
+                {
+                    break;
+                }
+                size_t tokenEnd = i;
+                while (tokenEnd < text.size() && text[tokenEnd] != ' ' && text[tokenEnd] != '\t' && text[tokenEnd] != '\n' && text[tokenEnd] != '\r')
+                {
+                    ++tokenEnd;
+                }
+                uint8_t value = 0;
+                uint8_t mask  = 0;
+                if (tokenEnd - i == 1 && text[i] == '?')
+                {
+                    value = 0;
+                    mask  = 0;
+                }
+                else
+                {
+                    uint8_t highValue = 0;
+                    uint8_t highMask  = 0;
+                    uint8_t lowValue  = 0;
+                    uint8_t lowMask   = 0;
+                    if (tokenEnd - i != 2 || !parse_pattern_nibble(text[i], highValue, highMask) || !parse_pattern_nibble(text[i + 1], lowValue, lowMask))
+                    {
+                        throw binary_exception("parse_pattern err : malformed token in pattern!");
+                    }
+                    value = static_cast<uint8_t>(highValue << 4 | lowValue);
+                    mask  = static_cast<uint8_t>(highMask << 4 | lowMask);
+                }
+                func(count, value, mask);
+                ++count;
+                i = tokenEnd;
+            }
+            if (count == 0)
+            {
+                throw binary_exception("parse_pattern err : pattern must not be empty!");
+            }
+            return count;
+        }
+
+        /**
+         * @brief Count the bytes of a signature, see for_each_pattern_byte() for the syntax.
+         * @param text The signature.
+         * @return The number of bytes.
+         * @throws binary_exception if the signature is empty or malformed; a compile error when evaluated at compile time.
+         */
+        constexpr size_t parse_pattern(std::string_view text)
+        {
+            return for_each_pattern_byte(text, [](const size_t &, const uint8_t &, const uint8_t &) {});
+        }
+
+        /**
+         * @brief Parse a signature, see for_each_pattern_byte() for the syntax.
+         * @param text The signature.
+         * @param pBytes Receives the byte values with wildcard bits cleared, sized by parse_pattern(text).
+         * @param pMasks Receives the masks of the bits that must match, sized by parse_pattern(text).
+         * @return The number of bytes.
+         * @throws binary_exception if the signature is empty or malformed; a compile error when evaluated at compile time.
+         */
+        constexpr size_t parse_pattern(std::string_view text, uint8_t *pBytes, uint8_t *pMasks)
+        {
+            return for_each_pattern_byte(text, [pBytes, pMasks](const size_t &index, const uint8_t &value, const uint8_t &mask) {
+                pBytes[index] = value;
+                pMasks[index] = mask;
+            });
+        }
+
+        /**
+         * @brief Estimate how common a byte is in executables and data, lower is rarer.
+         * @param value The byte.
+         * @return A score from 0 to 3.
+         */
+        constexpr int byte_commonness(const uint8_t &value)
+        {
+            switch (value)
+            {
+            case 0x00:
+            case 0xFF:
+                return 3;
+            case 0x01:
+            case 0x48:
+            case 0x89:
+            case 0x8B:
+            case 0xCC:
+            case 0x90:
+            case 0x20:
+                return 2;
+            case 0x0F:
+            case 0x24:
+            case 0x4C:
+            case 0x8D:
+            case 0x85:
+            case 0xC0:
+            case 0xE8:
+            case 0x44:
+            case 0x02:
+            case 0x04:
+            case 0x08:
+            case 0x10:
+            case 0x80:
+                return 1;
+            default:
+                return 0;
+            }
+        }
+
+        /**
+         * @brief Choose the two pattern positions filtered by the vector scan.
+         *
+         * Positions with more fixed bits are preferred, then rarer bytes by byte_commonness(); the second anchor
+         * is the best position other than the first, so the two compares reject independently.
+         *
+         * @param pBytes The byte values.
+         * @param pMasks The masks.
+         * @param size The pattern size.
+         * @return (first anchor, second anchor); equal if the pattern has one position.
+         */
+        constexpr std::pair<size_t, size_t> choose_pattern_anchors(const uint8_t *pBytes, const uint8_t *pMasks, const size_t &size)
+        {
+            auto score = [&](const size_t &i) { return std::popcount(pMasks[i]) * 4 - (pMasks[i] == 0xFF ? byte_commonness(pBytes[i]) : 3); };
+            size_t first = 0;
+            for (size_t i = 1; i < size; ++i)
+            {
+                if (score(i) > score(first))
+                {
+                    first = i;
+                }
+            }
+            size_t second = first;
+            for (size_t i = 0; i < size; ++i)
+            {
+                if (i != first && (second == first || score(i) > score(second)))
+                {
+                    second = i;
+                }
+            }
+            return {first, second};
+        }
+
+        /**
+         * @brief Bytes, masks and anchors of a signature parsed at compile time.
+         * @tparam N The pattern size.
+         */
+        template <size_t N>
+        struct compiled_pattern
+        {
+            std::array<uint8_t, N> bytes{};
+            std::array<uint8_t, N> masks{};
+            size_t                 first_anchor  = 0;
+            size_t                 second_anchor = 0;
+
+            constexpr explicit compiled_pattern(std::string_view text)
+            {
+                parse_pattern(text, bytes.data(), masks.data());
+                auto anchors  = choose_pattern_anchors(bytes.data(), masks.data(), N);
+                first_anchor  = anchors.first;
+                second_anchor = anchors.second;
+            }
+        };
+
+        /**
+         * @brief Compare the masked bytes of a vector with a value.
+         * @param bytes The bytes.
+         * @param value The value broadcast to all lanes.
+         * @param mask The mask broadcast to all lanes.
+         * @param fullMask Whether every mask is 0xFF, skipping the and.
+         * @return 0xFF in the lanes that match.
+         */
+#if defined(BINARY_EDITOR_SSE2)
+        inline __m128i masked_equal(const __m128i &bytes, const __m128i &value, const __m128i &mask, const bool &fullMask)
+        {
+            return _mm_cmpeq_epi8(fullMask ? bytes : _mm_and_si128(bytes, mask), value);
+        }
+#endif
+
+        /**
+         * @brief Find the first window of a buffer matching a masked pattern.
+         *
+         * Candidates are filtered 16 positions at a time by the two anchor bytes, then verified with match.
+         * With constant arguments, as passed by pattern, the compiler folds the anchors and masks into the loop.
+         *
+         * @param pData The buffer; holds count + size - 1 bytes.
+         * @param count Number of windows.
+         * @param pBytes The byte values.
+         * @param pMasks The masks.
+         * @param firstAnchor The first anchor position.
+         * @param secondAnchor The second anchor position.
+         * @param match Called as match(const uint8_t *pWindow) to verify a candidate.
+         * @return The index of the first matching window, or count if none.
+         */
+        template <typename Match>
+        inline size_t find_masked(const uint8_t *pData, const size_t &count, const uint8_t *pBytes, const uint8_t *pMasks, const size_t &firstAnchor,
+                                  const size_t &secondAnchor, Match &&match)
+        {
+            size_t i = 0;
+#if defined(BINARY_EDITOR_SSE2)
+            if (pMasks[firstAnchor] != 0)
+            {
+                const bool    firstFull   = pMasks[firstAnchor] == 0xFF;
+                const bool    secondFull  = pMasks[secondAnchor] == 0xFF;
+                const __m128i firstValue  = _mm_set1_epi8(static_cast<char>(pBytes[firstAnchor]));
+                const __m128i firstMask   = _mm_set1_epi8(static_cast<char>(pMasks[firstAnchor]));
+                const __m128i secondValue = _mm_set1_epi8(static_cast<char>(pBytes[secondAnchor]));
+                const __m128i secondMask  = _mm_set1_epi8(static_cast<char>(pMasks[secondAnchor]));
+                for (; i + 16 <= count; i += 16)
+                {
+                    __m128i  first  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pData + i + firstAnchor));
+                    __m128i  second = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pData + i + secondAnchor));
+                    uint32_t mask   = static_cast<uint32_t>(
+                        _mm_movemask_epi8(_mm_and_si128(masked_equal(first, firstValue, firstMask, firstFull), masked_equal(second, secondValue, secondMask, secondFull))));
+                    while (mask != 0)
+                    {
+                        size_t candidate = i + std::countr_zero(mask);
+                        if (match(pData + candidate))
+                        {
+                            return candidate;
+                        }
+                        mask &= mask - 1;
+                    }
+                }
+            }
+#endif
+            for (; i < count; ++i)
+            {
+                if (match(pData + i))
+                {
+                    return i;
+                }
+            }
+            return count;
+        }
+    }
+
+    /**
+     * @brief Signature known at compile time, such as binary::pattern<"48 8B ?? E8">.
+     *
+     * The signature is parsed during compilation, so a malformed one is a compile error. Verification is
+     * unrolled per byte, skipping wildcards and masking only partial nibbles, and the two anchor bytes of the
+     * vector filter are compile-time constants.
+     *
+     * @code
+     * using call_rel32 = binary::pattern<"E8 ?? ?? ?? ?? 48 8B">;
+     * call_rel32::find_all(editor, [](size_t offset) { report(offset); });
+     * @endcode
+     *
+     * @tparam Text The signature, in the syntax of detail::for_each_pattern_byte().
+     */
+    template <detail::fixed_string Text>
+    class pattern
+    {
+    private:
+        static constexpr size_t                           SIZE = detail::parse_pattern(Text.view());
+        static constexpr detail::compiled_pattern<SIZE> DATA{Text.view()};
+
+        template <size_t I>
+        static constexpr bool match_byte(const uint8_t *pWindow)
+        {
+            if constexpr (DATA.masks[I] == 0)
+            {
+                return true;
+            }
+            else if constexpr (DATA.masks[I] == 0xFF)
+            {
+                return pWindow[I] == DATA.bytes[I];
+            }
+            else
+            {
+                return (pWindow[I] & DATA.masks[I]) == DATA.bytes[I];
+            }
+        }
+
+    public:
+        /**
+         * @brief Get the number of bytes of the signature.
+         * @return The size.
+         */
+        static constexpr size_t size()
+        {
+            return SIZE;
+        }
+        /**
+         * @brief Check whether the signature matches at a position.
+         * @param pWindow At least size() bytes.
+         * @return True if it matches.
+         */
+        static constexpr bool match(const uint8_t *pWindow)
+        {
+            return [pWindow]<size_t... I>(std::index_sequence<I...>) { return (match_byte<I>(pWindow) && ...); }(std::make_index_sequence<SIZE>());
+        }
+        /**
+         * @brief Find the first matching window of a buffer.
+         * @param pData The buffer; holds count + size() - 1 bytes.
+         * @param count Number of windows.
+         * @return The index of the window, or count if none.
+         */
+        static size_t find_first(const uint8_t *pData, const size_t &count)
+        {
+            return detail::find_masked(pData, count, DATA.bytes.data(), DATA.masks.data(), DATA.first_anchor, DATA.second_anchor, &match);
+        }
+        /**
+         * @brief Report every match in an editor, including matches spanning chunks.
+         * @tparam Func Callable as func(size_t offset); may return bool, false stops the search.
+         * @param editor The editor to search.
+         * @param func Called with the offset of each match in increasing order.
+         * @param offset The offset to start searching from.
+         */
+        template <typename Func>
+        static void find_all(const binary_editor &editor, Func &&func, const size_t &offset = 0)
+        {
+            detail::for_each_window(editor, offset, editor.size(), SIZE,
+                                    [&](const uint8_t *pData, size_t count, size_t base)
+                                    {
+                                        for (size_t start = 0; start < count;)
+                                        {
+                                            size_t found = find_first(pData + start, count - start);
+                                            if (found == count - start)
+                                            {
+                                                break;
+                                            }
+                                            if constexpr (std::is_same_v<std::invoke_result_t<Func &, size_t>, bool>)
+                                            {
+                                                if (!func(base + start + found))
+                                                {
+                                                    return false;
+                                                }
+                                            }
+                                            else
+                                            {
+                                                func(base + start + found);
+                                            }
+                                            start += found + 1;
+                                        }
+                                        return true;
+                                    });
+        }
+        /**
+         * @brief Find the first match in an editor.
+         * @param editor The editor to search.
+         * @param offset The offset to start searching from.
+         * @return The offset of the match, or std::nullopt if there is none.
+         */
+        static std::optional<size_t> find(const binary_editor &editor, const size_t &offset = 0)
+        {
+            std::optional<size_t> ret;
+            find_all(
+                editor,
+                [&ret](size_t position)
+                {
+                    ret = position;
+                    return false;
+                },
+                offset);
+            return ret;
+        }
+    };
+
+    /**
+     * @brief Signature parsed at run time, the counterpart of pattern for signatures loaded from data.
+     */
+    class binary_masked_pattern
+    {
+    private:
+        std::vector<uint8_t> m_bytes;
+        std::vector<uint8_t> m_masks;
+        size_t               m_first_anchor  = 0;
+        size_t               m_second_anchor = 0;
+
+    public:
+        /**
+         * @brief Parse a signature.
+         * @param text The signature, in the syntax of detail::for_each_pattern_byte().
+         * @throws binary_exception if the signature is empty or malformed.
+         */
+        explicit binary_masked_pattern(std::string_view text)
+        {
+            size_t size = detail::parse_pattern(text);
+            m_bytes.resize(size);
+            m_masks.resize(size);
+            detail::parse_pattern(text, m_bytes.data(), m_masks.data());
+            std::tie(m_first_anchor, m_second_anchor) = detail::choose_pattern_anchors(m_bytes.data(), m_masks.data(), size);
+        }
+        /**
+         * @brief Get the number of bytes of the signature.
+         * @return The size.
+         */
+        size_t size() const
+        {
+            return m_bytes.size();
+        }
+        /**
+         * @brief Check whether the signature matches at a position.
+         * @param pWindow At least size() bytes.
+         * @return True if it matches.
+         */
+        bool match(const uint8_t *pWindow) const
+        {
+            for (size_t i = 0; i < m_bytes.size(); ++i)
+            {
+                if ((pWindow[i] & m_masks[i]) != m_bytes[i])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+        /**
+         * @brief Find the first matching window of a buffer.
+         * @param pData The buffer; holds count + size() - 1 bytes.
+         * @param count Number of windows.
+         * @return The index of the window, or count if none.
+         */
+        size_t find_first(const uint8_t *pData, const size_t &count) const
+        {
+            return detail::find_masked(pData, count, m_bytes.data(), m_masks.data(), m_first_anchor, m_second_anchor,
+                                       [this](const uint8_t *pWindow) { return match(pWindow); });
+        }
+        /**
+         * @brief Report every match in an editor, including matches spanning chunks.
+         * @tparam Func Callable as func(size_t offset); may return bool, false stops the search.
+         * @param editor The editor to search.
+         * @param func Called with the offset of each match in increasing order.
+         * @param offset The offset to start searching from.
+         */
+        template <typename Func>
+        void find_all(const binary_editor &editor, Func &&func, const size_t &offset = 0) const
+        {
+            detail::for_each_window(editor, offset, editor.size(), m_bytes.size(),
+                                    [&](const uint8_t *pData, size_t count, size_t base)
+                                    {
+                                        for (size_t start = 0; start < count;)
+                                        {
+                                            size_t found = find_first(pData + start, count - start);
+                                            if (found == count - start)
+                                            {
+                                                break;
+                                            }
+                                            if constexpr (std::is_same_v<std::invoke_result_t<Func &, size_t>, bool>)
+                                            {
+                                                if (!func(base + start + found))
+                                                {
+                                                    return false;
+                                                }
+                                            }
+                                            else
+                                            {
+                                                func(base + start + found);
+                                            }
+                                            start += found + 1;
+                                        }
+                                        return true;
+                                    });
+        }
+        /**
+         * @brief Find the first match in an editor.
+         * @param editor The editor to search.
+         * @param offset The offset to start searching from.
+         * @return The offset of the match, or std::nullopt if there is none.
+         */
+        std::optional<size_t> find(const binary_editor &editor, const size_t &offset = 0) const
+        {
+            std::optional<size_t> ret;
+            find_all(
+                editor,
+                [&ret](size_t position)
+                {
+                    ret = position;
+                    return false;
+                },
+                offset);
+            return ret;
+        }
+    };
+}
@@ -0,0 +1,382 @@
+#pragma once
+#include "binary_editor.hpp"
+#include "binary_worker_pool.hpp"
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+
+namespace binary
+{
+    namespace detail
+    {
+        /**
+         * @brief Blocking FIFO queue with a fixed capacity, shared between threads.
+         * @tparam T The item type.
+         */
+        template <typename T>
+        class bounded_queue
+        {
+        private:
+            std::mutex              m_mutex;
+            std::condition_variable m_not_empty;
+            std::condition_variable m_not_full;
+            std::deque<T>           m_items;
+            size_t                  m_capacity;
+            bool                    m_closed = false;
+
+        public:
+            /**
+             * @brief Construct a queue.
+             * @param capacity Maximum number of queued items.
+             */
+            explicit bounded_queue(const size_t &capacity)
+                : m_capacity(capacity)
+            {
+            }
+            /**
+             * @brief Push an item, blocking while the queue is full.
+             * @param item The item.
+             * @return False if the queue was closed, in which case the item is dropped.
+             */
+            bool push(T &&item)
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_not_full.wait(lock, [this]
+                                { return m_closed || m_items.size() < m_capacity; });
+                if (m_closed)
+                {
+                    return false;
+                }
+                m_items.push_back(std::move(item));
+                m_not_empty.notify_one();
+                return true;
+            }
+            /**
+             * @brief Pop an item, blocking while the queue is empty and open.
+             * @return The item, or std::nullopt once the queue is closed and drained.
+             */
+            std::optional<T> pop()
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_not_empty.wait(lock, [this]
+                                 { return m_closed || !m_items.empty(); });
+                if (m_items.empty())
+                {
+                    return std::nullopt;
+                }
+                T item = std::move(m_items.front());
+                m_items.pop_front();
+                m_not_full.notify_one();
+                return item;
+            }
+            /**
+             * @brief Close the queue: pushes fail and pops return std::nullopt once drained.
+             */
+            void close()
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_closed = true;
+                m_not_empty.notify_all();
+                m_not_full.notify_all();
+            }
+        };
+    }
+
+    /**
+     * @brief Streams an editor through a chain of chunk-wise stages running on their own threads.
+     *
+     * The input is cut into batches of at most batch_size bytes, taken directly from the chunk data without
+     * copying. Each stage runs on its own thread and owns queue_depth output buffers that are recycled once the
+     * next stage has consumed them (double buffering with the default depth of 2), so memory in flight stays
+     * bounded by stages * queue_depth batches however large the input is. The last stage's output is gathered
+     * into chunks of about batch_size bytes of a new editor.
+     *
+     * @code
+     * binary::binary_pipeline pipeline;
+     * pipeline.add_transform([](std::span<uint8_t> data) { for (auto &b : data) b ^= 0x5A; })
+     *     .add_stage([](std::span<const uint8_t> in, std::vector<uint8_t> &out) { inflate(in, out); })
+     *     .add_stage([&sum](std::span<const uint8_t> in, std::vector<uint8_t> &out)
+     *                { sum = update(sum, in); out.assign(in.begin(), in.end()); });
+     * binary::binary_editor result = pipeline.run(editor);
+     * @endcode
+     */
+    class binary_pipeline
+    {
+    public:
+        /**
+         * @brief Processes one batch; output arrives cleared and may be left empty to drop the batch.
+         */
+        using process_function = std::function<void(std::span<const uint8_t> input, std::vector<uint8_t> &output)>;
+        /**
+         * @brief Emits trailing output after the last batch (flushes, trailers); output arrives cleared.
+         */
+        using finish_function = std::function<void(std::vector<uint8_t> &output)>;
+
+        /**
+         * @brief Default batch size in bytes.
+         */
+        static constexpr size_t DEFAULT_BATCH_SIZE = 256 * 1024;
+        /**
+         * @brief Default number of buffers each stage owns.
+         */
+        static constexpr size_t DEFAULT_QUEUE_DEPTH = 2;
+
+    private:
+        /**
+         * @brief A batch passed between threads; view points into buffer, or into the input editor for the source.
+         */
+        struct batch
+        {
+            std::vector<uint8_t>     buffer;
+            std::span<const uint8_t> view;
+        };
+        /**
+         * @brief One stage of the pipeline.
+         */
+        struct stage
+        {
+            process_function process;
+            finish_function  finish;
+        };
+
+        std::vector<stage> m_stages;      ///< Stages in order
+        size_t             m_batch_size;  ///< Maximum input batch size
+        size_t             m_queue_depth; ///< Buffers per stage
+
+    public:
+        /**
+         * @brief Construct an empty pipeline.
+         * @param batchSize Maximum size of the batches cut from the input.
+         * @param queueDepth Number of buffers each stage owns.
+         * @throws binary_exception if batchSize or queueDepth is 0.
+         */
+        binary_pipeline(const size_t &batchSize = DEFAULT_BATCH_SIZE, const size_t &queueDepth = DEFAULT_QUEUE_DEPTH)
+            : m_batch_size(batchSize), m_queue_depth(queueDepth)
+        {
+            if (batchSize == 0 || queueDepth == 0)
+            {
+                throw binary_exception("binary_pipeline::binary_pipeline err : batchSize and queueDepth must not be 0!");
+            }
+        }
+        /**
+         * @brief Append a stage.
+         * @param process Called for each batch in order.
+         * @param finish Called once after the last batch, may be empty.
+         * @return Reference to self.
+         */
+        binary_pipeline &add_stage(process_function process, finish_function finish = nullptr)
+        {
+            m_stages.push_back({std::move(process), std::move(finish)});
+            return *this;
+        }
+        /**
+         * @brief Append a stage transforming each batch in place, keeping its size.
+         * @param transform Called with a writable copy of each batch.
+         * @return Reference to self.
+         */
+        binary_pipeline &add_transform(std::function<void(std::span<uint8_t> data)> transform)
+        {
+            return add_stage(
+                [transform = std::move(transform)](std::span<const uint8_t> input, std::vector<uint8_t> &output)
+                {
+                    output.assign(input.begin(), input.end());
+                    transform(output);
+                });
+        }
+        /**
+         * @brief Run the pipeline over an editor.
+         * @param input The editor to stream; it must not be modified while running.
+         * @return A new editor holding the output of the last stage.
+         * @throws Rethrows the first exception raised by a stage, after all threads stopped.
+         */
+        binary_editor run(const binary_editor &input) const
+        {
+            if (m_stages.empty())
+            {
+                return input;
+            }
+
+            // queues[i] feeds stage i, queues.back() feeds the sink; pools[i] recycles the buffers of stage i
+            std::vector<std::unique_ptr<detail::bounded_queue<batch>>>                queues;
+            std::vector<std::unique_ptr<detail::bounded_queue<std::vector<uint8_t>>>> pools;
+            for (size_t i = 0; i <= m_stages.size(); ++i)
+            {
+                queues.push_back(std::make_unique<detail::bounded_queue<batch>>(m_queue_depth));
+            }
+            for (size_t i = 0; i < m_stages.size(); ++i)
+            {
+                pools.push_back(std::make_unique<detail::bounded_queue<std::vector<uint8_t>>>(m_queue_depth));
+                for (size_t j = 0; j < m_queue_depth; ++j)
+                {
+                    pools.back()->push(std::vector<uint8_t>());
+                }
+            }
+
+            std::mutex         errorMutex;
+            std::exception_ptr pError;
+            std::atomic<bool>  failed{false};
+            auto               fail = [&](std::exception_ptr pCurrent)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!pError)
+                    {
+                        pError = pCurrent;
+                    }
+                }
+                failed = true;
+                for (auto &pQueue : queues)
+                {
+                    pQueue->close();
+                }
+                for (auto &pPool : pools)
+                {
+                    pPool->close();
+                }
+            };
+
+            std::vector<std::thread> threads;
+            threads.emplace_back(
+                [&]
+                {
+                    try
+                    {
+                        input.for_each_segment(
+                            [&](const uint8_t *pData, const size_t &size)
+                            {
+                                for (size_t offset = 0; offset < size; offset += m_batch_size)
+                                {
+                                    batch item;
+                                    item.view = std::span<const uint8_t>(pData + offset, std::min(m_batch_size, size - offset));
+                                    if (!queues.front()->push(std::move(item)))
+                                    {
+                                        return false;
+                                    }
+                                }
+                                return true;
+                            });
+                        queues.front()->close();
+                    }
+                    catch (...)
+                    {
+                        fail(std::current_exception());
+                    }
+                });
+            for (size_t i = 0; i < m_stages.size(); ++i)
+            {
+                threads.emplace_back([&, i]
+                                     {
+                                         try
+                                         {
+                                             run_stage(i, queues, pools, failed);
+                                         }
+                                         catch (...)
+                                         {
+                                             fail(std::current_exception());
+                                         } });
+            }
+
+            // gather the output into chunks of about m_batch_size bytes
+            binary_editor              ret;
+            std::unique_ptr<uint8_t[]> pBlob;
+            size_t                     blobSize = 0;
+            while (auto item = queues.back()->pop())
+            {
+                for (size_t offset = 0; offset < item->view.size();)
+                {
+                    if (pBlob == nullptr)
+                    {
+                        pBlob    = std::make_unique<uint8_t[]>(m_batch_size);
+                        blobSize = 0;
+                    }
+                    size_t copySize = std::min(m_batch_size - blobSize, item->view.size() - offset);
+                    memcpy(pBlob.get() + blobSize, item->view.data() + offset, copySize);
+                    blobSize += copySize;
+                    offset += copySize;
+                    if (blobSize == m_batch_size)
+                    {
+                        ret.emplace_back(std::unique_ptr<const uint8_t[]>(std::move(pBlob)), blobSize);
+                    }
+                }
+                pools.back()->push(std::move(item->buffer));
+            }
+            if (pBlob != nullptr && blobSize > 0)
+            {
+                ret.emplace_back(std::unique_ptr<const uint8_t[]>(std::move(pBlob)), blobSize);
+            }
+
+            for (auto &thread : threads)
+            {
+                thread.join();
+            }
+            if (pError)
+            {
+                std::rethrow_exception(pError);
+            }
+            return ret;
+        }
+
+    private:
+        /**
+         * @brief Body of the thread running stage i.
+         * @param i The stage index.
+         * @param queues Queues between the stages.
+         * @param pools Buffer pools of the stages.
+         * @param failed Set once any thread failed.
+         */
+        void run_stage(const size_t &i, std::vector<std::unique_ptr<detail::bounded_queue<batch>>> &queues,
+                       std::vector<std::unique_ptr<detail::bounded_queue<std::vector<uint8_t>>>> &pools,
+                       const std::atomic<bool> &failed) const
+        {
+            const stage &current = m_stages[i];
+            auto         send    = [&](std::vector<uint8_t> &&output)
+            {
+                if (output.empty())
+                {
+                    pools[i]->push(std::move(output));
+                    return true;
+                }
+                batch item;
+                item.buffer = std::move(output);
+                item.view   = item.buffer;
+                return queues[i + 1]->push(std::move(item));
+            };
+
+            while (auto item = queues[i]->pop())
+            {
+                auto output = pools[i]->pop();
+                if (failed || !output)
+                {
+                    return;
+                }
+                output->clear();
+                current.process(item->view, *output);
+
+                // hand the input buffer back to the previous stage
+                if (i > 0)
+                {
+                    pools[i - 1]->push(std::move(item->buffer));
+                }
+                if (!send(std::move(*output)))
+                {
+                    return;
+                }
+            }
+
+            if (current.finish && !failed)
+            {
+                auto output = pools[i]->pop();
+                if (!output)
+                {
+                    return;
+                }
+                output->clear();
+                current.finish(*output);
+                send(std::move(*output));
+            }
+            queues[i + 1]->close();
+        }
+    };
+}
@@ -0,0 +1,951 @@
+#pragma once
+#include "binary_editor.hpp"
+#include "binary_search.hpp"
+#include <array>
+#include <bitset>
+#include <map>
+#include <string_view>
+
+namespace binary
+{
+    namespace detail
+    {
+        using byte_set = std::bitset<256>;
+
+        /**
+         * @brief Node of a parsed regex.
+         */
+        struct regex_node
+        {
+            enum class TYPE
+            {
+                BYTES,  ///< One byte out of a set
+                CONCAT, ///< Children in sequence
+                ALTER,  ///< One of the children
+                REPEAT  ///< The child repeated min to max times
+            };
+            static constexpr size_t UNBOUNDED = SIZE_MAX;
+
+            TYPE                    type = TYPE::BYTES;
+            byte_set                bytes{};
+            std::vector<regex_node> children{};
+            size_t                  min = 0;
+            size_t                  max = 0;
+        };
+
+        /**
+         * @brief Recursive descent parser of the byte regex syntax described at binary_regex.
+         */
+        class regex_parser
+        {
+        private:
+            std::string_view m_pattern;
+            size_t           m_pos = 0;
+
+            [[noreturn]] void fail(const char *message) const
+            {
+                throw binary_exception(std::string("binary_regex err : ") + message + " at position " + std::to_string(m_pos) + "!");
+            }
+            bool at_end() const
+            {
+                return m_pos >= m_pattern.size();
+            }
+            char peek() const
+            {
+                return m_pattern[m_pos];
+            }
+            uint8_t parse_hex_digit()
+            {
+                if (at_end())
+                {
+                    fail("incomplete \\x escape");
+                }
+                char c = m_pattern[m_pos++];
+                if (c >= '0' && c <= '9')
+                {
+                    return static_cast<uint8_t>(c - '0');
+                }
+                if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f')
+                {
+                    return static_cast<uint8_t>((c | 0x20) - 'a' + 10);
+                }
+                fail("invalid hex digit");
+            }
+            /**
+             * @brief Parse the escape after a backslash into a byte set.
+             */
+            byte_set parse_escape()
+            {
+                if (at_end())
+                {
+                    fail("trailing backslash");
+                }
+                char     c = m_pattern[m_pos++];
+                byte_set ret;
+                auto     addRange = [&ret](int first, int last)
+                {
+                    for (int i = first; i <= last; ++i)
+                    {
+                        ret.set(i);
+                    }
+                };
+                switch (c)
+                {
+                case 'x':
+                {
+                    uint8_t high = parse_hex_digit();
+                    ret.set((high << 4) | parse_hex_digit());
+                    return ret;
+                }
+                case 'n':
+                    ret.set('\n');
+                    return ret;
+                case 'r':
+                    ret.set('\r');
+                    return ret;
+                case 't':
+                    ret.set('\t');
+                    return ret;
+                case '0':
+                    ret.set(0);
+                    return ret;
+                case 'd':
+                case 'D':
+                    addRange('0', '9');
+                    break;
+                case 'w':
+                case 'W':
+                    addRange('0', '9');
+                    addRange('a', 'z');
+                    addRange('A', 'Z');
+                    ret.set('_');
+                    break;
+                case 's':
+                case 'S':
+                    for (char space : {' ', '\t', '\n', '\r', '\v', '\f'})
+                    {
+                        ret.set(static_cast<uint8_t>(space));
+                    }
+                    break;
+                default:
+                    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '1' && c <= '9'))
+                    {
+                        fail("unknown escape");
+                    }
+                    ret.set(static_cast<uint8_t>(c));
+                    return ret;
+                }
+                return (c >= 'A' && c <= 'Z') ? ~ret : ret;
+            }
+            /**
+             * @brief Parse a bracket class after the opening bracket.
+             */
+            byte_set parse_class()
+            {
+                byte_set ret;
+                bool     negate = !at_end() && peek() == '^';
+                if (negate)
+                {
+                    ++m_pos;
+                }
+                bool first = true;
+                while (true)
+                {
+                    if (at_end())
+                    {
+                        fail("missing ]");
+                    }
+                    if (peek() == ']' && !first)
+                    {
+                        ++m_pos;
+                        break;
+                    }
+                    first = false;
+                    byte_set item;
+                    if (peek() == '\\')
+                    {
+                        ++m_pos;
+                        item = parse_escape();
+                    }
+                    else
+                    {
+                        item.set(static_cast<uint8_t>(m_pattern[m_pos++]));
+                    }
+                    // A range needs single bytes on both sides.
+                    if (item.count() == 1 && m_pos + 1 < m_pattern.size() && peek() == '-' && m_pattern[m_pos + 1] != ']')
+                    {
+                        ++m_pos;
+                        byte_set last;
+                        if (peek() == '\\')
+                        {
+                            ++m_pos;
+                            last = parse_escape();
+                        }
+                        else
+                        {
+                            last.set(static_cast<uint8_t>(m_pattern[m_pos++]));
+                        }
+                        if (last.count() != 1)
+                        {
+                            fail("invalid range");
+                        }
+                        size_t from = 0, to = 0;
+                        while (!item.test(from))
+                        {
+                            ++from;
+                        }
+                        while (!last.test(to))
+                        {
+                            ++to;
+                        }
+                        if (from > to)
+                        {
+                            fail("invalid range");
+                        }
+                        for (size_t i = from; i <= to; ++i)
+                        {
+                            item.set(i);
+                        }
+                    }
+                    ret |= item;
+                }
+                return negate ? ~ret : ret;
+            }
+            size_t parse_number()
+            {
+                size_t value  = 0;
+                size_t digits = 0;
+                while (!at_end() && peek() >= '0' && peek() <= '9')
+                {
+                    value = value * 10 + (m_pattern[m_pos++] - '0');
+                    if (++digits > 6)
+                    {
+                        fail("repeat count too large");
+                    }
+                }
+                if (digits == 0)
+                {
+                    fail("expected a number");
+                }
+                return value;
+            }
+            regex_node parse_atom()
+            {
+                char       c = m_pattern[m_pos++];
+                regex_node ret{regex_node::TYPE::BYTES};
+                switch (c)
+                {
+                case '(':
+                    if (m_pattern.substr(m_pos, 2) == "?:")
+                    {
+                        m_pos += 2;
+                    }
+                    ret = parse_alternation();
+                    if (at_end() || peek() != ')')
+                    {
+                        fail("missing )");
+                    }
+                    ++m_pos;
+                    return ret;
+                case '[':
+                    ret.bytes = parse_class();
+                    return ret;
+                case '.':
+                    ret.bytes.set();
+                    return ret;
+                case '\\':
+                    ret.bytes = parse_escape();
+                    return ret;
+                case '*':
+                case '+':
+                case '?':
+                case '{':
+                    --m_pos;
+                    fail("nothing to repeat");
+                case ')':
+                    --m_pos;
+                    fail("unmatched )");
+                default:
+                    ret.bytes.set(static_cast<uint8_t>(c));
+                    return ret;
+                }
+            }
+            regex_node parse_repeat()
+            {
+                regex_node ret = parse_atom();
+                while (!at_end())
+                {
+                    size_t min, max;
+                    char   c = peek();
+                    if (c == '*' || c == '+' || c == '?')
+                    {
+                        ++m_pos;
+                        min = c == '+' ? 1 : 0;
+                        max = c == '?' ? 1 : regex_node::UNBOUNDED;
+                    }
+                    else if (c == '{')
+                    {
+                        ++m_pos;
+                        min = max = parse_number();
+                        if (!at_end() && peek() == ',')
+                        {
+                            ++m_pos;
+                            max = (!at_end() && peek() == '}') ? regex_node::UNBOUNDED : parse_number();
+                        }
+                        if (at_end() || peek() != '}')
+                        {
+                            fail("missing }");
+                        }
+                        ++m_pos;
+                        if (min > max)
+                        {
+                            fail("invalid repeat range");
+                        }
+                    }
+                    else
+                    {
+                        break;
+                    }
+                    regex_node repeat{regex_node::TYPE::REPEAT};
+                    repeat.min = min;
+                    repeat.max = max;
+                    repeat.children.push_back(std::move(ret));
+                    ret = std::move(repeat);
+                }
+                return ret;
+            }
+            regex_node parse_concatenation()
+            {
+                regex_node ret{regex_node::TYPE::CONCAT};
+                while (!at_end() && peek() != '|' && peek() != ')')
+                {
+                    ret.children.push_back(parse_repeat());
+                }
+                return ret;
+            }
+            regex_node parse_alternation()
+            {
+                regex_node ret{regex_node::TYPE::ALTER};
+                ret.children.push_back(parse_concatenation());
+                while (!at_end() && peek() == '|')
+                {
+                    ++m_pos;
+                    ret.children.push_back(parse_concatenation());
+                }
+                return ret.children.size() == 1 ? std::move(ret.children[0]) : ret;
+            }
+
+        public:
+            explicit regex_parser(std::string_view pattern) : m_pattern(pattern)
+            {
+            }
+            regex_node parse()
+            {
+                regex_node ret = parse_alternation();
+                if (!at_end())
+                {
+                    fail("unmatched )");
+                }
+                return ret;
+            }
+        };
+
+        /**
+         * @brief Thompson NFA of a regex, shared read-only by its matchers.
+         */
+        struct regex_program
+        {
+            static constexpr uint32_t NONE          = UINT32_MAX;
+            static constexpr size_t   MAX_NFA_STATE = 1 << 20;
+
+            /**
+             * @brief NFA state: consumes a byte of a set, or splits, or accepts.
+             */
+            struct nfa_state
+            {
+                enum class TYPE
+                {
+                    BYTES,
+                    SPLIT,
+                    MATCH
+                };
+                TYPE     type;
+                uint32_t bytes = NONE; ///< Index into byte_sets for BYTES
+                uint32_t out   = NONE;
+                uint32_t out1  = NONE;
+            };
+
+            std::vector<nfa_state> states;
+            std::vector<byte_set>  byte_sets;
+            uint32_t               start = NONE;
+            byte_set               first_bytes;    ///< Bytes that can begin a match
+            std::vector<uint8_t>   literal_prefix; ///< Bytes every match begins with
+
+            /**
+             * @brief Partially built NFA fragment with dangling exits.
+             */
+            struct fragment
+            {
+                uint32_t              start;
+                std::vector<uint32_t> exits; ///< States whose out (or out1 if flagged) is dangling, encoded as index * 2 + which
+            };
+
+            uint32_t add_state(const nfa_state &state)
+            {
+                if (states.size() >= MAX_NFA_STATE)
+                {
+                    throw binary_exception("binary_regex err : pattern is too large!");
+                }
+                states.push_back(state);
+                return static_cast<uint32_t>(states.size() - 1);
+            }
+            void patch(const std::vector<uint32_t> &exits, const uint32_t &target)
+            {
+                for (const auto &exit : exits)
+                {
+                    (exit & 1 ? states[exit >> 1].out1 : states[exit >> 1].out) = target;
+                }
+            }
+            /**
+             * @brief Fragment matching the empty string: a split whose both exits lead on.
+             */
+            fragment empty()
+            {
+                uint32_t state = add_state({nfa_state::TYPE::SPLIT});
+                return {state, {state * 2, state * 2 + 1}};
+            }
+            fragment compile(const regex_node &node)
+            {
+                switch (node.type)
+                {
+                case regex_node::TYPE::BYTES:
+                {
+                    byte_sets.push_back(node.bytes);
+                    nfa_state state{nfa_state::TYPE::BYTES};
+                    state.bytes    = static_cast<uint32_t>(byte_sets.size() - 1);
+                    uint32_t index = add_state(state);
+                    return {index, {index * 2}};
+                }
+                case regex_node::TYPE::CONCAT:
+                {
+                    if (node.children.empty())
+                    {
+                        return empty();
+                    }
+                    fragment ret = compile(node.children[0]);
+                    for (size_t i = 1; i < node.children.size(); ++i)
+                    {
+                        fragment next = compile(node.children[i]);
+                        patch(ret.exits, next.start);
+                        ret.exits = std::move(next.exits);
+                    }
+                    return ret;
+                }
+                case regex_node::TYPE::ALTER:
+                {
+                    fragment ret = compile(node.children[0]);
+                    for (size_t i = 1; i < node.children.size(); ++i)
+                    {
+                        fragment  next = compile(node.children[i]);
+                        nfa_state split{nfa_state::TYPE::SPLIT};
+                        split.out  = ret.start;
+                        split.out1 = next.start;
+                        ret.start  = add_state(split);
+                        ret.exits.insert(ret.exits.end(), next.exits.begin(), next.exits.end());
+                    }
+                    return ret;
+                }
+                case regex_node::TYPE::REPEAT:
+                default:
+                {
+                    const regex_node &child = node.children[0];
+                    fragment          ret   = empty();
+                    // Mandatory copies.
+                    for (size_t i = 0; i < node.min; ++i)
+                    {
+                        fragment next = compile(child);
+                        patch(ret.exits, next.start);
+                        ret.exits = std::move(next.exits);
+                    }
+                    if (node.max == regex_node::UNBOUNDED)
+                    {
+                        // A loop: split into the child or on, with the child leading back to the split.
+                        fragment  loop = compile(child);
+                        nfa_state split{nfa_state::TYPE::SPLIT};
+                        split.out      = loop.start;
+                        uint32_t index = add_state(split);
+                        patch(loop.exits, index);
+                        patch(ret.exits, index);
+                        ret.exits = {index * 2 + 1};
+                    }
+                    else
+                    {
+                        // Optional copies, each one skippable.
+                        std::vector<uint32_t> skipped;
+                        for (size_t i = node.min; i < node.max; ++i)
+                        {
+                            fragment  next = compile(child);
+                            nfa_state split{nfa_state::TYPE::SPLIT};
+                            split.out      = next.start;
+                            uint32_t index = add_state(split);
+                            patch(ret.exits, index);
+                            skipped.push_back(index * 2 + 1);
+                            ret.exits = std::move(next.exits);
+                        }
+                        ret.exits.insert(ret.exits.end(), skipped.begin(), skipped.end());
+                    }
+                    return ret;
+                }
+                }
+            }
+            /**
+             * @brief Add the epsilon closure of a state to a set.
+             * @param state The state.
+             * @param marks Marks of visited states, equal to mark when visited.
+             * @param mark The current mark.
+             * @param set Receives the BYTES and MATCH states reached.
+             */
+            void add_closure(const uint32_t &state, std::vector<uint32_t> &marks, const uint32_t &mark, std::vector<uint32_t> &set) const
+            {
+                std::vector<uint32_t> stack = {state};
+                while (!stack.empty())
+                {
+                    uint32_t current = stack.back();
+                    stack.pop_back();
+                    if (current == NONE || marks[current] == mark)
+                    {
+                        continue;
+                    }
+                    marks[current] = mark;
+                    if (states[current].type == nfa_state::TYPE::SPLIT)
+                    {
+                        stack.push_back(states[current].out1);
+                        stack.push_back(states[current].out);
+                    }
+                    else
+                    {
+                        set.push_back(current);
+                    }
+                }
+            }
+            /**
+             * @brief Collect the leading single bytes every match starts with.
+             */
+            static void collect_prefix(const regex_node &node, std::vector<uint8_t> &prefix, bool &complete)
+            {
+                if (!complete)
+                {
+                    return;
+                }
+                if (node.type == regex_node::TYPE::BYTES && node.bytes.count() == 1)
+                {
+                    size_t value = 0;
+                    while (!node.bytes.test(value))
+                    {
+                        ++value;
+                    }
+                    prefix.push_back(static_cast<uint8_t>(value));
+                }
+                else if (node.type == regex_node::TYPE::CONCAT)
+                {
+                    for (const auto &child : node.children)
+                    {
+                        collect_prefix(child, prefix, complete);
+                    }
+                }
+                else if (node.type == regex_node::TYPE::REPEAT && node.min > 0 && node.min == node.max)
+                {
+                    for (size_t i = 0; i < node.min; ++i)
+                    {
+                        collect_prefix(node.children[0], prefix, complete);
+                    }
+                }
+                else
+                {
+                    complete = false;
+                }
+            }
+
+            explicit regex_program(std::string_view pattern)
+            {
+                regex_node root = regex_parser(pattern).parse();
+                fragment   body = compile(root);
+                uint32_t   done = add_state({nfa_state::TYPE::MATCH});
+                patch(body.exits, done);
+                start = body.start;
+
+                std::vector<uint32_t> marks(states.size(), NONE);
+                std::vector<uint32_t> set;
+                add_closure(start, marks, 0, set);
+                for (const auto &state : set)
+                {
+                    if (states[state].type == nfa_state::TYPE::MATCH)
+                    {
+                        throw binary_exception("binary_regex err : pattern must not match the empty string!");
+                    }
+                    first_bytes |= byte_sets[states[state].bytes];
+                }
+                bool complete = true;
+                collect_prefix(root, literal_prefix, complete);
+            }
+        };
+    }
+
+    /**
+     * @brief A compiled byte-oriented regular expression.
+     *
+     * Patterns work on bytes, not characters. Supported syntax:
+     * - literal bytes, `.` (any byte), `\xHH`, `\n`, `\r`, `\t`, `\0` and escaped metacharacters such as `\.`;
+     * - classes `[a-f\x00-\x1F]`, negated classes `[^...]` and `\d \w \s` with their negations `\D \W \S`;
+     * - groups `(...)` or `(?:...)`, alternation `|`;
+     * - repeats `*`, `+`, `?`, `{n}`, `{n,}` and `{n,m}`.
+     *
+     * Matching is unanchored and reports the end offset of every match, so it runs in one forward pass
+     * with constant state. Patterns matching the empty string are rejected.
+     *
+     * The object is immutable and may be shared by threads; the lazily built DFA lives in each
+     * binary_regex_matcher.
+     *
+     * @code
+     * binary::binary_regex call("\\xE8.{4}\\x48\\x8B");
+     * for (size_t end : call.find_all(editor))
+     * {
+     *     // a match ends at end
+     * }
+     * @endcode
+     */
+    class binary_regex
+    {
+    private:
+        std::shared_ptr<const detail::regex_program> m_pProgram;
+
+        friend class binary_regex_matcher;
+
+    public:
+        /**
+         * @brief Compile a pattern.
+         * @param pattern The pattern.
+         * @throws binary_exception if the pattern is invalid or matches the empty string.
+         */
+        explicit binary_regex(std::string_view pattern) : m_pProgram(std::make_shared<detail::regex_program>(pattern))
+        {
+        }
+        /**
+         * @brief Get the bytes every match begins with, used to skip ahead with a literal search.
+         * @return The literal prefix, possibly empty.
+         */
+        const std::vector<uint8_t> &literal_prefix() const
+        {
+            return m_pProgram->literal_prefix;
+        }
+        /**
+         * @brief Report every match in an editor.
+         * @tparam Func Callable as func(size_t endOffset); may return bool, false stops the scan.
+         * @param editor The editor to scan.
+         * @param func Called with the end offset of each match, in increasing order.
+         */
+        template <typename Func>
+        void scan(const binary_editor &editor, Func &&func) const;
+        /**
+         * @brief Find the end offsets of all matches in an editor.
+         * @param editor The editor to scan.
+         * @return The end offsets in increasing order.
+         */
+        std::vector<size_t> find_all(const binary_editor &editor) const
+        {
+            std::vector<size_t> ret;
+            scan(editor, [&ret](size_t end) { ret.push_back(end); });
+            return ret;
+        }
+    };
+
+    /**
+     * @brief Streaming matcher of a binary_regex, determinizing its NFA lazily.
+     *
+     * DFA states are created on first use and cached up to a memory limit; when the cache is full it is
+     * flushed and rebuilt on demand, so memory stays bounded for any pattern. The matcher carries its
+     * state across feed() calls, so matches spanning chunks or buffers are found. While no match is in
+     * progress, it skips to the next candidate with a SIMD literal or first-byte search.
+     *
+     * A matcher is used by one thread at a time.
+     */
+    class binary_regex_matcher
+    {
+    public:
+        /**
+         * @brief Default memory limit of the DFA cache in bytes.
+         */
+        static constexpr size_t DEFAULT_MEMORY_LIMIT = 8 * 1024 * 1024;
+
+    private:
+        static constexpr int32_t UNKNOWN = -1;
+        static constexpr int32_t START   = 0;
+
+        /**
+         * @brief Lazily built DFA state: a set of NFA states and its known transitions.
+         */
+        struct dfa_state
+        {
+            std::vector<uint32_t>    nfa_states;
+            bool                     accepting;
+            std::array<int32_t, 256> next;
+        };
+
+        std::shared_ptr<const detail::regex_program> m_pProgram;
+        size_t                                       m_memory_limit;
+        size_t                                       m_memory_used = 0;
+        size_t                                       m_flush_count = 0;
+        std::vector<dfa_state>                       m_states;
+        std::map<std::vector<uint32_t>, int32_t>     m_state_index;
+        std::vector<uint32_t>                        m_start_set;
+        std::vector<uint32_t>                        m_marks;
+        uint32_t                                     m_mark   = 0;
+        int32_t                                      m_state  = START;
+        size_t                                       m_offset = 0;
+        uint8_t                                      m_first_bytes[3];
+        size_t                                       m_first_byte_count = 0;
+        std::array<uint64_t, 4>                      m_first_byte_mask{}; ///< first_bytes as chunk_summary words
+
+        /**
+         * @brief Get the index of the DFA state of a sorted NFA state set, creating it if needed.
+         */
+        int32_t intern(std::vector<uint32_t> &&set)
+        {
+            auto iter = m_state_index.find(set);
+            if (iter != m_state_index.end())
+            {
+                return iter->second;
+            }
+            size_t cost = sizeof(dfa_state) + 2 * set.size() * sizeof(uint32_t) + 64;
+            if (m_memory_used + cost > m_memory_limit && m_states.size() > 1)
+            {
+                flush();
+                iter = m_state_index.find(set);
+                if (iter != m_state_index.end())
+                {
+                    return iter->second;
+                }
+            }
+            dfa_state state;
+            state.accepting = false;
+            for (const auto &nfaState : set)
+            {
+                state.accepting |= m_pProgram->states[nfaState].type == detail::regex_program::nfa_state::TYPE::MATCH;
+            }
+            state.next.fill(UNKNOWN);
+            state.nfa_states = set;
+            m_states.push_back(std::move(state));
+            m_state_index.emplace(std::move(set), static_cast<int32_t>(m_states.size() - 1));
+            m_memory_used += cost;
+            return static_cast<int32_t>(m_states.size() - 1);
+        }
+        /**
+         * @brief Drop all DFA states except the start state.
+         */
+        void flush()
+        {
+            ++m_flush_count;
+            m_states.clear();
+            m_state_index.clear();
+            m_memory_used = 0;
+            intern(std::vector<uint32_t>(m_start_set));
+        }
+        /**
+         * @brief Compute a transition, caching it unless the cache was flushed meanwhile.
+         */
+        int32_t compute_next(const int32_t &state, const uint8_t &value)
+        {
+            const auto &program = *m_pProgram;
+            if (++m_mark == detail::regex_program::NONE)
+            {
+                std::fill(m_marks.begin(), m_marks.end(), detail::regex_program::NONE);
+                m_mark = 0;
+            }
+            std::vector<uint32_t> set;
+            for (const auto &nfaState : m_states[state].nfa_states)
+            {
+                const auto &current = program.states[nfaState];
+                if (current.type == detail::regex_program::nfa_state::TYPE::BYTES && program.byte_sets[current.bytes].test(value))
+                {
+                    program.add_closure(current.out, m_marks, m_mark, set);
+                }
+            }
+            // Unanchored: a new match may start at every position.
+            program.add_closure(program.start, m_marks, m_mark, set);
+            std::sort(set.begin(), set.end());
+
+            size_t  flushCount = m_flush_count;
+            int32_t ret        = intern(std::move(set));
+            if (flushCount == m_flush_count)
+            {
+                m_states[state].next[value] = ret;
+            }
+            return ret;
+        }
+
+    public:
+        /**
+         * @brief Construct a matcher.
+         * @param regex The regex to match.
+         * @param memoryLimit Memory limit of the DFA cache in bytes.
+         */
+        explicit binary_regex_matcher(const binary_regex &regex, const size_t &memoryLimit = DEFAULT_MEMORY_LIMIT)
+            : m_pProgram(regex.m_pProgram), m_memory_limit(memoryLimit), m_marks(m_pProgram->states.size(), detail::regex_program::NONE)
+        {
+            m_pProgram->add_closure(m_pProgram->start, m_marks, m_mark, m_start_set);
+            std::sort(m_start_set.begin(), m_start_set.end());
+            intern(std::vector<uint32_t>(m_start_set));
+            for (size_t i = 0; i < 256; ++i)
+            {
+                m_first_byte_mask[i >> 6] |= static_cast<uint64_t>(m_pProgram->first_bytes.test(i)) << (i & 63);
+            }
+            if (m_pProgram->first_bytes.count() <= 3)
+            {
+                for (size_t i = 0; i < 256; ++i)
+                {
+                    if (m_pProgram->first_bytes.test(i))
+                    {
+                        m_first_bytes[m_first_byte_count++] = static_cast<uint8_t>(i);
+                    }
+                }
+            }
+        }
+        /**
+         * @brief Feed the next bytes of the stream.
+         * @tparam Func Callable as func(size_t endOffset); may return bool, false stops.
+         * @param pData The bytes.
+         * @param size The number of bytes.
+         * @param func Called with the stream offset just past each match.
+         * @return False if func stopped the scan.
+         */
+        template <typename Func>
+        bool feed(const uint8_t *pData, const size_t &size, Func &&func)
+        {
+            const auto &prefix = m_pProgram->literal_prefix;
+            size_t      i      = 0;
+            while (i < size)
+            {
+                if (m_state == START)
+                {
+                    // Nothing in progress: skip to the next position a match can start at.
+                    size_t skip = i;
+                    if (prefix.size() > 1)
+                    {
+                        size_t found = detail::find_literal(pData + i, size - i, prefix.data(), prefix.size());
+                        // A prefix cut by the end of the buffer is left to the DFA.
+                        skip = found != size - i ? i + found : std::max(i, size - std::min(size, prefix.size() - 1));
+                    }
+                    else if (m_first_byte_count > 0)
+                    {
+                        skip = i + detail::find_first_of(pData + i, size - i, m_first_bytes, m_first_byte_count);
+                    }
+                    m_offset += skip - i;
+                    i = skip;
+                    if (i == size)
+                    {
+                        break;
+                    }
+                }
+                int32_t next = m_states[m_state].next[pData[i]];
+                m_state      = next != UNKNOWN ? next : compute_next(m_state, pData[i]);
+                ++i;
+                ++m_offset;
+                if (m_states[m_state].accepting)
+                {
+                    if constexpr (std::is_same_v<std::invoke_result_t<Func, size_t>, bool>)
+                    {
+                        if (!func(m_offset))
+                        {
+                            return false;
+                        }
+                    }
+                    else
+                    {
+                        func(m_offset);
+                    }
+                }
+            }
+            return true;
+        }
+        /**
+         * @brief Feed all segments of an editor.
+         *
+         * While no match is in progress, a chunk of at least chunk_summary::MIN_CHUNK_SIZE bytes is checked
+         * against its summary: if none of its bytes can start a match it is skipped whole, and if it cannot
+         * hold the literal prefix only its last prefix size - 1 bytes are fed. The summary is computed only for
+         * segments covering their whole chunk; partial segments use it only if it is already cached.
+         *
+         * @tparam Func Callable as func(size_t endOffset); may return bool, false stops.
+         * @param editor The editor.
+         * @param func Called with the stream offset just past each match.
+         * @return False if func stopped the scan.
+         */
+        template <typename Func>
+        bool feed(const binary_editor &editor, Func &&func)
+        {
+            const auto &prefix = m_pProgram->literal_prefix;
+            bool        ret    = true;
+            editor.for_each_chunk_segment(0, editor.size(),
+                                          [&](const binary_chunk_interface &chunk, const uint8_t *pData, const size_t &size)
+                                          {
+                                              size_t skip = 0;
+                                              auto pSummary = m_state == START && chunk.size() >= chunk_summary::MIN_CHUNK_SIZE
+                                                                  ? chunk.try_summary(size == chunk.size())
+                                                                  : nullptr;
+                                              if (pSummary != nullptr)
+                                              {
+                                                  if (!pSummary->contains_any(m_first_byte_mask))
+                                                  {
+                                                      skip = size;
+                                                  }
+                                                  else if (prefix.size() > 1 && !pSummary->may_contain(prefix))
+                                                  {
+                                                      skip = size - std::min(size, prefix.size() - 1);
+                                                  }
+                                              }
+                                              m_offset += skip;
+                                              return ret = feed(pData + skip, size - skip, func);
+                                          });
+            return ret;
+        }
+        /**
+         * @brief Start a new stream at offset 0, keeping the cached DFA states.
+         */
+        void reset()
+        {
+            m_state  = START;
+            m_offset = 0;
+        }
+        /**
+         * @brief Get the number of bytes fed since construction or reset().
+         * @return The stream offset.
+         */
+        size_t offset() const
+        {
+            return m_offset;
+        }
+        /**
+         * @brief Get the number of cached DFA states.
+         * @return The number of states.
+         */
+        size_t state_count() const
+        {
+            return m_states.size();
+        }
+        /**
+         * @brief Get how many times the DFA cache hit the memory limit and was flushed.
+         * @return The flush count.
+         */
+        size_t flush_count() const
+        {
+            return m_flush_count;
+        }
+    };
+
+    template <typename Func>
+    void binary_regex::scan(const binary_editor &editor, Func &&func) const
+    {
+        binary_regex_matcher matcher(*this);
+        matcher.feed(editor, std::forward<Func>(func));
+    }
+}
@@ -0,0 +1,416 @@
+#pragma once
+#include "binary_editor.hpp"
+#include "binary_worker_pool.hpp"
+#include <bit>
+
+namespace binary
+{
+    namespace detail
+    {
+        /**
+         * @brief Find the first byte of a buffer that equals one of up to three values.
+         * @param pData The buffer.
+         * @param size The size of the buffer.
+         * @param pValues The values.
+         * @param valueCount The number of values, 1 to 3.
+         * @return The index of the byte, or size if none.
+         */
+        inline size_t find_first_of(const uint8_t *pData, const size_t &size, const uint8_t *pValues, const size_t &valueCount)
+        {
+            size_t i = 0;
+#if defined(BINARY_EDITOR_SSE2)
+            const __m128i first  = _mm_set1_epi8(static_cast<char>(pValues[0]));
+            const __m128i second = _mm_set1_epi8(static_cast<char>(pValues[valueCount > 1 ? 1 : 0]));
+            const __m128i third  = _mm_set1_epi8(static_cast<char>(pValues[valueCount > 2 ? 2 : 0]));
+            for (; i + 16 <= size; i += 16)
+            {
+                __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pData + i));
+                __m128i found = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, first), _mm_cmpeq_epi8(bytes, second)), _mm_cmpeq_epi8(bytes, third));
+                int     mask  = _mm_movemask_epi8(found);
+                if (mask != 0)
+                {
+                    return i + std::countr_zero(static_cast<uint32_t>(mask));
+                }
+            }
+#endif
+            for (; i < size; ++i)
+            {
+                for (size_t j = 0; j < valueCount; ++j)
+                {
+                    if (pData[i] == pValues[j])
+                    {
+                        return i;
+                    }
+                }
+            }
+            return size;
+        }
+
+        /**
+         * @brief Find the first occurrence of a needle in a buffer.
+         *
+         * Candidates are filtered 16 positions at a time by comparing both the first and the last byte
+         * of the needle, and only positions passing both are compared in full.
+         *
+         * @param pData The buffer.
+         * @param size The size of the buffer.
+         * @param pNeedle The needle.
+         * @param needleSize The size of the needle, at least 1.
+         * @return The index of the occurrence, or size if none.
+         */
+        inline size_t find_literal(const uint8_t *pData, const size_t &size, const uint8_t *pNeedle, const size_t &needleSize)
+        {
+            if (needleSize > size)
+            {
+                return size;
+            }
+            if (needleSize == 1)
+            {
+                return find_first_of(pData, size, pNeedle, 1);
+            }
+            size_t last = size - needleSize; // last candidate position
+            size_t i    = 0;
+#if defined(BINARY_EDITOR_SSE2)
+            const __m128i first = _mm_set1_epi8(static_cast<char>(pNeedle[0]));
+            const __m128i tail  = _mm_set1_epi8(static_cast<char>(pNeedle[needleSize - 1]));
+            for (; i + 16 <= last + 1; i += 16)
+            {
+                __m128i  head  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pData + i));
+                __m128i  end   = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pData + i + needleSize - 1));
+                uint32_t mask  = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(head, first), _mm_cmpeq_epi8(end, tail))));
+                while (mask != 0)
+                {
+                    size_t candidate = i + std::countr_zero(mask);
+                    if (memcmp(pData + candidate + 1, pNeedle + 1, needleSize - 2) == 0)
+                    {
+                        return candidate;
+                    }
+                    mask &= mask - 1;
+                }
+            }
+#endif
+            for (; i <= last; ++i)
+            {
+                if (pData[i] == pNeedle[0] && memcmp(pData + i + 1, pNeedle + 1, needleSize - 1) == 0)
+                {
+                    return i;
+                }
+            }
+            return size;
+        }
+
+        /**
+         * @brief Call a function on contiguous buffers covering every window of a given size that starts in a range.
+         *
+         * Windows inside one segment are handed over in place; windows spanning segments are handed over
+         * from a small bridge buffer of at most 2 * (window - 1) bytes, so the editor is never flattened.
+         *
+         * @param editor The editor.
+         * @param first First window start.
+         * @param last One past the last window start.
+         * @param window The window size, at least 1.
+         * @param func Called as func(const uint8_t *pData, size_t count, size_t base) for the count windows
+         *             starting at pData[0] to pData[count - 1], whose offsets start at base; may return bool,
+         *             false stops the walk.
+         */
+        template <typename Func>
+        void for_each_window(const binary_editor &editor, const size_t &first, const size_t &last, const size_t &window, Func &&func)
+        {
+            if (window > editor.size() || first > editor.size() - window)
+            {
+                return;
+            }
+            size_t               lastStart = std::min(last, editor.size() - window + 1);
+            size_t               scanEnd   = lastStart + window - 1;
+            size_t               base      = first;
+            std::vector<uint8_t> tail;
+            std::vector<uint8_t> bridge;
+            auto                 call = [&func](const uint8_t *pData, const size_t &count, const size_t &offset)
+            {
+                if constexpr (std::is_same_v<std::invoke_result_t<Func &, const uint8_t *, size_t, size_t>, bool>)
+                {
+                    return func(pData, count, offset);
+                }
+                else
+                {
+                    func(pData, count, offset);
+                    return true;
+                }
+            };
+            editor.for_each_segment(first, scanEnd - first,
+                                    [&](const uint8_t *pData, const size_t &size)
+                                    {
+                                        if (!tail.empty())
+                                        {
+                                            // Windows starting in the tail and ending in this segment.
+                                            size_t head = std::min(size, window - 1);
+                                            bridge.assign(tail.begin(), tail.end());
+                                            bridge.insert(bridge.end(), pData, pData + head);
+                                            if (bridge.size() >= window && !call(bridge.data(), std::min(bridge.size() - window + 1, tail.size()), base - tail.size()))
+                                            {
+                                                return false;
+                                            }
+                                        }
+                                        if (size >= window && !call(pData, size - window + 1, base))
+                                        {
+                                            return false;
+                                        }
+                                        tail.insert(tail.end(), pData + size - std::min(size, window - 1), pData + size);
+                                        if (tail.size() > window - 1)
+                                        {
+                                            tail.erase(tail.begin(), tail.end() - (window - 1));
+                                        }
+                                        base += size;
+                                        return true;
+                                    });
+        }
+
+        /**
+         * @brief Find the last occurrence of a needle in a buffer.
+         *
+         * The mirror of find_literal(): 16 candidate positions at a time are filtered by the first and the last
+         * byte of the needle, walking from the end of the buffer.
+         *
+         * @param pData The buffer.
+         * @param size The size of the buffer.
+         * @param pNeedle The needle.
+         * @param needleSize The size of the needle, at least 1.
+         * @return The index of the occurrence, or size if none.
+         */
+        inline size_t rfind_literal(const uint8_t *pData, const size_t &size, const uint8_t *pNeedle, const size_t &needleSize)
+        {
+            if (needleSize > size)
+            {
+                return size;
+            }
+            size_t middleSize = needleSize > 2 ? needleSize - 2 : 0;
+            size_t end        = size - needleSize + 1; // one past the last candidate position
+#if defined(BINARY_EDITOR_SSE2)
+            const __m128i first = _mm_set1_epi8(static_cast<char>(pNeedle[0]));
+            const __m128i tail  = _mm_set1_epi8(static_cast<char>(pNeedle[needleSize - 1]));
+            for (; end >= 16; end -= 16)
+            {
+                __m128i  head = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pData + end - 16));
+                __m128i  last = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pData + end - 16 + needleSize - 1));
+                uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(head, first), _mm_cmpeq_epi8(last, tail))));
+                while (mask != 0)
+                {
+                    size_t bit       = 31 - std::countl_zero(mask);
+                    size_t candidate = end - 16 + bit;
+                    if (memcmp(pData + candidate + 1, pNeedle + 1, middleSize) == 0)
+                    {
+                        return candidate;
+                    }
+                    mask &= ~(1u << bit);
+                }
+            }
+#endif
+            while (end-- > 0)
+            {
+                if (pData[end] == pNeedle[0] && memcmp(pData + end + 1, pNeedle + 1, needleSize - 1) == 0)
+                {
+                    return end;
+                }
+            }
+            return size;
+        }
+    }
+
+    /**
+     * @brief Report every occurrence of a needle in an editor, including occurrences spanning chunks.
+     *
+     * Chunks of at least chunk_summary::MIN_CHUNK_SIZE bytes are checked against their summary first,
+     * so repeated searches skip chunks that cannot contain the needle.
+     *
+     * @tparam Func Callable as func(size_t offset); may return bool, false stops the search.
+     * @param editor The editor to search.
+     * @param needle The bytes to look for; an empty needle matches nothing.
+     * @param func Called with the offset of each occurrence in increasing order. Occurrences may overlap.
+     * @param offset The offset to start searching from.
+     * @param size The number of bytes searched from offset; occurrences must lie entirely inside them.
+     */
+    template <typename Func>
+    void find_all(const binary_editor &editor, std::span<const uint8_t> needle, Func &&func, const size_t &offset = 0, const size_t &size = SIZE_MAX)
+    {
+        if (needle.empty() || offset >= editor.size())
+        {
+            return;
+        }
+        size_t searchSize = std::min(size, editor.size() - offset);
+        auto report = [&func](const size_t &position)
+        {
+            if constexpr (std::is_same_v<std::invoke_result_t<Func, size_t>, bool>)
+            {
+                return func(position);
+            }
+            else
+            {
+                func(position);
+                return true;
+            }
+        };
+
+        // The last needle.size() - 1 bytes before the current segment, for occurrences spanning segments.
+        std::vector<uint8_t> tail;
+        std::vector<uint8_t> bridge;
+        size_t               base = offset;
+        editor.for_each_chunk_segment(offset, searchSize,
+                                      [&](const binary_chunk_interface &chunk, const uint8_t *pData, const size_t &size)
+                                      {
+                                          if (!tail.empty())
+                                          {
+                                              bridge.assign(tail.begin(), tail.end());
+                                              bridge.insert(bridge.end(), pData, pData + std::min(size, needle.size() - 1));
+                                              size_t start = 0;
+                                              while (start < tail.size())
+                                              {
+                                                  size_t found = detail::find_literal(bridge.data() + start, bridge.size() - start, needle.data(), needle.size());
+                                                  if (found == bridge.size() - start || start + found >= tail.size())
+                                                  {
+                                                      break;
+                                                  }
+                                                  if (!report(base - tail.size() + start + found))
+                                                  {
+                                                      return false;
+                                                  }
+                                                  start += found + 1;
+                                              }
+                                          }
+                                          // Chunks whose summary rules the needle out are not scanned; bridges still are. The summary
+                                          // is only computed for segments covering their whole chunk, since computing reads all of it.
+                                          std::shared_ptr<const chunk_summary> pSummary;
+                                          if (size >= needle.size() && chunk.size() >= chunk_summary::MIN_CHUNK_SIZE)
+                                          {
+                                              pSummary = chunk.try_summary(size == chunk.size());
+                                          }
+                                          bool skip = pSummary != nullptr && !pSummary->may_contain(needle);
+                                          for (size_t start = 0; start < size && !skip;)
+                                          {
+                                              size_t found = detail::find_literal(pData + start, size - start, needle.data(), needle.size());
+                                              if (found == size - start)
+                                              {
+                                                  break;
+                                              }
+                                              if (!report(base + start + found))
+                                              {
+                                                  return false;
+                                              }
+                                              start += found + 1;
+                                          }
+                                          tail.insert(tail.end(), pData + size - std::min(size, needle.size() - 1), pData + size);
+                                          if (tail.size() > needle.size() - 1)
+                                          {
+                                              tail.erase(tail.begin(), tail.end() - (needle.size() - 1));
+                                          }
+                                          base += size;
+                                          return true;
+                                      });
+    }
+
+    /**
+     * @brief Find the first occurrence of a needle in an editor.
+     * @param editor The editor to search.
+     * @param needle The bytes to look for.
+     * @param offset The offset to start searching from.
+     * @return The offset of the occurrence, or std::nullopt if there is none.
+     */
+    inline std::optional<size_t> find(const binary_editor &editor, std::span<const uint8_t> needle, const size_t &offset = 0)
+    {
+        std::optional<size_t> ret;
+        find_all(
+            editor, needle,
+            [&ret](size_t position)
+            {
+                ret = position;
+                return false;
+            },
+            offset);
+        return ret;
+    }
+
+    /**
+     * @brief Find the last occurrence of a needle starting at or before a position.
+     *
+     * Segments are walked backwards from the position, so the search touches only the bytes after the
+     * occurrence it returns; occurrences spanning chunks are found through a small bridge buffer.
+     *
+     * @param editor The editor to search.
+     * @param needle The bytes to look for.
+     * @param position The last start offset accepted; SIZE_MAX searches the whole editor.
+     * @return The offset of the occurrence, or std::nullopt if there is none.
+     */
+    inline std::optional<size_t> rfind(const binary_editor &editor, std::span<const uint8_t> needle, const size_t &position = SIZE_MAX)
+    {
+        if (needle.empty() || needle.size() > editor.size())
+        {
+            return std::nullopt;
+        }
+        size_t                end = std::min(position, editor.size() - needle.size()) + needle.size();
+        std::optional<size_t> ret;
+        // The first needle.size() - 1 bytes after the current segment, for occurrences spanning segments.
+        std::vector<uint8_t> head;
+        std::vector<uint8_t> bridge;
+        size_t               base = end;
+        editor.for_each_segment_reverse(0, end,
+                                        [&](const uint8_t *pData, const size_t &size)
+                                        {
+                                            base -= size;
+                                            if (!head.empty())
+                                            {
+                                                size_t keep = std::min(size, needle.size() - 1);
+                                                bridge.assign(pData + size - keep, pData + size);
+                                                bridge.insert(bridge.end(), head.begin(), head.end());
+                                                // The head is shorter than the needle, so every occurrence starts in this segment.
+                                                size_t found = detail::rfind_literal(bridge.data(), bridge.size(), needle.data(), needle.size());
+                                                if (found < keep)
+                                                {
+                                                    ret = base + size - keep + found;
+                                                    return false;
+                                                }
+                                            }
+                                            size_t found = detail::rfind_literal(pData, size, needle.data(), needle.size());
+                                            if (found != size)
+                                            {
+                                                ret = base + found;
+                                                return false;
+                                            }
+                                            head.insert(head.begin(), pData, pData + std::min(size, needle.size() - 1));
+                                            if (head.size() > needle.size() - 1)
+                                            {
+                                                head.resize(needle.size() - 1);
+                                            }
+                                            return true;
+                                        });
+        return ret;
+    }
+
+    /**
+     * @brief Count the occurrences of a needle in an editor.
+     *
+     * Ranges are counted in parallel with find_all(), each counting the occurrences that start in it, so no
+     * match list is built.
+     *
+     * @param editor The editor to search; it must not be modified while counting.
+     * @param needle The bytes to look for; an empty needle matches nothing.
+     * @param pool The pool counting the ranges.
+     * @param rangeSize Start positions per task.
+     * @return The number of occurrences, overlapping ones included.
+     */
+    inline size_t count(const binary_editor &editor, std::span<const uint8_t> needle, worker_pool &pool = worker_pool::shared(),
+                        const size_t &rangeSize = DEFAULT_RANGE_SIZE)
+    {
+        if (needle.empty())
+        {
+            return 0;
+        }
+        std::atomic<size_t> total = 0;
+        pool.parallel_for_ranges(editor.size(), rangeSize,
+                                 [&](size_t first, size_t last)
+                                 {
+                                     size_t found = 0;
+                                     find_all(editor, needle, [&found](size_t) { ++found; }, first, std::min(editor.size(), last + needle.size() - 1) - first);
+                                     total += found;
+                                 });
+        return total;
+    }
+}
@@ -0,0 +1,293 @@
+#pragma once
+#include "binary_editor.hpp"
+#include "binary_worker_pool.hpp"
+#include "binary_search.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <stop_token>
+#include <thread>
+
+namespace binary
+{
+    namespace detail
+    {
+        /**
+         * @brief State shared by a binary_search_task and the range tasks it runs on the pool.
+         */
+        struct search_task_state
+        {
+            binary_editor               editor;
+            std::vector<uint8_t>        needle;
+            std::function<bool(size_t)> on_match;
+            worker_pool                *pPool;
+            size_t                      range_size;
+            size_t                      range_count;
+            std::stop_source            stop;
+            std::atomic<size_t>         next_range{0};
+            std::atomic<size_t>         searched{0};
+
+            std::mutex                            mutex;
+            std::condition_variable               idle;
+            size_t                                active = 0;        ///< Range tasks queued or running
+            std::map<size_t, std::vector<size_t>> pending;           ///< Finished ranges not delivered yet
+            size_t                                next_delivery = 0; ///< Next range to deliver
+            bool                                  delivering    = false;
+            std::exception_ptr                    pError;
+
+            /**
+             * @brief Hand over the matches of a finished range and deliver every range now in order.
+             *
+             * One thread delivers at a time; others only queue their range, so matches reach on_match in
+             * offset order without on_match being called concurrently.
+             */
+            void complete(const size_t &range, std::vector<size_t> &&matches)
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                pending.emplace(range, std::move(matches));
+                if (delivering)
+                {
+                    return;
+                }
+                delivering = true;
+                try
+                {
+                    while (!stop.stop_requested() && !pending.empty() && pending.begin()->first == next_delivery)
+                    {
+                        auto batch = std::move(pending.begin()->second);
+                        pending.erase(pending.begin());
+                        ++next_delivery;
+                        lock.unlock();
+                        for (size_t i = 0; i < batch.size() && !stop.stop_requested(); ++i)
+                        {
+                            if (!on_match(batch[i]))
+                            {
+                                stop.request_stop();
+                            }
+                        }
+                        lock.lock();
+                    }
+                }
+                catch (...)
+                {
+                    if (!lock.owns_lock())
+                    {
+                        lock.lock();
+                    }
+                    delivering = false;
+                    throw;
+                }
+                delivering = false;
+            }
+            /**
+             * @brief Body of a range task: search the next range, then queue a successor or retire.
+             */
+            static void run(std::shared_ptr<search_task_state> pState)
+            {
+                auto  &state = *pState;
+                size_t range = state.next_range++;
+                if (range < state.range_count && !state.stop.stop_requested())
+                {
+                    try
+                    {
+                        size_t              first = range * state.range_size;
+                        size_t              size  = std::min(state.editor.size(), first + state.range_size + state.needle.size() - 1) - first;
+                        std::stop_token     token = state.stop.get_token();
+                        std::vector<size_t> matches;
+                        find_all(
+                            state.editor, state.needle,
+                            [&](size_t position)
+                            {
+                                matches.push_back(position);
+                                return !token.stop_requested();
+                            },
+                            first, size);
+                        state.searched += std::min(state.range_size, state.editor.size() - first);
+                        state.complete(range, std::move(matches));
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(state.mutex);
+                        if (!state.pError)
+                        {
+                            state.pError = std::current_exception();
+                        }
+                        state.stop.request_stop();
+                    }
+                }
+
+                std::lock_guard<std::mutex> lock(state.mutex);
+                if (!state.stop.stop_requested() && state.next_range < state.range_count)
+                {
+                    state.pPool->submit([pState] { run(pState); });
+                }
+                else if (--state.active == 0)
+                {
+                    state.idle.notify_all();
+                }
+            }
+        };
+    }
+
+    /**
+     * @brief Handle of a literal search running in the background on a worker_pool.
+     *
+     * The editor is cut into ranges searched by pool tasks, at most two per pool thread queued at a time, so a
+     * huge search never floods the pool. Matches are passed to the callback incrementally and in increasing
+     * offset order, from pool threads but never concurrently. cancel() stops the tasks at their next range
+     * or match; matches are not delivered after it returns. Destroying the handle cancels and waits.
+     *
+     * @code
+     * binary::binary_search_task task(editor, needle, [&](size_t offset) { post_to_ui(offset); });
+     * progress_bar.set(task.progress());
+     * if (user_pressed_escape) { task.cancel(); }
+     * @endcode
+     */
+    class binary_search_task
+    {
+    private:
+        std::shared_ptr<detail::search_task_state> m_pState;
+
+    public:
+        /**
+         * @brief Start a search.
+         * @tparam Func Callable as func(size_t offset); may return bool, false cancels the search.
+         * @param editor The editor; the task searches a copy sharing its chunks.
+         * @param needle The bytes to look for; an empty needle matches nothing.
+         * @param func Called with the offset of each occurrence.
+         * @param pool The pool running the search.
+         * @param rangeSize Bytes searched per task.
+         * @throws binary_exception if rangeSize is 0.
+         */
+        template <typename Func>
+        binary_search_task(const binary_editor &editor, std::span<const uint8_t> needle, Func &&func, worker_pool &pool = worker_pool::shared(),
+                           const size_t &rangeSize = DEFAULT_RANGE_SIZE)
+            : m_pState(std::make_shared<detail::search_task_state>())
+        {
+            if (rangeSize == 0)
+            {
+                throw binary_exception("binary_search_task::binary_search_task err : rangeSize must not be 0!");
+            }
+            auto &state  = *m_pState;
+            state.editor = editor;
+            state.needle.assign(needle.begin(), needle.end());
+            state.on_match = [func = std::forward<Func>(func)](size_t offset) mutable
+            {
+                if constexpr (std::is_same_v<std::invoke_result_t<Func &, size_t>, bool>)
+                {
+                    return func(offset);
+                }
+                else
+                {
+                    func(offset);
+                    return true;
+                }
+            };
+            state.pPool       = &pool;
+            state.range_size  = rangeSize;
+            state.range_count = needle.empty() ? 0 : (editor.size() + rangeSize - 1) / rangeSize;
+
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.active = std::min(state.range_count, 2 * pool.size());
+            for (size_t i = 0; i < state.active; ++i)
+            {
+                pool.submit([pState = m_pState] { detail::search_task_state::run(pState); });
+            }
+        }
+        /**
+         * @brief Cancel the search and wait for its tasks.
+         */
+        ~binary_search_task()
+        {
+            if (m_pState != nullptr)
+            {
+                cancel();
+                std::unique_lock<std::mutex> lock(m_pState->mutex);
+                m_pState->idle.wait(lock, [this] { return m_pState->active == 0; });
+            }
+        }
+        binary_search_task(binary_search_task &&) noexcept            = default;
+        binary_search_task &operator=(binary_search_task &&) noexcept = delete;
+        binary_search_task(const binary_search_task &)                = delete;
+        binary_search_task &operator=(const binary_search_task &)     = delete;
+
+        /**
+         * @brief Request cancellation; running tasks stop at their next match or range.
+         *
+         * Waits for a delivery in progress on another thread, so no match is delivered after this returns.
+         * Must not be called from the callback; return false from it instead.
+         */
+        void cancel()
+        {
+            m_pState->stop.request_stop();
+            std::unique_lock<std::mutex> lock(m_pState->mutex);
+            while (m_pState->delivering)
+            {
+                lock.unlock();
+                std::this_thread::yield();
+                lock.lock();
+            }
+        }
+        /**
+         * @brief Check whether the search was cancelled, by cancel(), the callback or an error.
+         * @return True if cancelled.
+         */
+        bool cancelled() const
+        {
+            return m_pState->stop.stop_requested();
+        }
+        /**
+         * @brief Check whether all tasks have ended.
+         * @return True if the search completed or stopped after cancellation.
+         */
+        bool finished() const
+        {
+            std::lock_guard<std::mutex> lock(m_pState->mutex);
+            return m_pState->active == 0;
+        }
+        /**
+         * @brief Get the number of bytes searched so far.
+         * @return The byte count.
+         */
+        size_t searched_bytes() const
+        {
+            return m_pState->searched;
+        }
+        /**
+         * @brief Get the fraction of the editor searched so far.
+         * @return A value from 0 to 1.
+         */
+        double progress() const
+        {
+            size_t total = m_pState->editor.size();
+            return total == 0 || m_pState->range_count == 0 ? 1.0 : static_cast<double>(searched_bytes()) / static_cast<double>(total);
+        }
+        /**
+         * @brief Wait for all tasks to end, up to a timeout.
+         * @param timeout The longest time to wait.
+         * @return True if the tasks ended.
+         */
+        template <typename Rep, typename Period>
+        bool wait_for(const std::chrono::duration<Rep, Period> &timeout) const
+        {
+            std::unique_lock<std::mutex> lock(m_pState->mutex);
+            return m_pState->idle.wait_for(lock, timeout, [this] { return m_pState->active == 0; });
+        }
+        /**
+         * @brief Wait for all tasks to end.
+         *
+         * Must not be called from a thread of the pool running the search.
+         *
+         * @throws Rethrows the first exception thrown by the callback or a task.
+         */
+        void wait() const
+        {
+            std::unique_lock<std::mutex> lock(m_pState->mutex);
+            m_pState->idle.wait(lock, [this] { return m_pState->active == 0; });
+            if (m_pState->pError)
+            {
+                std::rethrow_exception(m_pState->pError);
+            }
+        }
+    };
+}
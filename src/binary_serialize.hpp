@@ -0,0 +1,428 @@
+#pragma once
+#include "binary_editor.hpp"
+#include "binary_builder.hpp"
+#include <tuple>
+
+namespace writer
+{
+    /**
+     * @brief Field list of a type serialized by serialize(); specialize it to choose and order the fields.
+     *
+     * Types without a specialization must be aggregates, decomposed with structured bindings.
+     *
+     * @code
+     * template <>
+     * struct writer::field_list<record>
+     * {
+     *     static constexpr auto members = std::make_tuple(&record::id, &record::flags);
+     * };
+     * @endcode
+     */
+    template <typename T>
+    struct field_list
+    {
+    };
+
+    namespace detail
+    {
+        /**
+         * @brief Check whether a type has a field_list specialization.
+         */
+        template <typename T>
+        concept has_field_list = requires { field_list<T>::members; };
+
+        /**
+         * @brief Placeholder convertible to any field type, used to count the fields of an aggregate.
+         */
+        struct any_field
+        {
+            template <typename U>
+            constexpr operator U() const;
+        };
+
+        /**
+         * @brief any_field, taking an index so that a pack of them can be expanded from an index sequence.
+         */
+        template <size_t>
+        using any_field_at = any_field;
+
+        /**
+         * @brief Count the initializers an aggregate accepts by growing a brace initializer until it no longer compiles.
+         *
+         * Through brace elision, each element of a C array field takes an initializer of its own.
+         */
+        template <typename T, typename... Fields>
+        consteval size_t count_initializers()
+        {
+            if constexpr (requires { T{Fields{}..., any_field{}}; })
+            {
+                return count_initializers<T, Fields..., any_field>();
+            }
+            else
+            {
+                return sizeof...(Fields);
+            }
+        }
+
+        /**
+         * @brief Count the initializers an aggregate accepts after Before of them and a braced initializer.
+         *
+         * The braced initializer takes the whole field starting at initializer Before, C array or not, so what
+         * is left is the number of initializers of the fields after it.
+         */
+        template <typename T, size_t Before, size_t After = 0>
+        consteval size_t count_initializers_after()
+        {
+            constexpr bool ACCEPTS = []<size_t... I, size_t... J>(std::index_sequence<I...>, std::index_sequence<J...>)
+            { return requires { T{any_field_at<I>{}..., {any_field{}}, any_field_at<J>{}...}; }; }(std::make_index_sequence<Before>(),
+                                                                                                    std::make_index_sequence<After + 1>());
+            if constexpr (ACCEPTS)
+            {
+                return count_initializers_after<T, Before, After + 1>();
+            }
+            else
+            {
+                return After;
+            }
+        }
+
+        /**
+         * @brief Count the fields of an aggregate from its initializer Index on, out of Total initializers.
+         *
+         * A field starting at initializer Index takes the initializers not left to the fields after it, so
+         * C array fields count once.
+         */
+        template <typename T, size_t Index = 0, size_t Total = count_initializers<T>()>
+        consteval size_t count_fields()
+        {
+            if constexpr (Index >= Total)
+            {
+                return 0;
+            }
+            else
+            {
+                return 1 + count_fields<T, Total - count_initializers_after<T, Index>(), Total>();
+            }
+        }
+
+        /**
+         * @brief Check whether a type is std::array.
+         */
+        template <typename T>
+        constexpr bool is_std_array = false;
+        template <typename E, size_t N>
+        constexpr bool is_std_array<std::array<E, N>> = true;
+
+        /**
+         * @brief Check whether a type is a std::array or a C array.
+         */
+        template <typename T>
+        constexpr bool is_array_field = is_std_array<T> || std::is_bounded_array_v<T>;
+
+        /**
+         * @brief Element type of a std::array or a C array.
+         */
+        template <typename T>
+        using array_element = std::remove_cvref_t<decltype(std::declval<T &>()[0])>;
+
+        /**
+         * @brief Number of elements of a std::array or a C array.
+         */
+        template <typename T>
+        constexpr size_t array_extent = sizeof(T) / sizeof(array_element<T>);
+
+        /**
+         * @brief Check whether a type is a std::array or C array of scalars, stored without padding.
+         */
+        template <typename T>
+        constexpr bool is_scalar_array = false;
+        template <typename E, size_t N>
+        constexpr bool is_scalar_array<std::array<E, N>> = is_builder_field<E>;
+        template <typename E, size_t N>
+        constexpr bool is_scalar_array<E[N]> = is_builder_field<E>;
+
+        /**
+         * @brief Get references to the fields of a value, from its field_list or its structured bindings.
+         * @return A tuple of const references.
+         */
+        template <typename T>
+        constexpr auto tie_fields(const T &value)
+        {
+            if constexpr (has_field_list<T>)
+            {
+                return std::apply([&value](auto... pMembers) { return std::tie(value.*pMembers...); }, field_list<T>::members);
+            }
+            else
+            {
+                static_assert(std::is_aggregate_v<T>, "serialize requires an aggregate or a field_list specialization");
+                constexpr size_t COUNT = count_fields<T>();
+                static_assert(COUNT <= 12, "serialize decomposes aggregates of up to 12 fields; specialize field_list for larger types");
+                // clang-format off
+                if constexpr (COUNT == 0) { return std::tuple<>(); }
+                else if constexpr (COUNT == 1) { const auto &[a] = value; return std::tie(a); }
+                else if constexpr (COUNT == 2) { const auto &[a, b] = value; return std::tie(a, b); }
+                else if constexpr (COUNT == 3) { const auto &[a, b, c] = value; return std::tie(a, b, c); }
+                else if constexpr (COUNT == 4) { const auto &[a, b, c, d] = value; return std::tie(a, b, c, d); }
+                else if constexpr (COUNT == 5) { const auto &[a, b, c, d, e] = value; return std::tie(a, b, c, d, e); }
+                else if constexpr (COUNT == 6) { const auto &[a, b, c, d, e, f] = value; return std::tie(a, b, c, d, e, f); }
+                else if constexpr (COUNT == 7) { const auto &[a, b, c, d, e, f, g] = value; return std::tie(a, b, c, d, e, f, g); }
+                else if constexpr (COUNT == 8) { const auto &[a, b, c, d, e, f, g, h] = value; return std::tie(a, b, c, d, e, f, g, h); }
+                else if constexpr (COUNT == 9) { const auto &[a, b, c, d, e, f, g, h, i] = value; return std::tie(a, b, c, d, e, f, g, h, i); }
+                else if constexpr (COUNT == 10) { const auto &[a, b, c, d, e, f, g, h, i, j] = value; return std::tie(a, b, c, d, e, f, g, h, i, j); }
+                else if constexpr (COUNT == 11) { const auto &[a, b, c, d, e, f, g, h, i, j, k] = value; return std::tie(a, b, c, d, e, f, g, h, i, j, k); }
+                else { const auto &[a, b, c, d, e, f, g, h, i, j, k, l] = value; return std::tie(a, b, c, d, e, f, g, h, i, j, k, l); }
+                // clang-format on
+            }
+        }
+
+        /**
+         * @brief Types of the fields of T, as a tuple of const references.
+         */
+        template <typename T>
+        using field_tuple = decltype(tie_fields(std::declval<const T &>()));
+
+        /**
+         * @brief Get the serialized size of a type: its fields packed without padding.
+         */
+        template <typename T>
+        consteval size_t packed_size()
+        {
+            if constexpr (is_builder_field<T>)
+            {
+                return sizeof(T);
+            }
+            else if constexpr (is_array_field<T>)
+            {
+                return array_extent<T> * packed_size<array_element<T>>();
+            }
+            else
+            {
+                return []<typename... Fields>(std::type_identity<std::tuple<Fields...>>) { return (size_t{0} + ... + packed_size<std::remove_cvref_t<Fields>>()); }(
+                    std::type_identity<field_tuple<T>>());
+            }
+        }
+
+        /**
+         * @brief Get the size shared by every scalar of a type, or 0 if the scalars differ in size.
+         */
+        template <typename T>
+        consteval size_t lane_size()
+        {
+            if constexpr (is_builder_field<T>)
+            {
+                return sizeof(T);
+            }
+            else if constexpr (is_array_field<T>)
+            {
+                return lane_size<array_element<T>>();
+            }
+            else
+            {
+                return []<typename... Fields>(std::type_identity<std::tuple<Fields...>>)
+                {
+                    size_t sizes[] = {lane_size<std::remove_cvref_t<Fields>>()..., 0};
+                    for (size_t i = 1; i < sizeof...(Fields); ++i)
+                    {
+                        if (sizes[i] != sizes[0])
+                        {
+                            return size_t{0};
+                        }
+                    }
+                    return sizes[0];
+                }(std::type_identity<field_tuple<T>>());
+            }
+        }
+
+        /**
+         * @brief Reverse the bytes of each lane of a buffer.
+         *
+         * Lanes of 2, 4 and 8 bytes are swapped 16 bytes at a time: words are reordered with 16-bit shuffles,
+         * then the bytes of each word are swapped with shifts.
+         *
+         * @tparam Size The lane size.
+         * @param pData The lanes.
+         * @param count The number of lanes.
+         */
+        template <size_t Size>
+        inline void swap_lanes(uint8_t *pData, const size_t &count)
+        {
+            size_t i = 0;
+#if defined(BINARY_EDITOR_SSE2)
+            if constexpr (Size == 2 || Size == 4 || Size == 8)
+            {
+                for (; i + 16 / Size <= count; i += 16 / Size)
+                {
+                    __m128i lanes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pData + i * Size));
+                    if constexpr (Size == 4)
+                    {
+                        lanes = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lanes, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+                    }
+                    else if constexpr (Size == 8)
+                    {
+                        lanes = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lanes, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+                    }
+                    lanes = _mm_or_si128(_mm_slli_epi16(lanes, 8), _mm_srli_epi16(lanes, 8));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(pData + i * Size), lanes);
+                }
+            }
+#endif
+            for (; i < count; ++i)
+            {
+                std::reverse(pData + i * Size, pData + (i + 1) * Size);
+            }
+        }
+
+        /**
+         * @brief Copy the scalars of a value to a buffer in native byte order, without padding.
+         * @param value The value.
+         * @param pOut Receives the bytes; advanced past them.
+         */
+        template <typename T>
+        inline void store_native(const T &value, uint8_t *&pOut)
+        {
+            if constexpr (is_builder_field<T> || is_scalar_array<T>)
+            {
+                static_assert(sizeof(T) == packed_size<T>());
+                memcpy(pOut, &value, sizeof(T));
+                pOut += sizeof(T);
+            }
+            else if constexpr (is_array_field<T>)
+            {
+                for (const auto &element : value)
+                {
+                    store_native(element, pOut);
+                }
+            }
+            else
+            {
+                std::apply([&pOut](const auto &...fields) { (store_native(fields, pOut), ...); }, tie_fields(value));
+            }
+        }
+
+        /**
+         * @brief Reverse the bytes of each scalar of a packed value, for values whose scalars differ in size.
+         * @param pData The packed value; advanced past it.
+         */
+        template <typename T>
+        inline void swap_packed(uint8_t *&pData)
+        {
+            if constexpr (is_builder_field<T>)
+            {
+                swap_lanes<sizeof(T)>(pData, 1);
+                pData += sizeof(T);
+            }
+            else if constexpr (is_scalar_array<T>)
+            {
+                swap_lanes<sizeof(array_element<T>)>(pData, array_extent<T>);
+                pData += sizeof(T);
+            }
+            else if constexpr (is_array_field<T>)
+            {
+                for (size_t i = 0; i < array_extent<T>; ++i)
+                {
+                    swap_packed<array_element<T>>(pData);
+                }
+            }
+            else
+            {
+                [&pData]<typename... Fields>(std::type_identity<std::tuple<Fields...>>) { (swap_packed<std::remove_cvref_t<Fields>>(pData), ...); }(
+                    std::type_identity<field_tuple<T>>());
+            }
+        }
+    }
+
+    /**
+     * @brief Number of bytes serialize() writes for a value of type T: its scalars packed without padding.
+     */
+    template <typename T>
+    constexpr size_t serialized_size = detail::packed_size<T>();
+
+    /**
+     * @brief Serialize values into a buffer.
+     *
+     * Fields are written in declaration order, or field_list order, without padding. Nested aggregates,
+     * std::array and C array fields are flattened. The bytes are first copied in native order, then converted to Endian:
+     * when every scalar has the same size the whole buffer is swapped with one vector pass, otherwise each
+     * field is swapped on its own.
+     *
+     * @tparam Endian The byte order of the scalars.
+     * @param values The values.
+     * @param pOut Receives values.size() * serialized_size<T> bytes.
+     */
+    template <std::endian Endian = std::endian::little, typename T>
+    void serialize_to(std::span<const T> values, uint8_t *pOut)
+    {
+        uint8_t *pData = pOut;
+        for (const auto &value : values)
+        {
+            detail::store_native(value, pData);
+        }
+        if constexpr (Endian != std::endian::native)
+        {
+            constexpr size_t LANE_SIZE = detail::lane_size<T>();
+            if constexpr (LANE_SIZE != 0)
+            {
+                if constexpr (LANE_SIZE > 1)
+                {
+                    detail::swap_lanes<LANE_SIZE>(pOut, values.size() * serialized_size<T> / LANE_SIZE);
+                }
+            }
+            else
+            {
+                for (pData = pOut; pData != pOut + values.size() * serialized_size<T>;)
+                {
+                    detail::swap_packed<T>(pData);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Serialize values into a new editor holding a single chunk.
+     * @tparam Endian The byte order of the scalars.
+     * @param values The values; see serialize_to() for the layout.
+     * @return An editor of values.size() * serialized_size<T> bytes.
+     */
+    template <std::endian Endian = std::endian::little, typename T>
+    binary::binary_editor serialize_all(std::span<const T> values)
+    {
+        size_t size = values.size() * serialized_size<T>;
+        if (size == 0)
+        {
+            return binary::binary_editor();
+        }
+        std::unique_ptr<uint8_t[]> pBlob(new uint8_t[size]);
+        serialize_to<Endian>(values, pBlob.get());
+        return binary::binary_editor(std::unique_ptr<const uint8_t[]>(std::move(pBlob)), size);
+    }
+
+    /**
+     * @brief Serialize a value into a new editor holding a single chunk.
+     *
+     * @code
+     * struct record { uint32_t id; uint16_t flags; std::array<uint8_t, 6> tag; };
+     * writer::write_back_fields<std::endian::big>(editor, record{7, 1, {}});
+     * @endcode
+     *
+     * @tparam Endian The byte order of the scalars.
+     * @param value The value; see serialize_to() for the layout.
+     * @return An editor of serialized_size<T> bytes.
+     */
+    template <std::endian Endian = std::endian::little, typename T>
+    binary::binary_editor serialize(const T &value)
+    {
+        return serialize_all<Endian>(std::span<const T>(&value, 1));
+    }
+
+    /**
+     * @brief Serialize a value and append it to an editor as one chunk.
+     * @tparam Endian The byte order of the scalars.
+     * @param editor The editor.
+     * @param value The value; see serialize_to() for the layout.
+     */
+    template <std::endian Endian = std::endian::little, typename T>
+    void write_back_fields(binary::binary_editor &editor, const T &value)
+    {
+        editor.push_back(serialize<Endian>(value));
+    }
+}
@@ -0,0 +1,352 @@
+#pragma once
+#include "binary_editor.hpp"
+#include "binary_worker_pool.hpp"
+#include <array>
+#include <bit>
+#include <cmath>
+
+namespace binary
+{
+    namespace detail
+    {
+        /**
+         * @brief Build a fixed pseudo-random permutation of the bytes for Pearson hashing.
+         * @return The permutation.
+         */
+        constexpr std::array<uint8_t, 256> make_pearson_table()
+        {
+            std::array<uint8_t, 256> table{};
+            for (size_t i = 0; i < 256; ++i)
+            {
+                table[i] = static_cast<uint8_t>(i);
+            }
+            uint32_t state = 0x2545F491u;
+            for (size_t i = 255; i > 0; --i)
+            {
+                state    = state * 1664525u + 1013904223u;
+                size_t  j    = (state >> 8) % (i + 1);
+                uint8_t swap = table[i];
+                table[i]     = table[j];
+                table[j]     = swap;
+            }
+            return table;
+        }
+
+        constexpr std::array<uint8_t, 256> PEARSON_TABLE = make_pearson_table();
+
+        /**
+         * @brief Pearson hash of a salt and three bytes.
+         */
+        inline uint8_t pearson_hash(const uint8_t &salt, const uint8_t &a, const uint8_t &b, const uint8_t &c)
+        {
+            return PEARSON_TABLE[PEARSON_TABLE[PEARSON_TABLE[PEARSON_TABLE[salt] ^ a] ^ b] ^ c];
+        }
+
+        /**
+         * @brief Circular distance between two values modulo a range.
+         */
+        inline size_t circular_distance(const size_t &a, const size_t &b, const size_t &range)
+        {
+            size_t d = a > b ? a - b : b - a;
+            return std::min(d, range - d);
+        }
+    }
+
+    /**
+     * @brief Locality-sensitive digest of byte content in the style of TLSH.
+     *
+     * Similar inputs get digests at a small similarity_distance(); unrelated inputs get large ones.
+     * Digests are only meaningful for inputs of at least MIN_INPUT_SIZE bytes with some variety,
+     * which valid() reports.
+     */
+    struct similarity_digest
+    {
+        static constexpr size_t BUCKET_COUNT   = 128;
+        static constexpr size_t MIN_INPUT_SIZE = 50;
+
+        uint8_t                 checksum = 0; ///< Checksum of the byte pairs
+        uint8_t                 lvalue   = 0; ///< Logarithmic length of the input
+        uint8_t                 q1_ratio = 0; ///< First quartile relative to the third, modulo 16
+        uint8_t                 q2_ratio = 0; ///< Second quartile relative to the third, modulo 16
+        std::array<uint64_t, 4> body{};       ///< 2-bit quartile code of each bucket
+        bool                    is_valid = false;
+
+        /**
+         * @brief Check whether the input was large and varied enough for a meaningful digest.
+         * @return True if valid.
+         */
+        bool valid() const
+        {
+            return is_valid;
+        }
+        /**
+         * @brief Format the digest as 70 hex digits.
+         * @return The hex string.
+         */
+        std::string to_string() const
+        {
+            static const char *digits = "0123456789ABCDEF";
+            std::string        ret;
+            auto               put = [&ret](const uint8_t &value)
+            {
+                ret += digits[value >> 4];
+                ret += digits[value & 0x0F];
+            };
+            put(checksum);
+            put(lvalue);
+            put(static_cast<uint8_t>((q1_ratio << 4) | q2_ratio));
+            for (const auto &word : body)
+            {
+                for (size_t i = 0; i < 8; ++i)
+                {
+                    put(static_cast<uint8_t>(word >> (8 * i)));
+                }
+            }
+            return ret;
+        }
+        /**
+         * @brief Parse a digest formatted by to_string().
+         * @param text The hex string.
+         * @return The digest.
+         * @throws binary_exception if text is not a formatted digest.
+         */
+        static similarity_digest from_string(std::string_view text)
+        {
+            if (text.size() != 70)
+            {
+                throw binary_exception("similarity_digest::from_string err : digest must have 70 hex digits!");
+            }
+            auto get = [&text](const size_t &index)
+            {
+                auto nibble = [](char c) -> uint8_t
+                {
+                    if (c >= '0' && c <= '9')
+                    {
+                        return static_cast<uint8_t>(c - '0');
+                    }
+                    if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f')
+                    {
+                        return static_cast<uint8_t>((c | 0x20) - 'a' + 10);
+                    }
+                    throw binary_exception("similarity_digest::from_string err : invalid hex digit!");
+                };
+                return static_cast<uint8_t>((nibble(text[2 * index]) << 4) | nibble(text[2 * index + 1]));
+            };
+            similarity_digest ret;
+            ret.checksum = get(0);
+            ret.lvalue   = get(1);
+            ret.q1_ratio = get(2) >> 4;
+            ret.q2_ratio = get(2) & 0x0F;
+            for (size_t i = 0; i < 32; ++i)
+            {
+                ret.body[i / 8] |= static_cast<uint64_t>(get(3 + i)) << (8 * (i % 8));
+            }
+            ret.is_valid = true;
+            return ret;
+        }
+    };
+
+    /**
+     * @brief Streaming builder of a similarity_digest; bytes may be fed in any number of pieces.
+     */
+    class binary_similarity_hasher
+    {
+    private:
+        static constexpr size_t WINDOW_SIZE = 5;
+
+        std::array<uint32_t, 256> m_buckets{};
+        uint8_t                   m_window[WINDOW_SIZE] = {}; ///< Most recent byte at m_window[m_size % WINDOW_SIZE]
+        uint64_t                  m_size     = 0;
+        uint8_t                   m_checksum = 0;
+
+    public:
+        /**
+         * @brief Hash more bytes.
+         * @param pData The bytes.
+         * @param size The number of bytes.
+         */
+        void update(const uint8_t *pData, const size_t &size)
+        {
+            for (size_t i = 0; i < size; ++i)
+            {
+                size_t position    = static_cast<size_t>(m_size % WINDOW_SIZE);
+                m_window[position] = pData[i];
+                ++m_size;
+                if (m_size < WINDOW_SIZE)
+                {
+                    continue;
+                }
+                // w0 is the newest byte, w4 the oldest one of the window.
+                uint8_t w0 = pData[i];
+                uint8_t w1 = m_window[(position + 4) % WINDOW_SIZE];
+                uint8_t w2 = m_window[(position + 3) % WINDOW_SIZE];
+                uint8_t w3 = m_window[(position + 2) % WINDOW_SIZE];
+                uint8_t w4 = m_window[(position + 1) % WINDOW_SIZE];
+                m_checksum = detail::pearson_hash(0, w0, w1, m_checksum);
+                ++m_buckets[detail::pearson_hash(2, w0, w1, w2)];
+                ++m_buckets[detail::pearson_hash(3, w0, w1, w3)];
+                ++m_buckets[detail::pearson_hash(5, w0, w2, w3)];
+                ++m_buckets[detail::pearson_hash(7, w0, w2, w4)];
+                ++m_buckets[detail::pearson_hash(11, w0, w1, w4)];
+                ++m_buckets[detail::pearson_hash(13, w0, w3, w4)];
+            }
+        }
+        /**
+         * @brief Hash all segments of an editor without flattening it.
+         * @param editor The editor.
+         */
+        void update(const binary_editor &editor)
+        {
+            editor.for_each_segment([this](const uint8_t *pData, const size_t &size) { update(pData, size); });
+        }
+        /**
+         * @brief Get the digest of the bytes hashed so far.
+         * @return The digest; check valid().
+         */
+        similarity_digest digest() const
+        {
+            similarity_digest                                     ret;
+            std::array<uint32_t, similarity_digest::BUCKET_COUNT> sorted;
+            std::copy(m_buckets.begin(), m_buckets.begin() + similarity_digest::BUCKET_COUNT, sorted.begin());
+            std::nth_element(sorted.begin(), sorted.begin() + 95, sorted.end());
+            uint32_t q3 = sorted[95];
+            std::nth_element(sorted.begin(), sorted.begin() + 63, sorted.begin() + 95);
+            uint32_t q2 = sorted[63];
+            std::nth_element(sorted.begin(), sorted.begin() + 31, sorted.begin() + 63);
+            uint32_t q1 = sorted[31];
+
+            for (size_t i = 0; i < similarity_digest::BUCKET_COUNT; ++i)
+            {
+                uint32_t count = m_buckets[i];
+                uint64_t code  = count <= q1 ? 0 : count <= q2 ? 1 : count <= q3 ? 2 : 3;
+                ret.body[i / 32] |= code << (2 * (i % 32));
+            }
+            ret.checksum = m_checksum;
+            double length = static_cast<double>(m_size);
+            if (m_size <= 656)
+            {
+                ret.lvalue = static_cast<uint8_t>(static_cast<int>(std::floor(std::log(std::max(length, 1.0)) / std::log(1.5))));
+            }
+            else if (m_size <= 3199)
+            {
+                ret.lvalue = static_cast<uint8_t>(static_cast<int>(std::floor(std::log(length) / std::log(1.3) - 8.72777)));
+            }
+            else
+            {
+                ret.lvalue = static_cast<uint8_t>(static_cast<int>(std::floor(std::log(length) / std::log(1.1) - 62.5472)) & 0xFF);
+            }
+            if (q3 != 0)
+            {
+                ret.q1_ratio = static_cast<uint8_t>((static_cast<uint64_t>(q1) * 100 / q3) % 16);
+                ret.q2_ratio = static_cast<uint8_t>((static_cast<uint64_t>(q2) * 100 / q3) % 16);
+            }
+            ret.is_valid = m_size >= similarity_digest::MIN_INPUT_SIZE && q3 != 0;
+            return ret;
+        }
+        /**
+         * @brief Start over.
+         */
+        void reset()
+        {
+            *this = binary_similarity_hasher();
+        }
+    };
+
+    /**
+     * @brief Compute the similarity digest of an editor or sub-editor in one streaming pass.
+     * @param editor The editor.
+     * @return The digest; check valid().
+     */
+    inline similarity_digest compute_similarity_digest(const binary_editor &editor)
+    {
+        binary_similarity_hasher hasher;
+        hasher.update(editor);
+        return hasher.digest();
+    }
+
+    /**
+     * @brief Compute the similarity digests of many editors in parallel, one task per editor.
+     * @param editors The editors.
+     * @param pool The pool hashing the editors.
+     * @return The digests, in the order of editors.
+     */
+    inline std::vector<similarity_digest> compute_similarity_digests(std::span<const binary_editor> editors, worker_pool &pool = worker_pool::shared())
+    {
+        std::vector<similarity_digest> ret(editors.size());
+        pool.parallel_for(editors.size(), [&](size_t i) { ret[i] = compute_similarity_digest(editors[i]); });
+        return ret;
+    }
+
+    /**
+     * @brief Distance between two digests; 0 for identical content, growing with dissimilarity.
+     *
+     * The 128 bucket codes are compared 32 at a time with bitwise operations on 64-bit words: a code
+     * difference of 1 or 2 costs 1 or 2, and the maximum difference of 3 costs 6.
+     *
+     * @param lhs The first digest.
+     * @param rhs The second digest.
+     * @param includeLength False to ignore the input lengths.
+     * @return The distance.
+     */
+    inline size_t similarity_distance(const similarity_digest &lhs, const similarity_digest &rhs, const bool &includeLength = true)
+    {
+        constexpr uint64_t LOW_BITS = 0x5555555555555555ull;
+
+        size_t ret = lhs.checksum != rhs.checksum ? 1 : 0;
+        if (includeLength)
+        {
+            size_t d = detail::circular_distance(lhs.lvalue, rhs.lvalue, 256);
+            ret += d <= 1 ? d : d * 12;
+        }
+        for (const auto &[a, b] : {std::pair<size_t, size_t>{lhs.q1_ratio, rhs.q1_ratio}, {lhs.q2_ratio, rhs.q2_ratio}})
+        {
+            size_t d = detail::circular_distance(a, b, 16);
+            ret += d <= 1 ? d : (d - 1) * 12;
+        }
+        for (size_t i = 0; i < lhs.body.size(); ++i)
+        {
+            uint64_t x    = lhs.body[i] ^ rhs.body[i];
+            uint64_t low  = x & LOW_BITS;
+            uint64_t high = (x >> 1) & LOW_BITS;
+            uint64_t both = low & high;
+            // Codes differing in both bits are 0/3 (cost 6) when the code's bits are equal, else 1/2 (cost 1).
+            uint64_t extreme = both & ~(lhs.body[i] ^ (lhs.body[i] >> 1)) & LOW_BITS;
+            ret += std::popcount(low & ~high) + 2 * std::popcount(high & ~low) + 6 * std::popcount(extreme) + std::popcount(both & ~extreme);
+        }
+        return ret;
+    }
+
+    /**
+     * @brief Find all pairs of valid digests within a distance, comparing rows in parallel.
+     * @param digests The digests.
+     * @param maxDistance The maximum distance.
+     * @param pool The pool comparing the rows.
+     * @return Index pairs (i, j) with i < j, ordered by i then j.
+     */
+    inline std::vector<std::pair<size_t, size_t>> similar_pairs(std::span<const similarity_digest> digests, const size_t &maxDistance,
+                                                                worker_pool &pool = worker_pool::shared())
+    {
+        std::vector<std::vector<std::pair<size_t, size_t>>> rows(digests.size());
+        pool.parallel_for(digests.size(),
+                          [&](size_t i)
+                          {
+                              if (!digests[i].valid())
+                              {
+                                  return;
+                              }
+                              for (size_t j = i + 1; j < digests.size(); ++j)
+                              {
+                                  if (digests[j].valid() && similarity_distance(digests[i], digests[j]) <= maxDistance)
+                                  {
+                                      rows[i].emplace_back(i, j);
+                                  }
+                              }
+                          });
+        std::vector<std::pair<size_t, size_t>> ret;
+        for (const auto &row : rows)
+        {
+            ret.insert(ret.end(), row.begin(), row.end());
+        }
+        return ret;
+    }
+}
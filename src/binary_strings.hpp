@@ -0,0 +1,313 @@
+#pragma once
+#include "binary_editor.hpp"
+#include "binary_worker_pool.hpp"
+#include <bit>
+
+namespace binary
+{
+    /**
+     * @brief Encodings recognized by strings(); values may be combined with |.
+     */
+    enum class STRING_ENCODING : uint8_t
+    {
+        ASCII   = 1, ///< Printable ASCII bytes
+        UTF16LE = 2, ///< Printable ASCII characters stored as little-endian UTF-16
+        ALL     = 3  ///< Both encodings
+    };
+
+    /**
+     * @brief Combine encodings.
+     */
+    constexpr STRING_ENCODING operator|(const STRING_ENCODING &lhs, const STRING_ENCODING &rhs)
+    {
+        return static_cast<STRING_ENCODING>(static_cast<uint8_t>(lhs) | static_cast<uint8_t>(rhs));
+    }
+
+    /**
+     * @brief Check whether a set of encodings contains another.
+     */
+    constexpr bool has_encoding(const STRING_ENCODING &encodings, const STRING_ENCODING &encoding)
+    {
+        return (static_cast<uint8_t>(encodings) & static_cast<uint8_t>(encoding)) != 0;
+    }
+
+    /**
+     * @brief A string found by strings().
+     */
+    struct string_match
+    {
+        size_t          offset;   ///< Offset of the first byte
+        size_t          length;   ///< Length in bytes (two per character for UTF16LE)
+        STRING_ENCODING encoding; ///< Encoding of the string
+
+        bool operator==(const string_match &) const = default;
+    };
+
+    namespace detail
+    {
+        /**
+         * @brief Check whether a byte counts as printable: 0x20 to 0x7E, or a tab.
+         * @param value The byte.
+         * @return True if printable.
+         */
+        inline bool is_printable(const uint8_t &value)
+        {
+            return static_cast<uint8_t>(value - 0x20) < 0x5F || value == '\t';
+        }
+
+        /**
+         * @brief Classify up to 64 bytes.
+         * @param pData The bytes.
+         * @param size The number of bytes, at most 64.
+         * @param printable Receives bit i set if byte i is printable.
+         * @param zero Receives bit i set if byte i is 0.
+         */
+        inline void classify_bytes(const uint8_t *pData, const size_t &size, uint64_t &printable, uint64_t &zero)
+        {
+            printable = 0;
+            zero      = 0;
+            size_t i  = 0;
+#if defined(BINARY_EDITOR_SSE2)
+            const __m128i space = _mm_set1_epi8(0x20);
+            const __m128i range = _mm_set1_epi8(0x5E);
+            const __m128i tab   = _mm_set1_epi8('\t');
+            const __m128i nul   = _mm_setzero_si128();
+            for (; i + 16 <= size; i += 16)
+            {
+                __m128i bytes   = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pData + i));
+                __m128i shifted = _mm_sub_epi8(bytes, space);
+                __m128i isPrint = _mm_or_si128(_mm_cmpeq_epi8(_mm_min_epu8(shifted, range), shifted), _mm_cmpeq_epi8(bytes, tab));
+                printable |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(isPrint))) << i;
+                zero |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, nul)))) << i;
+            }
+#endif
+            for (; i < size; ++i)
+            {
+                printable |= static_cast<uint64_t>(is_printable(pData[i])) << i;
+                zero |= static_cast<uint64_t>(pData[i] == 0) << i;
+            }
+        }
+
+        /**
+         * @brief Gather every second bit of a mask, starting at bit first, into the low bits.
+         * @param mask The mask.
+         * @param first Index of the first bit to gather.
+         * @return The gathered bits.
+         */
+        inline uint64_t gather_alternate_bits(uint64_t mask, const size_t &first)
+        {
+            mask = (mask >> first) & 0x5555555555555555ull;
+            mask = (mask | (mask >> 1)) & 0x3333333333333333ull;
+            mask = (mask | (mask >> 2)) & 0x0F0F0F0F0F0F0F0Full;
+            mask = (mask | (mask >> 4)) & 0x00FF00FF00FF00FFull;
+            mask = (mask | (mask >> 8)) & 0x0000FFFF0000FFFFull;
+            mask = (mask | (mask >> 16)) & 0x00000000FFFFFFFFull;
+            return mask;
+        }
+
+        /**
+         * @brief Tracks runs of consecutive character units fed as bit masks.
+         */
+        class string_run_tracker
+        {
+        private:
+            static constexpr size_t NO_RUN = SIZE_MAX;
+
+            STRING_ENCODING m_encoding;
+            size_t          m_stride;
+            size_t          m_min_length;
+            size_t          m_first;
+            size_t          m_last;
+            size_t          m_run_start = NO_RUN;
+            size_t          m_run_units = 0;
+
+            /**
+             * @brief End the current run, reporting it if long enough and owned.
+             */
+            void end_run(std::vector<string_match> &matches)
+            {
+                if (m_run_units >= m_min_length && m_run_start >= m_first && m_run_start < m_last)
+                {
+                    matches.push_back({m_run_start, m_run_units * m_stride, m_encoding});
+                }
+                m_run_start = NO_RUN;
+            }
+
+        public:
+            /**
+             * @brief Construct a tracker.
+             * @param encoding The encoding reported for runs.
+             * @param stride Bytes per character unit.
+             * @param minLength Minimum run length in units.
+             * @param first Runs starting before this offset are not reported.
+             * @param last Runs starting at or after this offset are not reported.
+             */
+            string_run_tracker(const STRING_ENCODING &encoding, const size_t &stride, const size_t &minLength, const size_t &first, const size_t &last)
+                : m_encoding(encoding), m_stride(stride), m_min_length(minLength), m_first(first), m_last(last)
+            {
+            }
+            /**
+             * @brief Feed the next units.
+             * @param units Bit k set if unit k is a character.
+             * @param count Number of units, at most 64.
+             * @param offset Offset of unit 0.
+             * @param matches Receives finished runs.
+             */
+            void feed(const uint64_t &units, const size_t &count, const size_t &offset, std::vector<string_match> &matches)
+            {
+                size_t k = 0;
+                while (k < count)
+                {
+                    uint64_t rest = units >> k;
+                    if (m_run_start != NO_RUN)
+                    {
+                        size_t ones = std::min<size_t>(std::countr_one(rest), count - k);
+                        m_run_units += ones;
+                        k += ones;
+                        if (k < count)
+                        {
+                            end_run(matches);
+                        }
+                    }
+                    else
+                    {
+                        k += std::min<size_t>(std::countr_zero(rest), count - k);
+                        if (k < count)
+                        {
+                            m_run_start = offset + k * m_stride;
+                            m_run_units = 0;
+                        }
+                    }
+                }
+            }
+            /**
+             * @brief Check whether a run that may still be reported is open.
+             * @return True if so.
+             */
+            bool has_owned_run() const
+            {
+                return m_run_start != NO_RUN && m_run_start >= m_first && m_run_start < m_last;
+            }
+            /**
+             * @brief End the input.
+             * @param matches Receives the last run.
+             */
+            void finish(std::vector<string_match> &matches)
+            {
+                if (m_run_start != NO_RUN)
+                {
+                    end_run(matches);
+                }
+            }
+        };
+
+        /**
+         * @brief Find the strings starting in [first, last).
+         *
+         * Scanning starts two bytes early so that runs entering the range from the left are recognized
+         * as such, and continues past last until the runs owned by the range have ended.
+         */
+        inline std::vector<string_match> find_strings_in_range(const binary_editor &editor, const size_t &first, const size_t &last, const size_t &minLength,
+                                                               const STRING_ENCODING &encodings)
+        {
+            std::vector<string_match> ret;
+            string_run_tracker        ascii(STRING_ENCODING::ASCII, 1, minLength, first, last);
+            string_run_tracker        utf16[2] = {{STRING_ENCODING::UTF16LE, 2, minLength, first, last},
+                                                  {STRING_ENCODING::UTF16LE, 2, minLength, first, last}};
+            bool                      useAscii = has_encoding(encodings, STRING_ENCODING::ASCII);
+            bool                      useUtf16 = has_encoding(encodings, STRING_ENCODING::UTF16LE);
+            size_t                    start    = std::max<size_t>(first, 2) - 2;
+            size_t                    offset   = start;
+            uint64_t                  carry    = 0;
+
+            editor.for_each_segment(start, editor.size() - start,
+                                    [&](const uint8_t *pData, const size_t &size)
+                                    {
+                                        for (size_t done = 0; done < size;)
+                                        {
+                                            size_t   count = std::min<size_t>(size - done, 64);
+                                            uint64_t printable, zero;
+                                            classify_bytes(pData + done, count, printable, zero);
+                                            if (useAscii)
+                                            {
+                                                ascii.feed(printable, count, offset, ret);
+                                            }
+                                            if (useUtf16)
+                                            {
+                                                // Bit i: a printable byte at i - 1 followed by 0 at i,
+                                                // i.e. a character starting at offset + i - 1.
+                                                uint64_t ends = ((printable << 1) | carry) & zero;
+                                                for (size_t parity = 0; parity < 2; ++parity)
+                                                {
+                                                    // No character ends at offset 0, so start that stream one unit later.
+                                                    size_t bit = offset + parity == 0 ? parity + 2 : parity;
+                                                    if (bit < count)
+                                                    {
+                                                        size_t charStart = offset + bit - 1;
+                                                        utf16[charStart & 1].feed(gather_alternate_bits(ends, bit), (count - bit + 1) / 2, charStart, ret);
+                                                    }
+                                                }
+                                            }
+                                            carry = printable >> (count - 1);
+                                            carry &= 1;
+                                            offset += count;
+                                            done += count;
+                                            // A UTF16LE character starting at last - 1 shows up at last.
+                                            if (offset > last && !ascii.has_owned_run() && !utf16[0].has_owned_run() && !utf16[1].has_owned_run())
+                                            {
+                                                return false;
+                                            }
+                                        }
+                                        return true;
+                                    });
+            ascii.finish(ret);
+            utf16[0].finish(ret);
+            utf16[1].finish(ret);
+            return ret;
+        }
+    }
+
+    /**
+     * @brief Extract printable strings, like the Unix strings tool.
+     *
+     * The editor is split into ranges scanned in parallel; strings crossing range and chunk boundaries
+     * are reported once, by the range they start in.
+     *
+     * @param editor The editor to scan; it must not be modified while scanning.
+     * @param minLength Minimum length in characters.
+     * @param encodings Encodings to look for.
+     * @param pool The pool scanning the ranges.
+     * @param rangeSize Bytes scanned per task.
+     * @return The strings ordered by offset, ASCII before UTF16LE at the same offset.
+     */
+    inline std::vector<string_match> strings(const binary_editor &editor, const size_t &minLength = 4, const STRING_ENCODING &encodings = STRING_ENCODING::ALL,
+                                             worker_pool &pool = worker_pool::shared(), const size_t &rangeSize = DEFAULT_RANGE_SIZE)
+    {
+        return pool.parallel_gather<string_match>(editor.size(), rangeSize,
+                                                  [&](size_t first, size_t last, std::vector<string_match> &out)
+                                                  {
+                                                      out = detail::find_strings_in_range(editor, first, last, std::max<size_t>(minLength, 1), encodings);
+                                                      std::sort(out.begin(), out.end(),
+                                                                [](const string_match &lhs, const string_match &rhs)
+                                                                { return lhs.offset != rhs.offset ? lhs.offset < rhs.offset : lhs.encoding < rhs.encoding; });
+                                                  });
+    }
+
+    /**
+     * @brief Create zero-copy sub-editors for matches found in an editor.
+     * @param editor The editor the matches were found in.
+     * @param matches The matches.
+     * @return One sub-editor per match.
+     * @throws binary_exception if a match lies outside the editor.
+     */
+    inline std::vector<binary_editor> create_sub_editors(const binary_editor &editor, const std::vector<string_match> &matches)
+    {
+        std::vector<binary_editor> ret;
+        ret.reserve(matches.size());
+        for (const auto &match : matches)
+        {
+            ret.push_back(editor.create_sub_editor(match.offset, match.length));
+        }
+        return ret;
+    }
+}
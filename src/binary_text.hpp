@@ -0,0 +1,729 @@
+#pragma once
+#include "binary_editor.hpp"
+#include <array>
+#include <string_view>
+
+namespace binary
+{
+    namespace detail
+    {
+        /**
+         * @brief Marks a character outside the hex or base64 alphabet in the decode tables.
+         */
+        constexpr uint8_t TEXT_INVALID = 0xFF;
+
+        /**
+         * @brief Build the table mapping characters to hex digit values.
+         * @return The table.
+         */
+        constexpr std::array<uint8_t, 256> make_hex_table()
+        {
+            std::array<uint8_t, 256> table{};
+            for (auto &value : table)
+            {
+                value = TEXT_INVALID;
+            }
+            for (uint8_t i = 0; i < 10; ++i)
+            {
+                table['0' + i] = i;
+            }
+            for (uint8_t i = 0; i < 6; ++i)
+            {
+                table['a' + i] = 10 + i;
+                table['A' + i] = 10 + i;
+            }
+            return table;
+        }
+
+        /**
+         * @brief Base64 alphabet.
+         */
+        constexpr char BASE64_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        /**
+         * @brief Build the table mapping characters to base64 digit values.
+         * @return The table.
+         */
+        constexpr std::array<uint8_t, 256> make_base64_table()
+        {
+            std::array<uint8_t, 256> table{};
+            for (auto &value : table)
+            {
+                value = TEXT_INVALID;
+            }
+            for (uint8_t i = 0; i < 64; ++i)
+            {
+                table[static_cast<uint8_t>(BASE64_ALPHABET[i])] = i;
+            }
+            return table;
+        }
+
+        constexpr std::array<uint8_t, 256> HEX_TABLE    = make_hex_table();
+        constexpr std::array<uint8_t, 256> BASE64_TABLE = make_base64_table();
+
+        /**
+         * @brief Check whether a character is ASCII whitespace, which the decoders skip.
+         * @param c The character.
+         * @return True if c is whitespace.
+         */
+        inline bool is_text_space(const char &c)
+        {
+            return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+        }
+
+        /**
+         * @brief Encode bytes as hex digits.
+         * @param pData The bytes.
+         * @param size The number of bytes.
+         * @param pOut Receives 2 * size characters.
+         * @param upper True for upper case digits.
+         */
+        inline void encode_hex(const uint8_t *pData, const size_t &size, char *pOut, const bool &upper)
+        {
+            const char *digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+            size_t      i      = 0;
+#if defined(BINARY_EDITOR_SSE2)
+            const __m128i lowMask = _mm_set1_epi8(0x0F);
+            const __m128i nine    = _mm_set1_epi8(9);
+            const __m128i zero    = _mm_set1_epi8('0');
+            const __m128i letter  = _mm_set1_epi8(upper ? 'A' - '0' - 10 : 'a' - '0' - 10);
+            auto          toDigit = [&](const __m128i &nibbles)
+            {
+                __m128i isLetter = _mm_cmpgt_epi8(nibbles, nine);
+                return _mm_add_epi8(_mm_add_epi8(nibbles, zero), _mm_and_si128(isLetter, letter));
+            };
+            for (; i + 16 <= size; i += 16)
+            {
+                __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pData + i));
+                __m128i high  = toDigit(_mm_and_si128(_mm_srli_epi16(bytes, 4), lowMask));
+                __m128i low   = toDigit(_mm_and_si128(bytes, lowMask));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(pOut + 2 * i), _mm_unpacklo_epi8(high, low));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(pOut + 2 * i + 16), _mm_unpackhi_epi8(high, low));
+            }
+#endif
+            for (; i < size; ++i)
+            {
+                pOut[2 * i]     = digits[pData[i] >> 4];
+                pOut[2 * i + 1] = digits[pData[i] & 0x0F];
+            }
+        }
+
+        /**
+         * @brief Decode hex digit pairs until the first pair holding a character outside the alphabet.
+         * @param pText The characters.
+         * @param size The number of characters.
+         * @param pOut Receives the bytes; must hold size / 2 bytes.
+         * @return The number of characters consumed (always even).
+         */
+        inline size_t decode_hex_run(const char *pText, const size_t &size, uint8_t *pOut)
+        {
+            size_t i = 0;
+#if defined(BINARY_EDITOR_SSE2)
+            const __m128i zero      = _mm_set1_epi8('0');
+            const __m128i lowerA    = _mm_set1_epi8('a');
+            const __m128i caseBit   = _mm_set1_epi8(0x20);
+            const __m128i minusOne  = _mm_set1_epi8(-1);
+            const __m128i ten       = _mm_set1_epi8(10);
+            const __m128i six       = _mm_set1_epi8(6);
+            const __m128i lowByte   = _mm_set1_epi16(0x00FF);
+            auto          toNibbles = [&](const __m128i &chars, __m128i &nibbles)
+            {
+                // Bytes >= 0x80 end up negative or above the range in both checks.
+                __m128i digit    = _mm_sub_epi8(chars, zero);
+                __m128i isDigit  = _mm_and_si128(_mm_cmpgt_epi8(digit, minusOne), _mm_cmplt_epi8(digit, ten));
+                __m128i letter   = _mm_sub_epi8(_mm_or_si128(chars, caseBit), lowerA);
+                __m128i isLetter = _mm_and_si128(_mm_cmpgt_epi8(letter, minusOne), _mm_cmplt_epi8(letter, six));
+                nibbles          = _mm_or_si128(_mm_and_si128(isDigit, digit), _mm_and_si128(isLetter, _mm_add_epi8(letter, ten)));
+                return _mm_movemask_epi8(_mm_or_si128(isDigit, isLetter)) == 0xFFFF;
+            };
+            for (; i + 32 <= size; i += 32)
+            {
+                __m128i first, second;
+                if (!toNibbles(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pText + i)), first) ||
+                    !toNibbles(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pText + i + 16)), second))
+                {
+                    break;
+                }
+                // Each 16-bit lane holds (high nibble, low nibble) in (low byte, high byte).
+                first  = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(first, lowByte), 4), _mm_srli_epi16(first, 8));
+                second = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(second, lowByte), 4), _mm_srli_epi16(second, 8));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(pOut + i / 2), _mm_packus_epi16(first, second));
+            }
+#endif
+            for (; i + 2 <= size; i += 2)
+            {
+                uint8_t high = HEX_TABLE[static_cast<uint8_t>(pText[i])];
+                uint8_t low  = HEX_TABLE[static_cast<uint8_t>(pText[i + 1])];
+                if (((high | low) & 0xF0) != 0)
+                {
+                    break;
+                }
+                pOut[i / 2] = static_cast<uint8_t>((high << 4) | low);
+            }
+            return i;
+        }
+
+        /**
+         * @brief Encode whole 3-byte groups as base64.
+         * @param pData The bytes.
+         * @param size The number of bytes; must be a multiple of 3.
+         * @param pOut Receives size / 3 * 4 characters.
+         */
+        inline void encode_base64_groups(const uint8_t *pData, const size_t &size, char *pOut)
+        {
+            size_t i = 0;
+            size_t o = 0;
+#if defined(BINARY_EDITOR_SSSE3)
+            // Loads 16 bytes and consumes 12, so stop while 16 remain readable.
+            const __m128i shuffle  = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+            const __m128i shiftLut = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                                   '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+            for (; i + 16 <= size; i += 12, o += 16)
+            {
+                __m128i in      = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pData + i)), shuffle);
+                __m128i high    = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+                __m128i low     = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+                __m128i indices = _mm_or_si128(high, low);
+                __m128i lut     = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+                lut             = _mm_or_si128(lut, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(pOut + o), _mm_add_epi8(_mm_shuffle_epi8(shiftLut, lut), indices));
+            }
+#endif
+            for (; i < size; i += 3, o += 4)
+            {
+                uint32_t group = (static_cast<uint32_t>(pData[i]) << 16) | (static_cast<uint32_t>(pData[i + 1]) << 8) | pData[i + 2];
+                pOut[o]        = BASE64_ALPHABET[(group >> 18) & 0x3F];
+                pOut[o + 1]    = BASE64_ALPHABET[(group >> 12) & 0x3F];
+                pOut[o + 2]    = BASE64_ALPHABET[(group >> 6) & 0x3F];
+                pOut[o + 3]    = BASE64_ALPHABET[group & 0x3F];
+            }
+        }
+
+        /**
+         * @brief Encode the final 1 or 2 bytes as a padded base64 group.
+         * @param pData The bytes.
+         * @param size 1 or 2.
+         * @param pOut Receives 4 characters.
+         */
+        inline void encode_base64_tail(const uint8_t *pData, const size_t &size, char *pOut)
+        {
+            uint32_t group = static_cast<uint32_t>(pData[0]) << 16;
+            if (size > 1)
+            {
+                group |= static_cast<uint32_t>(pData[1]) << 8;
+            }
+            pOut[0] = BASE64_ALPHABET[(group >> 18) & 0x3F];
+            pOut[1] = BASE64_ALPHABET[(group >> 12) & 0x3F];
+            pOut[2] = size > 1 ? BASE64_ALPHABET[(group >> 6) & 0x3F] : '=';
+            pOut[3] = '=';
+        }
+
+        /**
+         * @brief Decode whole base64 groups until the first group holding a character outside the alphabet.
+         * @param pText The characters.
+         * @param size The number of characters.
+         * @param pOut Receives the bytes.
+         * @param capacity Bytes available at pOut.
+         * @return The number of characters consumed (always a multiple of 4).
+         */
+        inline size_t decode_base64_run(const char *pText, const size_t &size, uint8_t *pOut, const size_t &capacity)
+        {
+            size_t i = 0;
+            size_t o = 0;
+#if defined(BINARY_EDITOR_SSSE3)
+            // Stores 16 bytes and produces 12, so stop while 16 remain writable.
+            const __m128i shiftLut  = _mm_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+            const __m128i maskLut   = _mm_setr_epi8(static_cast<char>(0xA8), static_cast<char>(0xF8), static_cast<char>(0xF8), static_cast<char>(0xF8),
+                                                    static_cast<char>(0xF8), static_cast<char>(0xF8), static_cast<char>(0xF8), static_cast<char>(0xF8),
+                                                    static_cast<char>(0xF8), static_cast<char>(0xF8), static_cast<char>(0xF0), 0x54, 0x50, 0x50, 0x50, 0x54);
+            const __m128i bitLut    = _mm_setr_epi8(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, static_cast<char>(0x80), 0, 0, 0, 0, 0, 0, 0, 0);
+            const __m128i lowMask   = _mm_set1_epi8(0x0F);
+            const __m128i slash     = _mm_set1_epi8('/');
+            const __m128i pack      = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+            for (; i + 16 <= size && o + 16 <= capacity; i += 16, o += 12)
+            {
+                __m128i chars   = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pText + i));
+                __m128i high    = _mm_and_si128(_mm_srli_epi32(chars, 4), lowMask);
+                __m128i low     = _mm_and_si128(chars, lowMask);
+                __m128i isSlash = _mm_cmpeq_epi8(chars, slash);
+                __m128i invalid = _mm_cmpeq_epi8(_mm_and_si128(_mm_shuffle_epi8(maskLut, low), _mm_shuffle_epi8(bitLut, high)), _mm_setzero_si128());
+                if (_mm_movemask_epi8(invalid) != 0)
+                {
+                    break;
+                }
+                __m128i shift  = _mm_or_si128(_mm_andnot_si128(isSlash, _mm_shuffle_epi8(shiftLut, high)), _mm_and_si128(isSlash, _mm_set1_epi8(16)));
+                __m128i values = _mm_add_epi8(chars, shift);
+                __m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+                merged         = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(pOut + o), _mm_shuffle_epi8(merged, pack));
+            }
+#endif
+            for (; i + 4 <= size && o + 3 <= capacity; i += 4, o += 3)
+            {
+                uint8_t a = BASE64_TABLE[static_cast<uint8_t>(pText[i])];
+                uint8_t b = BASE64_TABLE[static_cast<uint8_t>(pText[i + 1])];
+                uint8_t c = BASE64_TABLE[static_cast<uint8_t>(pText[i + 2])];
+                uint8_t d = BASE64_TABLE[static_cast<uint8_t>(pText[i + 3])];
+                if (((a | b | c | d) & 0xC0) != 0)
+                {
+                    break;
+                }
+                uint32_t group = (static_cast<uint32_t>(a) << 18) | (static_cast<uint32_t>(b) << 12) | (static_cast<uint32_t>(c) << 6) | d;
+                pOut[o]        = static_cast<uint8_t>(group >> 16);
+                pOut[o + 1]    = static_cast<uint8_t>(group >> 8);
+                pOut[o + 2]    = static_cast<uint8_t>(group);
+            }
+            return i;
+        }
+
+        /**
+         * @brief Collects decoded bytes into fixed-size memory chunks appended to an editor.
+         */
+        class text_decode_output
+        {
+        private:
+            binary_editor             &m_output;
+            size_t                     m_chunk_size;
+            std::unique_ptr<uint8_t[]> m_pBuffer;
+            size_t                     m_used = 0;
+
+        public:
+            /**
+             * @brief Construct an output appending to an editor.
+             * @param output The editor to append to.
+             * @param chunkSize Size of the appended chunks; at least 16.
+             */
+            text_decode_output(binary_editor &output, const size_t &chunkSize)
+                : m_output(output), m_chunk_size(std::max<size_t>(chunkSize, 16)), m_pBuffer(new uint8_t[m_chunk_size])
+            {
+            }
+            /**
+             * @brief Get the free space of the current chunk, starting a new one if it is full.
+             * @return Pointer to the free space.
+             */
+            uint8_t *space()
+            {
+                if (m_used == m_chunk_size)
+                {
+                    flush();
+                }
+                return m_pBuffer.get() + m_used;
+            }
+            /**
+             * @brief Get the number of free bytes in the current chunk.
+             * @return The number of free bytes.
+             */
+            size_t capacity() const
+            {
+                return m_chunk_size - m_used;
+            }
+            /**
+             * @brief Commit bytes written to space().
+             * @param size The number of bytes written.
+             */
+            void commit(const size_t &size)
+            {
+                m_used += size;
+            }
+            /**
+             * @brief Append one byte.
+             * @param value The byte.
+             */
+            void put(const uint8_t &value)
+            {
+                *space() = value;
+                commit(1);
+            }
+            /**
+             * @brief Append the current chunk to the editor and start a new one.
+             */
+            void flush()
+            {
+                if (m_used == 0)
+                {
+                    return;
+                }
+                std::unique_ptr<const uint8_t[]> pBlob(m_pBuffer.release());
+                m_output.emplace_back(std::move(pBlob), m_used);
+                m_pBuffer.reset(new uint8_t[m_chunk_size]);
+                m_used = 0;
+            }
+        };
+    }
+
+    /**
+     * @brief Default number of characters handed to a sink per call by the streaming encoders.
+     */
+    constexpr size_t DEFAULT_TEXT_CHUNK_SIZE = 64 * 1024;
+
+    /**
+     * @brief Encode an editor as hex, handing the text to a sink chunk by chunk.
+     * @tparam Func Callable as func(std::string_view).
+     * @param editor The editor to encode.
+     * @param func The sink.
+     * @param upper True for upper case digits.
+     * @param chunkSize Maximum number of characters per call.
+     */
+    template <typename Func>
+        requires std::is_invocable_v<Func, std::string_view>
+    void to_hex(const binary_editor &editor, Func &&func, const bool &upper = false, const size_t &chunkSize = DEFAULT_TEXT_CHUNK_SIZE)
+    {
+        std::string buffer(std::max<size_t>(chunkSize, 2) / 2 * 2, '\0');
+        size_t      used = 0;
+        editor.for_each_segment(
+            [&](const uint8_t *pData, const size_t &size)
+            {
+                for (size_t done = 0; done < size;)
+                {
+                    size_t count = std::min(size - done, (buffer.size() - used) / 2);
+                    detail::encode_hex(pData + done, count, buffer.data() + used, upper);
+                    used += 2 * count;
+                    done += count;
+                    if (used == buffer.size())
+                    {
+                        func(std::string_view(buffer.data(), used));
+                        used = 0;
+                    }
+                }
+            });
+        if (used > 0)
+        {
+            func(std::string_view(buffer.data(), used));
+        }
+    }
+
+    /**
+     * @brief Encode an editor as hex.
+     * @param editor The editor to encode.
+     * @param upper True for upper case digits.
+     * @return The hex string.
+     */
+    inline std::string to_hex(const binary_editor &editor, const bool &upper = false)
+    {
+        std::string ret(2 * editor.size(), '\0');
+        size_t      used = 0;
+        editor.for_each_segment(
+            [&](const uint8_t *pData, const size_t &size)
+            {
+                detail::encode_hex(pData, size, ret.data() + used, upper);
+                used += 2 * size;
+            });
+        return ret;
+    }
+
+    /**
+     * @brief Encode an editor as padded base64, handing the text to a sink chunk by chunk.
+     * @tparam Func Callable as func(std::string_view).
+     * @param editor The editor to encode.
+     * @param func The sink.
+     * @param chunkSize Maximum number of characters per call.
+     */
+    template <typename Func>
+        requires std::is_invocable_v<Func, std::string_view>
+    void to_base64(const binary_editor &editor, Func &&func, const size_t &chunkSize = DEFAULT_TEXT_CHUNK_SIZE)
+    {
+        std::string buffer(std::max<size_t>(chunkSize, 4) / 4 * 4, '\0');
+        size_t      used = 0;
+        uint8_t     carry[3];
+        size_t      carrySize = 0;
+        auto        reserve   = [&](const size_t &count)
+        {
+            if (buffer.size() - used < count)
+            {
+                func(std::string_view(buffer.data(), used));
+                used = 0;
+            }
+        };
+        editor.for_each_segment(
+            [&](const uint8_t *pData, const size_t &size)
+            {
+                size_t done = 0;
+                // Complete the group left over from the previous segment.
+                while (carrySize > 0 && carrySize < 3 && done < size)
+                {
+                    carry[carrySize++] = pData[done++];
+                }
+                if (carrySize == 3)
+                {
+                    reserve(4);
+                    detail::encode_base64_groups(carry, 3, buffer.data() + used);
+                    used += 4;
+                    carrySize = 0;
+                }
+                while (size - done >= 3)
+                {
+                    reserve(4);
+                    size_t count = std::min((size - done) / 3, (buffer.size() - used) / 4);
+                    detail::encode_base64_groups(pData + done, 3 * count, buffer.data() + used);
+                    used += 4 * count;
+                    done += 3 * count;
+                }
+                while (done < size)
+                {
+                    carry[carrySize++] = pData[done++];
+                }
+            });
+        if (carrySize > 0)
+        {
+            reserve(4);
+            detail::encode_base64_tail(carry, carrySize, buffer.data() + used);
+            used += 4;
+        }
+        if (used > 0)
+        {
+            func(std::string_view(buffer.data(), used));
+        }
+    }
+
+    /**
+     * @brief Encode an editor as padded base64.
+     * @param editor The editor to encode.
+     * @return The base64 string.
+     */
+    inline std::string to_base64(const binary_editor &editor)
+    {
+        std::string ret;
+        ret.reserve((editor.size() + 2) / 3 * 4);
+        to_base64(editor, [&ret](std::string_view text) { ret.append(text); });
+        return ret;
+    }
+
+    /**
+     * @brief Streaming hex decoder appending the decoded bytes to an editor as memory chunks.
+     *
+     * Text may be fed in pieces of any size, split anywhere. ASCII whitespace is skipped.
+     *
+     * @code
+     * binary::binary_editor      output;
+     * binary::binary_hex_decoder decoder(output);
+     * decoder.feed("48656c");
+     * decoder.feed("6c6f");
+     * decoder.finish(); // output holds "hello"
+     * @endcode
+     */
+    class binary_hex_decoder
+    {
+    private:
+        detail::text_decode_output m_output;
+        uint8_t                    m_pending = detail::TEXT_INVALID;
+
+    public:
+        /**
+         * @brief Default size of the produced chunks.
+         */
+        static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+        /**
+         * @brief Construct a decoder appending to an editor.
+         * @param output The editor receiving the bytes; must outlive the decoder.
+         * @param chunkSize Size of the produced chunks.
+         */
+        explicit binary_hex_decoder(binary_editor &output, const size_t &chunkSize = DEFAULT_CHUNK_SIZE) : m_output(output, chunkSize)
+        {
+        }
+        /**
+         * @brief Decode a piece of text.
+         * @param text The text.
+         * @throws binary_exception if text holds a character that is neither a hex digit nor whitespace.
+         */
+        void feed(std::string_view text)
+        {
+            size_t i = 0;
+            while (i < text.size())
+            {
+                if (m_pending == detail::TEXT_INVALID)
+                {
+                    uint8_t *pOut = m_output.space();
+                    size_t   used = detail::decode_hex_run(text.data() + i, std::min(text.size() - i, 2 * m_output.capacity()), pOut);
+                    m_output.commit(used / 2);
+                    i += used;
+                    if (used > 0)
+                    {
+                        continue;
+                    }
+                }
+                char    c     = text[i++];
+                uint8_t value = detail::HEX_TABLE[static_cast<uint8_t>(c)];
+                if (value == detail::TEXT_INVALID)
+                {
+                    if (detail::is_text_space(c))
+                    {
+                        continue;
+                    }
+                    throw binary_exception("binary_hex_decoder::feed err : invalid hex character!");
+                }
+                if (m_pending == detail::TEXT_INVALID)
+                {
+                    m_pending = value;
+                }
+                else
+                {
+                    m_output.put(static_cast<uint8_t>((m_pending << 4) | value));
+                    m_pending = detail::TEXT_INVALID;
+                }
+            }
+        }
+        /**
+         * @brief Flush the remaining bytes to the editor.
+         * @throws binary_exception if an odd number of digits was fed.
+         */
+        void finish()
+        {
+            if (m_pending != detail::TEXT_INVALID)
+            {
+                throw binary_exception("binary_hex_decoder::finish err : odd number of hex digits!");
+            }
+            m_output.flush();
+        }
+    };
+
+    /**
+     * @brief Streaming base64 decoder appending the decoded bytes to an editor as memory chunks.
+     *
+     * Text may be fed in pieces of any size, split anywhere. ASCII whitespace is skipped, and the
+     * final group may be padded with '=' or left unpadded.
+     */
+    class binary_base64_decoder
+    {
+    private:
+        detail::text_decode_output m_output;
+        uint8_t                    m_group[4];
+        size_t                     m_group_size = 0;
+        size_t                     m_padding    = 0;
+
+        /**
+         * @brief Emit the bytes of a partial final group.
+         * @throws binary_exception if the group is too short.
+         */
+        void emit_partial_group()
+        {
+            if (m_group_size == 1)
+            {
+                throw binary_exception("binary_base64_decoder err : truncated base64 group!");
+            }
+            m_output.put(static_cast<uint8_t>((m_group[0] << 2) | (m_group[1] >> 4)));
+            if (m_group_size == 3)
+            {
+                m_output.put(static_cast<uint8_t>((m_group[1] << 4) | (m_group[2] >> 2)));
+            }
+        }
+
+    public:
+        /**
+         * @brief Default size of the produced chunks.
+         */
+        static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+        /**
+         * @brief Construct a decoder appending to an editor.
+         * @param output The editor receiving the bytes; must outlive the decoder.
+         * @param chunkSize Size of the produced chunks.
+         */
+        explicit binary_base64_decoder(binary_editor &output, const size_t &chunkSize = DEFAULT_CHUNK_SIZE) : m_output(output, chunkSize)
+        {
+        }
+        /**
+         * @brief Decode a piece of text.
+         * @param text The text.
+         * @throws binary_exception if text holds an invalid character or data after the padding.
+         */
+        void feed(std::string_view text)
+        {
+            size_t i = 0;
+            while (i < text.size())
+            {
+                if (m_group_size == 0 && m_padding == 0)
+                {
+                    uint8_t *pOut = m_output.space();
+                    size_t   used = detail::decode_base64_run(text.data() + i, text.size() - i, pOut, m_output.capacity());
+                    m_output.commit(used / 4 * 3);
+                    i += used;
+                    if (used > 0)
+                    {
+                        continue;
+                    }
+                }
+                char c = text[i++];
+                if (detail::is_text_space(c))
+                {
+                    continue;
+                }
+                if (c == '=')
+                {
+                    if (m_group_size < 2 || m_group_size + m_padding == 4)
+                    {
+                        throw binary_exception("binary_base64_decoder::feed err : unexpected padding!");
+                    }
+                    if (++m_padding + m_group_size == 4)
+                    {
+                        emit_partial_group();
+                    }
+                    continue;
+                }
+                uint8_t value = detail::BASE64_TABLE[static_cast<uint8_t>(c)];
+                if (value == detail::TEXT_INVALID)
+                {
+                    throw binary_exception("binary_base64_decoder::feed err : invalid base64 character!");
+                }
+                if (m_padding > 0)
+                {
+                    throw binary_exception("binary_base64_decoder::feed err : data after padding!");
+                }
+                m_group[m_group_size++] = value;
+                if (m_group_size == 4)
+                {
+                    m_output.put(static_cast<uint8_t>((m_group[0] << 2) | (m_group[1] >> 4)));
+                    m_output.put(static_cast<uint8_t>((m_group[1] << 4) | (m_group[2] >> 2)));
+                    m_output.put(static_cast<uint8_t>((m_group[2] << 6) | m_group[3]));
+                    m_group_size = 0;
+                }
+            }
+        }
+        /**
+         * @brief Decode the unpadded final group if any and flush the remaining bytes to the editor.
+         * @throws binary_exception if the input ends inside a group.
+         */
+        void finish()
+        {
+            if (m_padding > 0 && m_group_size + m_padding != 4)
+            {
+                throw binary_exception("binary_base64_decoder::finish err : incomplete padding!");
+            }
+            if (m_padding == 0 && m_group_size > 0)
+            {
+                emit_partial_group();
+            }
+            m_output.flush();
+        }
+    };
+
+    /**
+     * @brief Decode hex text into an editor holding a single memory chunk.
+     * @param text The hex text; whitespace is skipped.
+     * @return The decoded editor.
+     * @throws binary_exception if text is not valid hex.
+     */
+    inline binary_editor from_hex(std::string_view text)
+    {
+        binary_editor      ret;
+        binary_hex_decoder decoder(ret, text.size() / 2);
+        decoder.feed(text);
+        decoder.finish();
+        return ret;
+    }
+
+    /**
+     * @brief Decode base64 text into an editor holding a single memory chunk.
+     * @param text The base64 text; whitespace is skipped.
+     * @return The decoded editor.
+     * @throws binary_exception if text is not valid base64.
+     */
+    inline binary_editor from_base64(std::string_view text)
+    {
+        binary_editor         ret;
+        binary_base64_decoder decoder(ret, text.size() / 4 * 3 + 16);
+        decoder.feed(text);
+        decoder.finish();
+        return ret;
+    }
+}
@@ -0,0 +1,258 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace binary
+{
+    /**
+     * @brief Default number of elements per task of the parallel range algorithms, see worker_pool::parallel_for_ranges().
+     */
+    constexpr size_t DEFAULT_RANGE_SIZE = 1024 * 1024;
+
+    /**
+     * @brief Fixed set of worker threads running submitted tasks in FIFO order.
+     *
+     * Threads waiting in parallel_for() run queued tasks themselves instead of idling, so parallel_for() may be
+     * called from inside a task without starving the pool.
+     *
+     * @code
+     * binary::worker_pool pool(4);
+     * auto future = pool.submit([] { return 42; });
+     * pool.parallel_for(ranges.size(), [&](size_t i) { scan(ranges[i]); });
+     * @endcode
+     */
+    class worker_pool
+    {
+    public:
+        /**
+         * @brief Smallest range handed to a task by parallel_for_ranges(), so tiny range sizes do not flood the queue.
+         */
+        static constexpr size_t MIN_RANGE_SIZE = 64;
+
+    private:
+        std::vector<std::thread>          m_threads;
+        std::mutex                        m_mutex;
+        std::condition_variable           m_not_empty;
+        std::deque<std::function<void()>> m_tasks;
+        bool                              m_stop = false;
+
+        /**
+         * @brief Run one queued task on the calling thread.
+         * @return False if the queue was empty.
+         */
+        bool run_pending_task()
+        {
+            std::function<void()> task;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_tasks.empty())
+                {
+                    return false;
+                }
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            task();
+            return true;
+        }
+
+    public:
+        /**
+         * @brief Start the worker threads.
+         * @param threadCount Number of threads, 0 for one per hardware thread.
+         */
+        explicit worker_pool(size_t threadCount = 0)
+        {
+            if (threadCount == 0)
+            {
+                threadCount = std::max(1u, std::thread::hardware_concurrency());
+            }
+            for (size_t i = 0; i < threadCount; ++i)
+            {
+                m_threads.emplace_back(
+                    [this]
+                    {
+                        while (true)
+                        {
+                            std::function<void()> task;
+                            {
+                                std::unique_lock<std::mutex> lock(m_mutex);
+                                m_not_empty.wait(lock, [this]
+                                                 { return m_stop || !m_tasks.empty(); });
+                                if (m_tasks.empty())
+                                {
+                                    return;
+                                }
+                                task = std::move(m_tasks.front());
+                                m_tasks.pop_front();
+                            }
+                            task();
+                        }
+                    });
+            }
+        }
+        /**
+         * @brief Finish the queued tasks and join the threads.
+         */
+        ~worker_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_not_empty.notify_all();
+            for (auto &thread : m_threads)
+            {
+                thread.join();
+            }
+        }
+        /**
+         * @brief Get the number of worker threads.
+         * @return The number of threads.
+         */
+        size_t size() const
+        {
+            return m_threads.size();
+        }
+        /**
+         * @brief Queue a task.
+         * @tparam Func Callable without arguments.
+         * @param func The task.
+         * @return Future receiving the result or exception of the task.
+         */
+        template <typename Func>
+        std::future<std::invoke_result_t<Func &>> submit(Func &&func)
+        {
+            using result_type = std::invoke_result_t<Func &>;
+            auto pTask        = std::make_shared<std::packaged_task<result_type()>>(std::forward<Func>(func));
+            auto future       = pTask->get_future();
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_tasks.emplace_back([pTask]
+                                     { (*pTask)(); });
+            }
+            m_not_empty.notify_one();
+            return future;
+        }
+        /**
+         * @brief Wait for a future, running queued tasks while it is not ready.
+         * @tparam T The result type.
+         * @param future The future.
+         * @return The result of the future.
+         */
+        template <typename T>
+        T wait(std::future<T> &future)
+        {
+            while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            {
+                if (!run_pending_task())
+                {
+                    future.wait();
+                }
+            }
+            return future.get();
+        }
+        /**
+         * @brief Run func(i) for every i in [0, count) on the pool and wait for all of them.
+         * @tparam Func Callable as func(size_t i).
+         * @param count Number of iterations.
+         * @param func The body.
+         * @throws Rethrows the first exception thrown by an iteration, after all iterations finished.
+         */
+        template <typename Func>
+        void parallel_for(const size_t &count, Func &&func)
+        {
+            std::vector<std::future<void>> futures;
+            futures.reserve(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                futures.push_back(submit([&func, i]
+                                         { func(i); }));
+            }
+            std::exception_ptr pError;
+            for (auto &future : futures)
+            {
+                try
+                {
+                    wait(future);
+                }
+                catch (...)
+                {
+                    if (!pError)
+                    {
+                        pError = std::current_exception();
+                    }
+                }
+            }
+            if (pError)
+            {
+                std::rethrow_exception(pError);
+            }
+        }
+        /**
+         * @brief Split [0, size) into ranges and run func(first, last) for every range on the pool.
+         * @tparam Func Callable as func(size_t first, size_t last).
+         * @param size Number of elements.
+         * @param rangeSize Elements per range, at least MIN_RANGE_SIZE.
+         * @param func The body.
+         * @throws Rethrows the first exception thrown by a range, after all ranges finished.
+         */
+        template <typename Func>
+        void parallel_for_ranges(const size_t &size, const size_t &rangeSize, Func &&func)
+        {
+            size_t step = std::max(rangeSize, MIN_RANGE_SIZE);
+            parallel_for((size + step - 1) / step, [&](size_t i) { func(i * step, std::min(size, (i + 1) * step)); });
+        }
+        /**
+         * @brief Like parallel_for_ranges(), each range appending to its own vector, concatenated in range order.
+         * @tparam T The element type of the result.
+         * @tparam Func Callable as func(size_t first, size_t last, std::vector<T> &out).
+         * @param size Number of elements.
+         * @param rangeSize Elements per range, at least MIN_RANGE_SIZE.
+         * @param func The body.
+         * @return The outputs of all ranges.
+         * @throws Rethrows the first exception thrown by a range, after all ranges finished.
+         */
+        template <typename T, typename Func>
+        std::vector<T> parallel_gather(const size_t &size, const size_t &rangeSize, Func &&func)
+        {
+            size_t                      step = std::max(rangeSize, MIN_RANGE_SIZE);
+            std::vector<std::vector<T>> results((size + step - 1) / step);
+            parallel_for(results.size(), [&](size_t i) { func(i * step, std::min(size, (i + 1) * step), results[i]); });
+
+            std::vector<T> ret;
+            for (auto &result : results)
+            {
+                ret.insert(ret.end(), std::make_move_iterator(result.begin()), std::make_move_iterator(result.end()));
+            }
+            return ret;
+        }
+        /**
+         * @brief Get the process-wide pool used when no pool is passed explicitly.
+         * @return Reference to the shared pool.
+         */
+        static worker_pool &shared()
+        {
+            static worker_pool instance;
+            return instance;
+        }
+
+        /**
+         * @brief Deleted copy constructor.
+         */
+        worker_pool(const worker_pool &) = delete;
+        /**
+         * @brief Deleted copy assignment operator.
+         */
+        worker_pool &operator=(const worker_pool &) = delete;
+    };
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "../src/binary_editor.hpp"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// 各單元測試共用的輔助函式
+
+// 每 pieceSize 個位元組切成一個區塊, 模擬零散的編輯結果
+inline binary::binary_editor split_editor(const std::vector<uint8_t>& blob, size_t pieceSize)
+{
+    binary::binary_editor editor;
+    for (size_t offset = 0; offset < blob.size(); offset += pieceSize)
+    {
+        editor.emplace_back(blob.data() + offset, std::min(pieceSize, blob.size() - offset));
+    }
+    return editor;
+}
+
+inline binary::binary_editor split_editor(const std::string& text, size_t pieceSize)
+{
+    binary::binary_editor editor;
+    for (size_t offset = 0; offset < text.size(); offset += pieceSize)
+    {
+        editor.emplace_back(reinterpret_cast<const uint8_t*>(text.data()) + offset, std::min(pieceSize, text.size() - offset));
+    }
+    return editor;
+}
+
+inline std::vector<uint8_t> to_vector(const binary::binary_editor& editor)
+{
+    std::vector<uint8_t> ret;
+    editor.for_each_segment([&ret](const uint8_t* pData, const size_t& size) { ret.insert(ret.end(), pData, pData + size); });
+    return ret;
+}
+
+inline std::string to_string(const binary::binary_editor& editor)
+{
+    std::string ret;
+    editor.for_each_segment([&ret](const uint8_t* pData, const size_t& size) { ret.append(reinterpret_cast<const char*>(pData), size); });
+    return ret;
+}
+
+inline size_t chunk_count(const binary::binary_editor& editor)
+{
+    size_t ret = 0;
+    editor.for_each_chunk([&ret](const auto&) { ++ret; });
+    return ret;
+}
+
+// 暴力搜尋的參考結果
+inline std::vector<size_t> reference_find_all(const std::vector<uint8_t>& blob, const std::vector<uint8_t>& needle, size_t offset = 0)
+{
+    std::vector<size_t> ret;
+    for (size_t i = offset; i + needle.size() <= blob.size(); ++i)
+    {
+        if (std::equal(needle.begin(), needle.end(), blob.begin() + i))
+        {
+            ret.push_back(i);
+        }
+    }
+    return ret;
+}
+
+// 以線性同餘產生器產生可重現的資料, 值域為 [0, alphabet)
+inline std::vector<uint8_t> make_random(size_t size, uint32_t seed, size_t alphabet = 256)
+{
+    std::vector<uint8_t> blob(size);
+    for (auto& value : blob)
+    {
+        seed  = seed * 1103515245u + 12345u;
+        value = static_cast<uint8_t>((seed >> 16) % alphabet);
+    }
+    return blob;
+}
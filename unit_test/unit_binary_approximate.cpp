@@ -0,0 +1,99 @@
+#include "../src/binary_approximate.hpp"
+#include "test_util.hpp"
+#include <gtest/gtest.h>
+
+using namespace binary;
+
+static std::vector<approximate_match> reference_hamming(const std::vector<uint8_t>& blob, const std::vector<uint8_t>& pattern, size_t k)
+{
+    std::vector<approximate_match> ret;
+    for (size_t i = 0; i + pattern.size() <= blob.size(); ++i)
+    {
+        size_t mismatches = 0;
+        for (size_t j = 0; j < pattern.size(); ++j)
+        {
+            mismatches += blob[i + j] != pattern[j];
+        }
+        if (mismatches <= k)
+        {
+            ret.push_back({i, mismatches});
+        }
+    }
+    return ret;
+}
+
+static std::vector<approximate_match> reference_edit_distance(const std::vector<uint8_t>& blob, const std::vector<uint8_t>& pattern, size_t k)
+{
+    // Sellers 動態規劃: 第一列全為 0, 允許從任何位置開始
+    std::vector<size_t> column(pattern.size() + 1);
+    for (size_t i = 0; i <= pattern.size(); ++i)
+    {
+        column[i] = i;
+    }
+    std::vector<approximate_match> ret;
+    for (size_t j = 0; j < blob.size(); ++j)
+    {
+        size_t diagonal = column[0];
+        column[0]       = 0;
+        for (size_t i = 1; i <= pattern.size(); ++i)
+        {
+            size_t up = column[i];
+            column[i] = std::min({up + 1, column[i - 1] + 1, diagonal + (pattern[i - 1] != blob[j])});
+            diagonal  = up;
+        }
+        if (column[pattern.size()] <= k)
+        {
+            ret.push_back({j + 1, column[pattern.size()]});
+        }
+    }
+    return ret;
+}
+
+TEST(BinaryApproximateTest, Hamming)
+{
+    worker_pool pool(3);
+    auto        blob = make_random(3000, 1, 3);
+    for (size_t patternSize : {1, 5, 17, 40})
+    {
+        auto pattern = make_random(patternSize, static_cast<uint32_t>(patternSize), 3);
+        for (size_t k : {0, 1, 3, 8})
+        {
+            auto expect = reference_hamming(blob, pattern, k);
+            for (size_t pieceSize : {1, 7, 4000})
+            {
+                EXPECT_EQ(find_hamming(split_editor(blob, pieceSize), pattern, k, pool, 100), expect) << patternSize << " " << k << " " << pieceSize;
+            }
+        }
+    }
+    EXPECT_TRUE(find_hamming(split_editor(blob, 10), std::vector<uint8_t>(4000, 0), 0, pool).empty());
+    EXPECT_THROW(find_hamming(split_editor(blob, 10), std::vector<uint8_t>(), 0, pool), binary_exception);
+}
+
+TEST(BinaryApproximateTest, EditDistance)
+{
+    worker_pool pool(3);
+    auto        blob = make_random(3000, 2, 4);
+    for (size_t patternSize : {1, 6, 20, 64})
+    {
+        auto pattern = make_random(patternSize, static_cast<uint32_t>(patternSize) + 3, 4);
+        for (size_t k : {0, 1, 2, 5})
+        {
+            auto expect = reference_edit_distance(blob, pattern, k);
+            for (size_t pieceSize : {1, 7, 4000})
+            {
+                EXPECT_EQ(find_edit_distance(split_editor(blob, pieceSize), pattern, k, pool, 100), expect) << patternSize << " " << k << " " << pieceSize;
+            }
+        }
+    }
+    // 插入一個位元組後仍以距離 1 找到
+    std::vector<uint8_t> text = {'x', 'x', 's', 'i', 'g', 'Z', 'n', 'a', 't', 'u', 'r', 'e', 'x'};
+    std::vector<uint8_t> word = {'s', 'i', 'g', 'n', 'a', 't', 'u', 'r', 'e'};
+    EXPECT_EQ(find_edit_distance(split_editor(text, 2), word, 1, pool), std::vector<approximate_match>({{12, 1}}));
+    EXPECT_THROW(find_edit_distance(split_editor(text, 2), std::vector<uint8_t>(65, 0), 1, pool), binary_exception);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
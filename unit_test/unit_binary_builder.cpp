@@ -0,0 +1,77 @@
+#include "../src/binary_builder.hpp"
+#include "test_util.hpp"
+#include <gtest/gtest.h>
+
+using namespace binary;
+
+enum class chunk_kind : uint16_t
+{
+    DATA = 0x0102
+};
+
+// 編譯期組合的標頭
+static constexpr auto HEADER = writer::blob_builder<>()
+                                   .append_string("RIFF")
+                                   .append<std::endian::little>(uint32_t{0x11223344})
+                                   .append<std::endian::big>(uint16_t{0xABCD})
+                                   .append<std::endian::big>(chunk_kind::DATA)
+                                   .append(int8_t{-1})
+                                   .align<4>(0xEE)
+                                   .append<std::endian::big>(1.0f)
+                                   .append_bytes(std::array<uint8_t, 2>{7, 8})
+                                   .append_padding<3>()
+                                   .bytes();
+
+static_assert(HEADER.size() == 4 + 4 + 2 + 2 + 1 + 3 + 4 + 2 + 3);
+static_assert(HEADER[0] == 'R' && HEADER[3] == 'F');
+static_assert(HEADER[4] == 0x44 && HEADER[7] == 0x11);
+static_assert(HEADER[8] == 0xAB && HEADER[9] == 0xCD);
+static_assert(HEADER[10] == 0x01 && HEADER[11] == 0x02);
+static_assert(HEADER[12] == 0xFF && HEADER[13] == 0xEE && HEADER[15] == 0xEE);
+static_assert(HEADER[16] == 0x3F && HEADER[17] == 0x80 && HEADER[19] == 0x00);
+static_assert(writer::blob_builder<>().append(uint64_t{1}).align<8>().size() == 8);
+
+TEST(BinaryBuilderTest, MatchesRuntimeLayout)
+{
+    std::vector<uint8_t> expect = {'R', 'I', 'F', 'F', 0x44, 0x33, 0x22, 0x11, 0xAB, 0xCD, 0x01, 0x02, 0xFF, 0xEE, 0xEE, 0xEE, 0x3F, 0x80, 0x00, 0x00, 7, 8, 0, 0, 0};
+    EXPECT_EQ(std::vector<uint8_t>(HEADER.begin(), HEADER.end()), expect);
+
+    // 執行期也能使用
+    uint32_t value   = 0xDEADBEEF;
+    auto     runtime = writer::blob_builder<>().append<std::endian::big>(value).append<std::endian::little>(value).bytes();
+    EXPECT_EQ(runtime, (std::array<uint8_t, 8>{0xDE, 0xAD, 0xBE, 0xEF, 0xEF, 0xBE, 0xAD, 0xDE}));
+}
+
+TEST(BinaryBuilderTest, StaticChunkIsZeroCopy)
+{
+    binary_editor editor = writer::make_static_editor(HEADER);
+    ASSERT_EQ(editor.size(), HEADER.size());
+    editor.for_each_chunk(
+        [&](const std::shared_ptr<binary_chunk_interface>& pChunk)
+        {
+            EXPECT_EQ(pChunk->get_type(), CHUNK_TYPE::STATIC);
+            EXPECT_EQ(pChunk->get_data(), HEADER.data());
+        });
+
+    // 與其他區塊混合並切出子編輯器
+    writer::write_back(editor, uint8_t{0x42});
+    writer::write_back_static(editor, HEADER);
+    ASSERT_EQ(editor.size(), 2 * HEADER.size() + 1);
+    auto bytes = to_vector(editor);
+    EXPECT_TRUE(std::equal(HEADER.begin(), HEADER.end(), bytes.begin()));
+    EXPECT_EQ(bytes[HEADER.size()], 0x42);
+    EXPECT_TRUE(std::equal(HEADER.begin(), HEADER.end(), bytes.begin() + HEADER.size() + 1));
+
+    auto sub = editor.create_sub_editor(2, 5);
+    EXPECT_EQ(to_vector(sub), std::vector<uint8_t>(HEADER.begin() + 2, HEADER.begin() + 7));
+    sub.for_each_chunk([&](const std::shared_ptr<binary_chunk_interface>& pChunk) { EXPECT_EQ(pChunk->get_data(), HEADER.data() + 2); });
+
+    EXPECT_EQ(writer::make_static_editor(std::span<const uint8_t>()).size(), 0);
+    EXPECT_THROW(binary_chunk_static(nullptr, 0), binary_exception);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,91 @@
+#include "../src/binary_channels.hpp"
+#include "test_util.hpp"
+#include <gtest/gtest.h>
+
+using namespace binary;
+
+struct rgb
+{
+    uint8_t red, green, blue;
+
+    bool operator==(const rgb&) const = default;
+};
+
+template <typename T>
+static void check_round_trip(size_t channelCount)
+{
+    worker_pool pool(3);
+    size_t      frameCount = 1000;
+    size_t      offset     = 5;
+    auto        blob       = make_random(offset + frameCount * channelCount * sizeof(T) + 3, static_cast<uint32_t>(channelCount * 31 + sizeof(T)));
+
+    // 逐元素的參考結果
+    std::vector<std::vector<T>> expect(channelCount, std::vector<T>(frameCount));
+    for (size_t i = 0; i < frameCount; ++i)
+    {
+        for (size_t c = 0; c < channelCount; ++c)
+        {
+            memcpy(&expect[c][i], blob.data() + offset + (i * channelCount + c) * sizeof(T), sizeof(T));
+        }
+    }
+
+    for (size_t pieceSize : {1, 7, 64, 4096})
+    {
+        for (size_t rangeSize : {size_t{1}, size_t{1000}, DEFAULT_RANGE_SIZE})
+        {
+            auto                        editor = split_editor(blob, pieceSize);
+            std::vector<std::vector<T>> buffers(channelCount, std::vector<T>(frameCount));
+            std::vector<T*>             channels;
+            std::vector<const T*>       sources;
+            for (auto& buffer : buffers)
+            {
+                channels.push_back(buffer.data());
+                sources.push_back(buffer.data());
+            }
+            deinterleave<T>(editor, offset, channels, frameCount, pool, rangeSize);
+            EXPECT_EQ(buffers, expect) << channelCount << " " << sizeof(T) << " " << pieceSize << " " << rangeSize;
+
+            // 交錯回單一區塊
+            auto merged = interleave<T>(sources, frameCount, pool, rangeSize);
+            ASSERT_EQ(merged.size(), frameCount * channelCount * sizeof(T));
+            size_t chunks = 0;
+            merged.for_each_chunk([&](const auto&) { ++chunks; });
+            EXPECT_EQ(chunks, 1);
+            std::vector<uint8_t> bytes;
+            merged.for_each_segment([&](const uint8_t* pData, const size_t& size) { bytes.insert(bytes.end(), pData, pData + size); });
+            EXPECT_TRUE(std::equal(bytes.begin(), bytes.end(), blob.begin() + offset)) << channelCount << " " << sizeof(T);
+        }
+    }
+}
+
+TEST(BinaryChannelsTest, RoundTrip)
+{
+    for (size_t channelCount : {1, 2, 3, 4, 5})
+    {
+        check_round_trip<uint8_t>(channelCount);
+        check_round_trip<int16_t>(channelCount);
+        check_round_trip<int32_t>(channelCount);
+        check_round_trip<uint64_t>(channelCount);
+        check_round_trip<rgb>(channelCount);
+    }
+}
+
+TEST(BinaryChannelsTest, InvalidArguments)
+{
+    auto                  blob   = make_random(100, 1);
+    auto                  editor = split_editor(blob, 10);
+    std::vector<uint16_t> left(25), right(25);
+    std::vector<uint16_t*> channels = {left.data(), right.data()};
+    EXPECT_NO_THROW(deinterleave<uint16_t>(editor, 0, channels, 25));
+    EXPECT_THROW(deinterleave<uint16_t>(editor, 4, channels, 25), binary_exception);
+    EXPECT_THROW(deinterleave<uint16_t>(editor, 101, channels, 0), binary_exception);
+    EXPECT_THROW(deinterleave<uint16_t>(editor, 0, std::span<uint16_t* const>(), 1), binary_exception);
+    EXPECT_THROW(interleave<uint16_t>(std::span<const uint16_t* const>(), 1), binary_exception);
+    EXPECT_EQ(interleave<uint16_t>(std::vector<const uint16_t*>{left.data()}, 0).size(), 0);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,218 @@
+#include "../src/binary_compress.hpp"
+#include "../src/binary_file.hpp"
+#include "test_util.hpp"
+#include <gtest/gtest.h>
+
+using namespace binary;
+
+static std::vector<uint8_t> make_sample(size_t size)
+{
+    // 可壓縮但不單調的資料
+    std::vector<uint8_t> blob(size);
+    uint32_t             state = 12345;
+    for (size_t i = 0; i < size; ++i)
+    {
+        state   = state * 1103515245u + 12345u;
+        blob[i] = static_cast<uint8_t>("abcdefgh"[(state >> 16) % 8] + (i / 4096) % 3);
+    }
+    return blob;
+}
+
+static std::vector<uint8_t> gzip(const std::vector<uint8_t>& blob)
+{
+    z_stream strm{};
+    deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 31, 8, Z_DEFAULT_STRATEGY);
+    std::vector<uint8_t> ret(deflateBound(&strm, static_cast<uLong>(blob.size())) + 64);
+    strm.next_in   = const_cast<Bytef*>(blob.data());
+    strm.avail_in  = static_cast<uInt>(blob.size());
+    strm.next_out  = ret.data();
+    strm.avail_out = static_cast<uInt>(ret.size());
+    deflate(&strm, Z_FINISH);
+    ret.resize(strm.total_out);
+    deflateEnd(&strm);
+    return ret;
+}
+
+TEST(BinaryInflateIndexTest, EagerDecompression)
+{
+    auto          blob       = make_sample(400000);
+    binary_editor compressed = split_editor(gzip(blob), 1000);
+
+    binary_editor image;
+    auto          pIndex = binary_inflate_index::build(compressed, 16 * 1024, &image);
+    EXPECT_EQ(pIndex->size(), blob.size());
+    EXPECT_GT(pIndex->span_count(), 2);
+    EXPECT_EQ(to_vector(image), blob);
+}
+
+TEST(BinaryInflateIndexTest, LazyRandomAccess)
+{
+    auto          blob       = make_sample(400000);
+    binary_editor compressed = split_editor(gzip(blob), 777);
+
+    auto          pIndex = binary_inflate_index::build(compressed, 16 * 1024, nullptr, 2);
+    binary_editor lazy   = pIndex->create_editor();
+    EXPECT_EQ(lazy.size(), blob.size());
+
+    // 隨機讀取只解壓最近的 checkpoint
+    std::vector<size_t>   offsets = {399990, 5, 250000, 123456, 65535, 16383, 300001};
+    std::vector<uint64_t> values(offsets.size());
+    lazy.read_many<uint64_t>(offsets, values);
+    for (size_t i = 0; i < offsets.size(); ++i)
+    {
+        uint64_t expected;
+        memcpy(&expected, blob.data() + offsets[i], sizeof(expected));
+        EXPECT_EQ(values[i], expected);
+    }
+
+    binary_editor sub = lazy.create_sub_editor(200000, 50000);
+    EXPECT_TRUE(std::equal(blob.begin() + 200000, blob.begin() + 250000, to_vector(sub).begin()));
+    EXPECT_EQ(to_vector(lazy), blob);
+}
+
+TEST(BinaryInflateIndexTest, ReadersOutliveCacheEviction)
+{
+    auto          blob       = make_sample(400000);
+    binary_editor compressed = split_editor(gzip(blob), 777);
+    auto          pIndex     = binary_inflate_index::build(compressed, 16 * 1024, nullptr, 2);
+    binary_editor lazy       = pIndex->create_editor();
+    ASSERT_GT(pIndex->span_count(), 4);
+
+    // 讀取器保留區塊內的指標, 之後走訪的區間超過快取容量
+    size_t                                   first = pIndex->get_checkpoint(1).out_offset;
+    binary_editor                            span  = lazy.create_sub_editor(first, 1000);
+    reader::binary_container_reader<uint8_t> container(span, 0, 1000);
+    reader::binary_reader<uint32_t>          value(span, 8);
+    EXPECT_EQ(to_vector(lazy), blob);
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        EXPECT_EQ(container[i], blob[first + i]);
+    }
+    uint32_t expected;
+    memcpy(&expected, blob.data() + first + 8, sizeof(expected));
+    EXPECT_EQ(value.get(), expected);
+}
+
+TEST(BinaryInflateIndexTest, ScanKeepsResidentSpansBounded)
+{
+    auto          blob       = make_sample(400000);
+    binary_editor compressed = split_editor(gzip(blob), 777);
+    auto          pIndex     = binary_inflate_index::build(compressed, 16 * 1024, nullptr, 2);
+    binary_editor lazy       = pIndex->create_editor();
+    ASSERT_GT(pIndex->span_count(), 4);
+
+    // 完整走訪後只剩快取中的區段
+    EXPECT_EQ(to_vector(lazy), blob);
+    EXPECT_LE(pIndex->resident_span_count(), 2);
+
+    // 讀取器持有自己的區段, 其餘仍受快取容量限制
+    size_t                                   first = pIndex->get_checkpoint(1).out_offset;
+    reader::binary_container_reader<uint8_t> container(lazy, first, 100);
+    EXPECT_EQ(to_vector(lazy), blob);
+    EXPECT_LE(pIndex->resident_span_count(), 3);
+    EXPECT_EQ(container[99], blob[first + 99]);
+}
+
+TEST(BinaryInflateIndexTest, ConcatenatedMembers)
+{
+    // 兩個 gzip 成員串接, 都要解壓
+    std::vector<uint8_t> first  = {'h', 'e', 'l', 'l', 'o', ' '};
+    std::vector<uint8_t> second = {'w', 'o', 'r', 'l', 'd'};
+    auto                 compressed = gzip(first);
+    auto                 tail       = gzip(second);
+    compressed.insert(compressed.end(), tail.begin(), tail.end());
+
+    binary_editor image;
+    auto          pIndex = binary_inflate_index::build(split_editor(compressed, 7), 1024, &image);
+    ASSERT_EQ(pIndex->size(), 11);
+    EXPECT_EQ(pIndex->span_count(), 2);
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(image.get_data()), image.size()), "hello world");
+
+    binary_editor lazy = pIndex->create_editor();
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(lazy.create_sub_editor(4, 4).get_data()), 4), "o wo");
+
+    // 較大的成員, 邊界落在 span 中間
+    auto blob  = make_sample(100000);
+    auto large = gzip(std::vector<uint8_t>(blob.begin(), blob.begin() + 40000));
+    tail       = gzip(std::vector<uint8_t>(blob.begin() + 40000, blob.end()));
+    large.insert(large.end(), tail.begin(), tail.end());
+    pIndex = binary_inflate_index::build(split_editor(large, 777), 16 * 1024, nullptr, 2);
+    EXPECT_EQ(to_vector(pIndex->create_editor()), blob);
+
+    // 成員後面接著無效資料
+    large.push_back(0xFF);
+    EXPECT_THROW(binary_inflate_index::build(binary_editor(large.data(), large.size())), binary_exception);
+}
+
+TEST(BinaryInflateIndexTest, CorruptStream)
+{
+    auto compressed = gzip(make_sample(10000));
+    compressed.resize(compressed.size() / 2);
+    EXPECT_THROW(binary_inflate_index::build(binary_editor(compressed.data(), compressed.size())), binary_exception);
+}
+
+TEST(BinarySeekableDeflateTest, SaveAndOpenLazily)
+{
+    auto          blob   = make_sample(300000);
+    binary_editor editor = split_editor(blob, 4999);
+
+    worker_pool        pool(3);
+    std::ostringstream out;
+    binary_seekable_deflate::save(editor, out, 32 * 1024, Z_BEST_SPEED, pool);
+    std::string saved = out.str();
+    EXPECT_LT(saved.size(), blob.size());
+
+    // 寫成檔案後以 file source 延遲開啟
+    auto path = (std::filesystem::temp_directory_path() / "binary_editor_seekable.besd").string();
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(saved.data(), saved.size());
+    }
+    auto          pSource = std::make_shared<binary_file_source>(path, 10000);
+    binary_editor image   = binary_seekable_deflate::open(binary_editor(pSource), 2);
+    EXPECT_EQ(image.size(), blob.size());
+
+    std::vector<size_t>   offsets = {299992, 0, 32767, 32768, 150000};
+    std::vector<uint64_t> values(offsets.size());
+    image.read_many<uint64_t>(offsets, values);
+    for (size_t i = 0; i < offsets.size(); ++i)
+    {
+        uint64_t expected;
+        memcpy(&expected, blob.data() + offsets[i], sizeof(expected));
+        EXPECT_EQ(values[i], expected);
+    }
+    EXPECT_EQ(to_vector(image), blob);
+    std::filesystem::remove(path);
+}
+
+TEST(BinarySeekableDeflateTest, EmptyAndInvalid)
+{
+    std::ostringstream out;
+    binary_seekable_deflate::save(binary_editor(), out);
+    std::string saved = out.str();
+    EXPECT_EQ(saved.size(), binary_seekable_deflate::FOOTER_SIZE);
+    EXPECT_EQ(binary_seekable_deflate::open(binary_editor(reinterpret_cast<const uint8_t*>(saved.data()), saved.size())).size(), 0);
+
+    saved.back() = 'X';
+    EXPECT_THROW(binary_seekable_deflate::open(binary_editor(reinterpret_cast<const uint8_t*>(saved.data()), saved.size())), binary_exception);
+
+    // 索引中的解壓大小不可信, 開啟時就要拒絕
+    auto blob = make_sample(10000);
+    out.str("");
+    binary_seekable_deflate::save(binary_editor(blob.data(), blob.size()), out, 4096);
+    std::string valid = out.str();
+    size_t      index = valid.size() - binary_seekable_deflate::FOOTER_SIZE - 3 * 2 * sizeof(uint64_t);
+    EXPECT_EQ(to_vector(binary_seekable_deflate::open(binary_editor(reinterpret_cast<const uint8_t*>(valid.data()), valid.size()))), blob);
+    for (auto [block, rawSize] : {std::pair<size_t, uint64_t>{0, uint64_t{1} << 40}, {1, 4095}, {2, 4097}, {2, 0}})
+    {
+        saved = valid;
+        memcpy(saved.data() + index + block * 2 * sizeof(uint64_t) + sizeof(uint64_t), &rawSize, sizeof(rawSize));
+        EXPECT_THROW(binary_seekable_deflate::open(binary_editor(reinterpret_cast<const uint8_t*>(saved.data()), saved.size())), binary_exception) << block;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
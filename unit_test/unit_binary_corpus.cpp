@@ -0,0 +1,92 @@
+#include "../src/binary_corpus.hpp"
+#include "test_util.hpp"
+#include <gtest/gtest.h>
+
+using namespace binary;
+
+TEST(BinaryCorpusTest, IntersectSorted)
+{
+    // 與 std::set_intersection 比較, 包含長度不足一個向量的情形
+    for (uint32_t seed = 1; seed < 30; ++seed)
+    {
+        std::vector<uint32_t> lhs, rhs;
+        for (uint32_t value = 0; value < 500; ++value)
+        {
+            seed = seed * 1103515245u + 12345u;
+            if ((seed >> 16) % 3 == 0)
+            {
+                lhs.push_back(value);
+            }
+            if ((seed >> 20) % (1 + seed % 7) == 0)
+            {
+                rhs.push_back(value);
+            }
+        }
+        lhs.resize(lhs.size() - seed % 5);
+        std::vector<uint32_t> expect;
+        std::set_intersection(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(expect));
+        std::vector<uint32_t> out(lhs.size());
+        out.resize(detail::intersect_sorted(lhs.data(), lhs.size(), rhs.data(), rhs.size(), out.data()));
+        EXPECT_EQ(out, expect);
+        // 輸出與輸入重疊
+        lhs.resize(detail::intersect_sorted(lhs.data(), lhs.size(), rhs.data(), rhs.size(), lhs.data()));
+        EXPECT_EQ(lhs, expect);
+    }
+}
+
+TEST(BinaryCorpusTest, FindMatchesBruteForce)
+{
+    // 多個編輯器, 部分植入相同簽章
+    std::vector<std::vector<uint8_t>> blobs;
+    std::vector<binary_editor>        editors;
+    std::vector<uint8_t>              signature = {0x48, 0x8B, 0x05, 0xDE, 0xAD, 0xBE, 0xEF, 0x90};
+    for (uint32_t i = 0; i < 60; ++i)
+    {
+        blobs.push_back(make_random(100 + i * 37, i + 1, i % 2 == 0 ? 8 : 256));
+    }
+    for (uint32_t i = 0; i < 60; i += 7)
+    {
+        std::copy(signature.begin(), signature.end(), blobs[i].begin() + i);
+    }
+    for (uint32_t i = 0; i < 60; ++i)
+    {
+        editors.push_back(split_editor(blobs[i], 1 + i % 5));
+    }
+    editors.push_back(binary_editor());
+
+    worker_pool         pool(3);
+    binary_corpus_index index(editors, pool);
+    EXPECT_EQ(index.editor_count(), 61);
+    EXPECT_GT(index.gram_count(), 0);
+    EXPECT_GT(index.posting_size(), 0);
+
+    auto reference = [&](const std::vector<uint8_t>& pattern)
+    {
+        std::vector<uint32_t> ret;
+        for (uint32_t i = 0; i < blobs.size(); ++i)
+        {
+            if (std::search(blobs[i].begin(), blobs[i].end(), pattern.begin(), pattern.end()) != blobs[i].end())
+            {
+                ret.push_back(i);
+            }
+        }
+        return ret;
+    };
+    std::vector<std::vector<uint8_t>> patterns = {signature, {0x05, 0xDE}, {1, 2, 3, 4}, {7, 7, 7, 7, 7}, std::vector<uint8_t>(blobs[3].begin() + 50, blobs[3].begin() + 70)};
+    for (const auto& pattern : patterns)
+    {
+        auto expect     = reference(pattern);
+        auto candidates = index.candidates(pattern);
+        EXPECT_TRUE(std::includes(candidates.begin(), candidates.end(), expect.begin(), expect.end()));
+        EXPECT_EQ(index.find(pattern, pool), expect) << pattern.size();
+    }
+    EXPECT_EQ(index.candidates(signature).size(), 9);
+    EXPECT_TRUE(index.find(std::vector<uint8_t>{0xFF, 0xFE, 0xFD, 0xFC, 0xFB}, pool).empty());
+    EXPECT_TRUE(index.find(std::vector<uint8_t>{}, pool).empty());
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
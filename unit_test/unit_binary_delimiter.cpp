@@ -0,0 +1,105 @@
+#include "../src/binary_delimiter.hpp"
+#include "test_util.hpp"
+#include <gtest/gtest.h>
+
+using namespace binary;
+
+static std::vector<std::string> reference_split(const std::string& text, char delimiter)
+{
+    std::vector<std::string> ret(1);
+    for (char c : text)
+    {
+        if (c == delimiter)
+        {
+            ret.emplace_back();
+        }
+        else
+        {
+            ret.back() += c;
+        }
+    }
+    return ret;
+}
+
+static std::string make_lines(size_t count)
+{
+    std::string text;
+    for (size_t i = 0; i < count; ++i)
+    {
+        text += "line " + std::to_string(i) + std::string(i % 70, '.') + "\n";
+    }
+    return text;
+}
+
+TEST(BinaryDelimiterTest, Split)
+{
+    EXPECT_EQ(split(binary_editor(), '\n').size(), 1);
+    for (size_t pieceSize : {1, 7, 100, 100000})
+    {
+        std::string text   = make_lines(500) + "tail";
+        auto        tokens = split(split_editor(text, pieceSize), '\n');
+        auto        expect = reference_split(text, '\n');
+        ASSERT_EQ(tokens.size(), expect.size());
+        for (size_t i = 0; i < tokens.size(); ++i)
+        {
+            EXPECT_EQ(to_string(tokens[i]), expect[i]);
+        }
+    }
+    // 連續與結尾的分隔字元產生空的 token
+    auto tokens = split(split_editor(std::string("a\0\0b\0", 5), 2), '\0');
+    ASSERT_EQ(tokens.size(), 4);
+    EXPECT_EQ(tokens[1].size(), 0);
+    EXPECT_EQ(to_string(tokens[2]), "b");
+    EXPECT_EQ(tokens[3].size(), 0);
+}
+
+TEST(BinaryDelimiterTest, IndexFollowsEdits)
+{
+    std::string            text   = make_lines(300);
+    binary_editor          editor = split_editor(text, 1000);
+    binary_delimiter_index lines(editor, '\n');
+    EXPECT_EQ(lines.token_count(), 301);
+    EXPECT_EQ(to_string(lines.token(42)), reference_split(text, '\n')[42]);
+    EXPECT_EQ(lines.token(300).size(), 0);
+    EXPECT_THROW(lines.token(301), binary_exception);
+
+    // 插入與附加後索引自動更新
+    std::string header = "header\nsecond";
+    std::string footer = "\nfooter";
+    editor.insert(2500, split_editor(header, 5));
+    editor.push_back(split_editor(footer, 3));
+    text.insert(2500, header);
+    text += footer;
+    auto expect = reference_split(text, '\n');
+    ASSERT_EQ(lines.token_count(), expect.size());
+    for (size_t i = 0; i < expect.size(); ++i)
+    {
+        EXPECT_EQ(to_string(lines.token(i)), expect[i]) << i;
+    }
+
+    // 同一個區塊出現兩次, 各自以所在位置計算
+    binary_editor repeated = split_editor(std::string("a\nb\n"), 100);
+    editor.push_back(repeated);
+    editor.push_back(repeated);
+    text += "a\nb\na\nb\n";
+    std::vector<size_t> positions;
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        if (text[i] == '\n')
+        {
+            positions.push_back(i);
+        }
+    }
+    EXPECT_EQ(lines.positions(), positions);
+    EXPECT_EQ(to_string(lines.token(lines.token_count() - 2)), "b");
+
+    editor.clear();
+    EXPECT_EQ(lines.token_count(), 1);
+    EXPECT_TRUE(lines.positions().empty());
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
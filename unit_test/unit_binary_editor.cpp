@@ -127,6 +127,236 @@ TEST(BinaryEditorTest, TidyChunks)
     }
 }
 
+TEST(BinaryEditorTest, SubEditorAcrossChunks)
+{
+    std::vector<uint8_t> blob1 = {0, 1, 2, 3, 4};
+    std::vector<uint8_t> blob2 = {5, 6, 7, 8, 9};
+    binary_editor        editor(blob1.data(), blob1.size());
+    editor.emplace_back(blob2.data(), blob2.size());
+
+    // 跨 chunk 取子範圍
+    binary_editor  sub  = editor.create_sub_editor(3, 5);
+    const uint8_t* data = static_cast<const uint8_t*>(sub.get_data());
+    EXPECT_EQ((std::vector<uint8_t>(data, data + 5)), (std::vector<uint8_t>{3, 4, 5, 6, 7}));
+    EXPECT_THROW(editor.create_sub_editor(8, 3), binary_exception);
+}
+
+TEST(BinaryEditorTest, SubEditorOfSubEditor)
+{
+    std::vector<uint8_t> blob1 = {0, 1, 2, 3, 4};
+    std::vector<uint8_t> blob2 = {5, 6, 7, 8, 9};
+    binary_editor        editor(blob1.data(), blob1.size());
+    editor.emplace_back(blob2.data(), blob2.size());
+
+    // 子範圍的子範圍需保留父層的 offset
+    binary_editor  sub    = editor.create_sub_editor(3, 5);
+    binary_editor  subSub = sub.create_sub_editor(1, 3);
+    const uint8_t* data   = static_cast<const uint8_t*>(subSub.get_data());
+    EXPECT_EQ((std::vector<uint8_t>(data, data + 3)), (std::vector<uint8_t>{4, 5, 6}));
+}
+
+TEST(BinaryEditorTest, NonThrowingVariants)
+{
+    std::vector<uint8_t> blob = {0, 1, 2, 3, 4, 5};
+    binary_editor        editor(blob.data(), blob.size());
+
+    EXPECT_FALSE(editor.try_create_sub_editor(4, 3).has_value());
+    EXPECT_FALSE(editor.try_create_sub_editor(SIZE_MAX, 2).has_value());
+    auto sub = editor.try_create_sub_editor(2, 3);
+    ASSERT_TRUE(sub.has_value());
+    EXPECT_EQ(sub->size(), 3);
+
+    EXPECT_FALSE(editor.try_insert(7, *sub));
+    EXPECT_EQ(editor.size(), 6);
+    EXPECT_TRUE(editor.try_insert(6, *sub));
+    EXPECT_EQ(editor.size(), 9);
+
+    binary_chunk_factory factory;
+    EXPECT_EQ(factory.try_create_chunk(nullptr, 4), nullptr);
+    EXPECT_EQ(factory.try_create_chunk(std::make_unique<uint8_t[]>(4), 4, 5), nullptr);
+    EXPECT_NE(factory.try_create_chunk(std::make_unique<uint8_t[]>(4), 4), nullptr);
+
+    binary_container_reader<uint8_t> container(editor, 1, 4);
+    EXPECT_EQ(container.try_at(0), std::optional<uint8_t>(1));
+    EXPECT_EQ(container.try_at(4), std::nullopt);
+    EXPECT_EQ(container.unchecked_at(3), 4);
+    static_assert(noexcept(container.unchecked_at(0)));
+}
+
+TEST(BinaryEditorTest, ReadMany)
+{
+    std::vector<uint8_t> blob(64);
+    std::iota(blob.begin(), blob.end(), uint8_t{0});
+    binary_editor editor(blob.data(), 10);
+    editor.emplace_back(blob.data() + 10, 3);
+    editor.emplace_back(blob.data() + 13, 51);
+
+    // 未排序且跨 chunk 的讀取
+    std::vector<size_t>   offsets = {40, 8, 0, 11, 60, 8, 20, 9, 33, 1, 50, 12};
+    std::vector<uint32_t> values(offsets.size());
+    editor.read_many<uint32_t>(offsets, values);
+    for (size_t i = 0; i < offsets.size(); ++i)
+    {
+        uint32_t expected;
+        memcpy(&expected, blob.data() + offsets[i], sizeof(uint32_t));
+        EXPECT_EQ(values[i], expected);
+    }
+
+    std::vector<size_t> outOfRange = {61};
+    EXPECT_THROW(editor.read_many<uint32_t>(outOfRange, std::span<uint32_t>(values.data(), 1)), binary_exception);
+    EXPECT_THROW(editor.read_many<uint32_t>(offsets, std::span<uint32_t>(values.data(), 1)), binary_exception);
+}
+
+TEST(BinaryEditorTest, ForEachSegment)
+{
+    std::vector<uint8_t> blob(300);
+    std::iota(blob.begin(), blob.end(), uint8_t{0});
+    binary_editor editor(blob.data(), 100);
+    editor.emplace_back(blob.data() + 100, 150);
+    editor.emplace_back(blob.data() + 250, 50);
+
+    // 走訪跨 chunk 的範圍
+    std::vector<uint8_t> collected;
+    std::vector<size_t>  sizes;
+    editor.for_each_segment(90, 200,
+                            [&](const uint8_t* pData, const size_t& size)
+                            {
+                                collected.insert(collected.end(), pData, pData + size);
+                                sizes.push_back(size);
+                            });
+    EXPECT_EQ(sizes, (std::vector<size_t>{10, 150, 40}));
+    EXPECT_TRUE(std::equal(collected.begin(), collected.end(), blob.begin() + 90));
+
+    // 回傳 false 提前結束, 關閉 prefetch 不影響結果
+    editor.set_prefetch_distance(0);
+    size_t visited = 0;
+    editor.for_each_segment(
+        [&](const uint8_t*, const size_t&)
+        {
+            ++visited;
+            return false;
+        });
+    EXPECT_EQ(visited, 1);
+    EXPECT_THROW(editor.for_each_segment(250, 51, [](const uint8_t*, const size_t&) {}), binary_exception);
+
+    // 反向走訪
+    editor.set_prefetch_distance(2);
+    std::vector<uint8_t> reversed;
+    sizes.clear();
+    editor.for_each_segment_reverse(90, 200,
+                                    [&](const uint8_t* pData, const size_t& size)
+                                    {
+                                        reversed.insert(reversed.begin(), pData, pData + size);
+                                        sizes.push_back(size);
+                                    });
+    EXPECT_EQ(sizes, (std::vector<size_t>{40, 150, 10}));
+    EXPECT_EQ(reversed, collected);
+    visited = 0;
+    editor.for_each_segment_reverse(0, 300,
+                                    [&](const uint8_t* pData, const size_t&)
+                                    {
+                                        ++visited;
+                                        return *pData != 100;
+                                    });
+    EXPECT_EQ(visited, 2);
+    EXPECT_THROW(editor.for_each_segment_reverse(250, 51, [](const uint8_t*, const size_t&) {}), binary_exception);
+}
+
+TEST(BinaryEditorTest, ChunkSummary)
+{
+    std::vector<uint8_t> blob(8000, 'a');
+    blob[10]   = 'x';
+    blob[11]   = 'y';
+    blob[7000] = 'z';
+    binary_editor editor(blob.data(), blob.size());
+
+    std::vector<size_t> sizes;
+    editor.for_each_chunk_segment(5, 7000,
+                                  [&](const binary_chunk_interface& chunk, const uint8_t*, const size_t& size)
+                                  {
+                                      // 只查詢快取時不計算
+                                      EXPECT_EQ(chunk.try_summary(false), nullptr);
+                                      auto pSummary = chunk.summary();
+                                      EXPECT_EQ(chunk.try_summary(false), pSummary);
+                                      EXPECT_TRUE(pSummary->contains('z'));
+                                      EXPECT_FALSE(pSummary->contains('b'));
+                                      EXPECT_TRUE(pSummary->may_contain(std::vector<uint8_t>{'a', 'x', 'y', 'a'}));
+                                      EXPECT_FALSE(pSummary->may_contain(std::vector<uint8_t>{'a', 'b'}));
+                                      // 快取的摘要在 chunk 不變時重複使用
+                                      EXPECT_EQ(chunk.summary(), pSummary);
+                                      sizes.push_back(size);
+                                  });
+    EXPECT_EQ(sizes, std::vector<size_t>{7000});
+
+    // 子 chunk 重新計算自己的摘要
+    auto sub = editor.create_sub_editor(100, 1000);
+    sub.for_each_chunk(
+        [](const std::shared_ptr<binary_chunk_interface>& pChunk)
+        {
+            EXPECT_FALSE(pChunk->summary()->contains('z'));
+            EXPECT_FALSE(pChunk->summary()->contains('x'));
+        });
+}
+
+TEST(BinaryEditorTest, ClusteredEdits)
+{
+    // 在游標附近連續插入, 與平面 vector 比對
+    std::vector<uint8_t> expected(64);
+    std::iota(expected.begin(), expected.end(), uint8_t{0});
+    binary_editor editor(expected.data(), expected.size());
+
+    size_t cursor = 20;
+    for (uint8_t i = 0; i < 50; ++i)
+    {
+        std::vector<uint8_t> piece = {static_cast<uint8_t>(200 + i), static_cast<uint8_t>(i)};
+        binary_editor        pieceEditor(piece.data(), 1);
+        pieceEditor.emplace_back(piece.data() + 1, 1);
+        editor.insert(cursor, pieceEditor);
+        expected.insert(expected.begin() + cursor, piece.begin(), piece.end());
+        cursor += (i % 3 == 0) ? 1 : 2;
+
+        // 交錯查詢另一個 editor 與回頭取子範圍, finger 必須隨之失效或移動
+        binary_editor other(expected.data(), 8);
+        EXPECT_EQ(other.create_sub_editor(4, 2).size(), 2);
+        binary_editor  sub  = editor.create_sub_editor(cursor - 5, 4);
+        const uint8_t* data = static_cast<const uint8_t*>(sub.get_data());
+        EXPECT_TRUE(std::equal(data, data + 4, expected.begin() + (cursor - 5)));
+    }
+    EXPECT_EQ(editor.size(), expected.size());
+    const uint8_t* data = static_cast<const uint8_t*>(editor.get_data());
+    EXPECT_TRUE(std::equal(data, data + expected.size(), expected.begin()));
+
+    // 清空後重新使用
+    editor.clear();
+    EXPECT_EQ(editor.size(), 0);
+    EXPECT_FALSE(editor.try_create_sub_editor(0, 1).has_value());
+}
+
+TEST(BinaryEditorTest, MoveLeavesEmpty)
+{
+    std::vector<uint8_t> blob(100);
+    std::iota(blob.begin(), blob.end(), uint8_t{0});
+    binary_editor editor(blob.data(), 40);
+    editor.emplace_back(blob.data() + 40, 60);
+    EXPECT_EQ(editor.create_sub_editor(50, 2).size(), 2);
+
+    // 移出後的 editor 是空的, 可以繼續使用
+    binary_editor moved(std::move(editor));
+    EXPECT_EQ(editor.size(), 0);
+    EXPECT_FALSE(editor.try_create_sub_editor(0, 1).has_value());
+    EXPECT_EQ(*static_cast<const uint8_t*>(moved.create_sub_editor(50, 1).get_data()), 50);
+    editor.emplace_back(blob.data(), 3);
+    EXPECT_EQ(editor.size(), 3);
+    EXPECT_EQ(*static_cast<const uint8_t*>(editor.create_sub_editor(2, 1).get_data()), 2);
+
+    binary_editor assigned;
+    assigned = std::move(moved);
+    EXPECT_EQ(moved.size(), 0);
+    EXPECT_FALSE(moved.try_create_sub_editor(0, 1).has_value());
+    EXPECT_EQ(assigned.size(), 100);
+    EXPECT_EQ(*static_cast<const uint8_t*>(assigned.create_sub_editor(99, 1).get_data()), 99);
+}
+
 TEST(BinaryContainerReaderTest, BasicUsage)
 {
     std::vector<uint8_t>             blob = {10, 20, 30, 40, 50, 60, 70, 80};
@@ -0,0 +1,217 @@
+#include "../src/binary_file.hpp"
+#include <gtest/gtest.h>
+
+using namespace binary;
+using namespace reader;
+using namespace writer;
+
+static std::string write_temp_file(const std::string& name, const std::vector<uint8_t>& blob)
+{
+    auto          path = (std::filesystem::temp_directory_path() / name).string();
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(blob.data()), blob.size());
+    return path;
+}
+
+TEST(BinaryFileSourceTest, IncrementalReload)
+{
+    std::vector<uint8_t> blob = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    auto                 path = write_temp_file("binary_editor_reload.bin", blob);
+
+    auto          pSource = std::make_shared<binary_file_source>(path, 4);
+    binary_editor editor(pSource);
+    EXPECT_EQ(editor.size(), 10);
+    auto pUntouched = pSource->get_block(0);
+
+    // 使用者在 offset 2 插入資料
+    uint8_t v = 99;
+    write_at(editor, 2, v);
+
+    // 外部工具修改第二個 block 並在尾端追加
+    blob[5] = 55;
+    blob.push_back(10);
+    blob.push_back(11);
+    write_temp_file("binary_editor_reload.bin", blob);
+
+    auto changes = pSource->refresh();
+    EXPECT_EQ(changes.old_size, 10);
+    EXPECT_EQ(changes.new_size, 12);
+    ASSERT_EQ(changes.modified.size(), 2);
+    EXPECT_EQ(changes.modified[0], (std::pair<size_t, size_t>{4, 4}));
+    EXPECT_EQ(changes.modified[1], (std::pair<size_t, size_t>{8, 2}));
+    EXPECT_EQ(pSource->get_block(0), pUntouched);
+
+    EXPECT_EQ(editor.apply_file_changes(pSource, changes), 0);
+    EXPECT_EQ(editor.size(), 13);
+    const uint8_t* data = static_cast<const uint8_t*>(editor.get_data());
+    EXPECT_EQ((std::vector<uint8_t>(data, data + 13)), (std::vector<uint8_t>{0, 1, 99, 2, 3, 4, 55, 6, 7, 8, 9, 10, 11}));
+    std::filesystem::remove(path);
+}
+
+TEST(BinaryFileSourceTest, TruncationConflict)
+{
+    std::vector<uint8_t> blob = {0, 1, 2, 3, 4, 5, 6, 7};
+    auto                 path = write_temp_file("binary_editor_truncate.bin", blob);
+
+    auto          pSource = std::make_shared<binary_file_source>(path, 4);
+    binary_editor editor(pSource);
+
+    write_temp_file("binary_editor_truncate.bin", {0, 1, 2, 3, 4, 5});
+    auto changes = pSource->refresh();
+
+    // 被截斷的 block 保留舊資料
+    EXPECT_EQ(editor.apply_file_changes(pSource, changes), 1);
+    EXPECT_EQ(editor.size(), 8);
+    std::filesystem::remove(path);
+}
+
+TEST(BinaryFileSourceTest, FollowGrowingFile)
+{
+    auto path = write_temp_file("binary_editor_follow.bin", {0, 1, 2, 3, 4, 5});
+
+    auto                   pSource = std::make_shared<binary_file_source>(path, 4);
+    binary_editor          editor(pSource);
+    binary_reader<uint8_t> last(editor, 8);
+    auto                   pTailBlock = pSource->get_block(1);
+
+    // 檔案持續成長
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+        const uint8_t more[] = {6, 7, 8, 9, 10};
+        file.write(reinterpret_cast<const char*>(more), sizeof(more));
+    }
+    auto changes = pSource->follow();
+    EXPECT_EQ(changes.old_size, 6);
+    EXPECT_EQ(changes.new_size, 11);
+    EXPECT_TRUE(changes.modified.empty());
+
+    // 最後一個 block 就地延伸
+    EXPECT_EQ(pSource->get_block(1), pTailBlock);
+    EXPECT_EQ(pTailBlock->size, 4);
+    EXPECT_EQ(pSource->block_count(), 3);
+
+    EXPECT_EQ(editor.apply_file_changes(pSource, changes), 0);
+    EXPECT_EQ(editor.size(), 11);
+    EXPECT_EQ(last.get(), 8);
+
+    // 之後的 refresh 不會把延伸過的 block 視為修改
+    EXPECT_TRUE(pSource->refresh().empty());
+
+    // 讀取器已把編輯器合併成記憶體區塊, 仍要繼續追蹤
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+        const uint8_t more[] = {11, 12, 13};
+        file.write(reinterpret_cast<const char*>(more), sizeof(more));
+    }
+    changes = pSource->follow();
+    EXPECT_EQ(editor.apply_file_changes(pSource, changes), 0);
+    ASSERT_EQ(editor.size(), 14);
+    const uint8_t* data = static_cast<const uint8_t*>(editor.get_data());
+    EXPECT_EQ((std::vector<uint8_t>(data, data + 14)), (std::vector<uint8_t>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13}));
+
+    // 合併後又被編輯, 不再追加
+    write_at(editor, 0, uint8_t{99});
+    ASSERT_EQ(editor.size(), 15);
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+        file.put(14);
+    }
+    EXPECT_EQ(editor.apply_file_changes(pSource, pSource->follow()), 0);
+    EXPECT_EQ(editor.size(), 15);
+    std::filesystem::remove(path);
+}
+
+TEST(BinaryFileSourceTest, FollowEmptyFile)
+{
+    auto path = write_temp_file("binary_editor_follow_empty.bin", {});
+
+    auto          pSource = std::make_shared<binary_file_source>(path, 4);
+    binary_editor editor(pSource);
+    EXPECT_EQ(editor.size(), 0);
+
+    // 開啟時為空檔案, 之後成長
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+        const uint8_t more[] = {1, 2, 3, 4, 5};
+        file.write(reinterpret_cast<const char*>(more), sizeof(more));
+    }
+    EXPECT_EQ(editor.apply_file_changes(pSource, pSource->follow()), 0);
+    ASSERT_EQ(editor.size(), 5);
+    std::vector<uint8_t> bytes;
+    editor.for_each_segment([&](const uint8_t* pData, const size_t& size) { bytes.insert(bytes.end(), pData, pData + size); });
+    EXPECT_EQ(bytes, (std::vector<uint8_t>{1, 2, 3, 4, 5}));
+    std::filesystem::remove(path);
+}
+
+TEST(BinaryFileWatcherTest, DetectsModification)
+{
+    auto                path = write_temp_file("binary_editor_watch.bin", {1, 2, 3});
+    binary_file_watcher watcher(path);
+    EXPECT_FALSE(watcher.poll());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    write_temp_file("binary_editor_watch.bin", {1, 2, 3, 4});
+    EXPECT_TRUE(watcher.wait(std::chrono::milliseconds(1000)));
+    std::filesystem::remove(path);
+}
+
+TEST(BinaryFileWatcherTest, FollowsReplacedFile)
+{
+    auto                path = write_temp_file("binary_editor_watch_replace.bin", {1, 2, 3});
+    auto                old  = path + ".old";
+    binary_file_watcher watcher(path);
+
+    // 原檔被改名移走, 路徑上換成新檔
+    std::filesystem::rename(path, old);
+    write_temp_file("binary_editor_watch_replace.bin", {4, 5});
+    EXPECT_TRUE(watcher.wait(std::chrono::milliseconds(1000)));
+
+    // 舊檔的監看已移除, 只回報新檔的變更
+    write_temp_file("binary_editor_watch_replace.bin.old", {6});
+    EXPECT_FALSE(watcher.poll());
+    write_temp_file("binary_editor_watch_replace.bin", {7, 8, 9});
+    EXPECT_TRUE(watcher.wait(std::chrono::milliseconds(1000)));
+    std::filesystem::remove(path);
+    std::filesystem::remove(old);
+}
+
+TEST(BinaryFileWatcherTest, FollowsRecreatedFile)
+{
+    auto                path = write_temp_file("binary_editor_watch_recreate.bin", {1, 2, 3});
+    binary_file_watcher watcher(path);
+
+    // 檔案被刪除, 監看隨之失效
+    std::filesystem::remove(path);
+    EXPECT_TRUE(watcher.wait(std::chrono::milliseconds(1000)));
+    while (watcher.poll())
+    {
+    }
+    EXPECT_FALSE(watcher.wait(std::chrono::milliseconds(50)));
+
+    // poll() 在檔案重新出現時回報變更, 之後監看新檔
+    write_temp_file("binary_editor_watch_recreate.bin", {4, 5});
+    EXPECT_TRUE(watcher.poll());
+    write_temp_file("binary_editor_watch_recreate.bin", {6});
+    EXPECT_TRUE(watcher.wait(std::chrono::milliseconds(1000)));
+
+    // wait() 在檔案不存在時持續等待它重新出現
+    std::filesystem::remove(path);
+    while (watcher.poll())
+    {
+    }
+    std::thread writer(
+        []
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            write_temp_file("binary_editor_watch_recreate.bin", {7, 8});
+        });
+    EXPECT_TRUE(watcher.wait(std::chrono::milliseconds(1000)));
+    writer.join();
+    std::filesystem::remove(path);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include "../src/binary_fm_index.hpp"
+#include "test_util.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace binary;
+
+static std::vector<uint8_t> make_sample(size_t size, uint32_t seed, size_t alphabet)
+{
+    std::vector<uint8_t> blob(size);
+    for (auto& value : blob)
+    {
+        seed  = seed * 1103515245u + 12345u;
+        value = static_cast<uint8_t>((seed >> 16) % alphabet * 97);
+    }
+    return blob;
+}
+
+static size_t reference_longest_repeat(const std::vector<uint8_t>& blob)
+{
+    size_t best = 0;
+    for (size_t i = 0; i < blob.size(); ++i)
+    {
+        for (size_t j = i + 1; j < blob.size(); ++j)
+        {
+            size_t common = 0;
+            while (j + common < blob.size() && blob[i + common] == blob[j + common])
+            {
+                ++common;
+            }
+            best = std::max(best, common);
+        }
+    }
+    return best;
+}
+
+TEST(BinaryFmIndexTest, SuffixArrayMatchesSort)
+{
+    // 與直接排序所有後綴的結果比較, 包含重複度高的文字
+    for (auto blob : {make_sample(500, 1, 2), make_sample(500, 2, 5), make_sample(500, 3, 256), std::vector<uint8_t>(300, 7), std::vector<uint8_t>{}})
+    {
+        std::vector<size_t> suffixes(blob.size() + 1);
+        detail::sais(detail::sais_byte_text{blob.data(), blob.size()}, suffixes.size(), 257, suffixes.data());
+        std::vector<size_t> expect(blob.size() + 1);
+        std::iota(expect.begin(), expect.end(), size_t{0});
+        std::sort(expect.begin(), expect.end(),
+                  [&](size_t lhs, size_t rhs) { return std::lexicographical_compare(blob.begin() + lhs, blob.end(), blob.begin() + rhs, blob.end()); });
+        EXPECT_EQ(suffixes, expect) << blob.size();
+
+        // 就地轉成 Φ: 每個後綴在排序中前一個後綴的位置
+        detail::suffix_predecessors(suffixes);
+        for (size_t row = 1; row < expect.size(); ++row)
+        {
+            EXPECT_EQ(suffixes[expect[row]], expect[row - 1]);
+        }
+        EXPECT_EQ(suffixes[blob.size()], detail::SAIS_EMPTY);
+    }
+}
+
+TEST(BinaryFmIndexTest, CountLocateAndRepeat)
+{
+    worker_pool pool(3);
+    for (size_t alphabet : {2, 4, 256})
+    {
+        auto blob = make_sample(2000, static_cast<uint32_t>(alphabet), alphabet);
+        for (size_t sampleRate : {1, 5, 32})
+        {
+            binary_fm_index index(split_editor(blob, 77), sampleRate, pool);
+            EXPECT_EQ(index.size(), blob.size());
+            for (size_t start : {0, 100, 1990})
+            {
+                for (size_t length : {1, 3, 10})
+                {
+                    std::vector<uint8_t> pattern(blob.begin() + start, blob.begin() + start + length);
+                    auto                 expect = reference_find_all(blob, pattern);
+                    EXPECT_EQ(index.count(pattern), expect.size());
+                    EXPECT_EQ(index.locate(pattern), expect) << alphabet << " " << sampleRate << " " << start << " " << length;
+                }
+            }
+            EXPECT_EQ(index.count(std::vector<uint8_t>{1, 2, 3, 4, 5, 6, 7, 8}), 0);
+            EXPECT_EQ(index.count(std::vector<uint8_t>{}), 0);
+            EXPECT_EQ(index.locate(std::vector<uint8_t>{blob[0]}, 2).size(), 2);
+
+            auto [offset, length] = index.longest_repeat();
+            EXPECT_EQ(length, reference_longest_repeat(blob));
+            std::vector<uint8_t> repeat(blob.begin() + offset, blob.begin() + offset + length);
+            EXPECT_GE(reference_find_all(blob, repeat).size(), 2);
+        }
+    }
+}
+
+TEST(BinaryFmIndexTest, LargeInputAcrossSuperblocks)
+{
+    // 超過一個 superblock, 並植入重複片段
+    auto blob = make_sample(300000, 9, 256);
+    std::copy(blob.begin() + 1000, blob.begin() + 1100, blob.begin() + 250000);
+    binary_fm_index index(split_editor(blob, 65536));
+    for (size_t start : {0, 70000, 131071, 250000, 299990})
+    {
+        std::vector<uint8_t> pattern(blob.begin() + start, blob.begin() + start + 6);
+        EXPECT_EQ(index.locate(pattern), reference_find_all(blob, pattern)) << start;
+    }
+    EXPECT_EQ(index.longest_repeat().second, 100);
+    EXPECT_EQ(index.locate(std::vector<uint8_t>(blob.begin() + 1000, blob.begin() + 1100)), std::vector<size_t>({1000, 250000}));
+}
+
+TEST(BinaryFmIndexTest, SaveAndLoad)
+{
+    auto            blob = make_sample(5000, 4, 3);
+    binary_fm_index index(split_editor(blob, 999), 8);
+
+    std::stringstream stream;
+    index.save(stream);
+    auto loaded = binary_fm_index::load(stream);
+    EXPECT_EQ(loaded.size(), index.size());
+    EXPECT_EQ(loaded.sample_rate(), 8);
+    EXPECT_EQ(loaded.longest_repeat(), index.longest_repeat());
+    std::vector<uint8_t> pattern(blob.begin() + 10, blob.begin() + 17);
+    EXPECT_EQ(loaded.locate(pattern), index.locate(pattern));
+
+    // 截斷或損毀的索引
+    std::string bytes = stream.str();
+    std::stringstream truncated(bytes.substr(0, bytes.size() - 1));
+    EXPECT_THROW(binary_fm_index::load(truncated), binary_exception);
+    std::string corrupt = bytes;
+    corrupt[0]          = 'X';
+    std::stringstream corrupted(corrupt);
+    EXPECT_THROW(binary_fm_index::load(corrupted), binary_exception);
+
+    // 標頭的大小超過資料流長度
+    for (uint64_t size : {uint64_t{1} << 40, uint64_t{1} << 62, uint64_t{5001}})
+    {
+        std::string bad = bytes;
+        for (size_t k = 0; k < 8; ++k)
+        {
+            bad[8 + k] = static_cast<char>(size >> (8 * k));
+        }
+        std::stringstream badStream(bad);
+        EXPECT_THROW(binary_fm_index::load(badStream), binary_exception) << size;
+    }
+
+    // 損毀的 BWT 只能丟出 binary_exception
+    const size_t bwtOffset = 8 + 5 * 8;
+    for (size_t i = 0; i <= blob.size(); i += 97)
+    {
+        std::string bad = bytes;
+        bad[bwtOffset + i] = static_cast<char>(bad[bwtOffset + i] + 1);
+        std::stringstream badStream(bad);
+        try
+        {
+            auto damaged = binary_fm_index::load(badStream);
+            damaged.locate(pattern);
+            damaged.locate(std::vector<uint8_t>(blob.begin(), blob.begin() + 2));
+        }
+        catch (const binary_exception&)
+        {
+        }
+    }
+
+    // 空的快照
+    binary_fm_index   empty{binary_editor()};
+    std::stringstream emptyStream;
+    empty.save(emptyStream);
+    EXPECT_EQ(binary_fm_index::load(emptyStream).count(std::vector<uint8_t>{0}), 0);
+    EXPECT_THROW(binary_fm_index(binary_editor(), 0), binary_exception);
+}
+
+TEST(BinaryFmIndexTest, CompressedRepresentation)
+{
+    // 位元組分佈越集中, 索引越小
+    auto            skewed = make_sample(200000, 5, 2);
+    binary_fm_index skewedIndex(split_editor(skewed, 4096), 256);
+    EXPECT_LT(skewedIndex.memory_size(), skewed.size() / 3);
+    auto            uniform = make_sample(200000, 6, 256);
+    binary_fm_index uniformIndex(split_editor(uniform, 4096), 64);
+    EXPECT_LT(uniformIndex.memory_size(), uniform.size() * 3 / 2);
+    std::vector<uint8_t> pattern(skewed.begin() + 777, skewed.begin() + 800);
+    EXPECT_EQ(skewedIndex.locate(pattern), reference_find_all(skewed, pattern));
+
+    // 只有一種位元組
+    std::vector<uint8_t> same(1000, 7);
+    binary_fm_index      sameIndex(split_editor(same, 100), 3);
+    EXPECT_EQ(sameIndex.count(std::vector<uint8_t>{7, 7}), 999);
+    EXPECT_EQ(sameIndex.locate(std::vector<uint8_t>(998, 7)), std::vector<size_t>({0, 1, 2}));
+    EXPECT_EQ(sameIndex.count(std::vector<uint8_t>{0}), 0);
+    EXPECT_EQ(sameIndex.longest_repeat().second, 999);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
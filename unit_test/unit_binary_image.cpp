@@ -0,0 +1,148 @@
+#include "../src/binary_image.hpp"
+#include "test_util.hpp"
+#include <gtest/gtest.h>
+
+using namespace binary;
+
+static uint16_t pixel_of(const std::vector<uint8_t>& blob, size_t offset, size_t stride, size_t x, size_t y)
+{
+    uint16_t ret;
+    memcpy(&ret, blob.data() + offset + y * stride + x * 2, 2);
+    return ret;
+}
+
+TEST(BinaryImageTest, RowsTilesAndCopyOut)
+{
+    // 16 位元像素, 每列後有填充位元組
+    size_t width = 37, height = 23, stride = 80, offset = 6;
+    auto   blob  = make_random(offset + stride * height, 9);
+    for (size_t pieceSize : {1, 13, 80, 4096})
+    {
+        auto                        editor = split_editor(blob, pieceSize);
+        binary_image_view<uint16_t> image(editor, width, height, stride, offset);
+        EXPECT_EQ(image.width(), width);
+        EXPECT_EQ(image.height(), height);
+        EXPECT_EQ(image.stride(), stride);
+        EXPECT_EQ(image.at(5, 7), pixel_of(blob, offset, stride, 5, 7));
+
+        std::vector<uint16_t> scratch;
+        size_t                rows = 0;
+        image.for_each_row(
+            [&](size_t y, std::span<const uint16_t> row)
+            {
+                ASSERT_EQ(row.size(), width);
+                for (size_t x = 0; x < width; ++x)
+                {
+                    EXPECT_EQ(row[x], pixel_of(blob, offset, stride, x, y));
+                }
+                ++rows;
+            });
+        EXPECT_EQ(rows, height);
+
+        // 列位於單一區塊時不複製
+        auto row = image.row(3, scratch);
+        if (pieceSize == 4096)
+        {
+            EXPECT_TRUE(scratch.empty());
+        }
+        EXPECT_EQ(row[0], pixel_of(blob, offset, stride, 0, 3));
+
+        std::vector<uint16_t> rect(10 * 4);
+        image.copy_out(20, 17, 10, 4, rect);
+        for (size_t y = 0; y < 4; ++y)
+        {
+            for (size_t x = 0; x < 10; ++x)
+            {
+                EXPECT_EQ(rect[y * 10 + x], pixel_of(blob, offset, stride, 20 + x, 17 + y));
+            }
+        }
+
+        // 邊緣的圖塊會被裁切
+        size_t covered = 0;
+        image.for_each_tile(16, 8,
+                            [&](size_t x, size_t y, size_t tileWidth, size_t tileHeight, std::span<const uint16_t> tile)
+                            {
+                                EXPECT_EQ(tile.size(), tileWidth * tileHeight);
+                                EXPECT_EQ(tile[tileWidth * tileHeight - 1], pixel_of(blob, offset, stride, x + tileWidth - 1, y + tileHeight - 1));
+                                covered += tile.size();
+                            });
+        EXPECT_EQ(covered, width * height);
+    }
+}
+
+TEST(BinaryImageTest, CopyIn)
+{
+    size_t width = 30, height = 20, stride = 64, offset = 3;
+    auto   blob  = make_random(offset + stride * height + 5, 4);
+    for (size_t pieceSize : {1, 50, 4096})
+    {
+        auto                        editor = split_editor(blob, pieceSize);
+        auto                        pOld   = pieceSize == 4096 ? static_cast<const uint8_t*>(editor.get_data()) : nullptr;
+        binary_image_view<uint16_t> image(editor, width, height, stride, offset);
+        std::vector<uint16_t>       rect(7 * 5);
+        std::iota(rect.begin(), rect.end(), uint16_t{1000});
+        image.copy_in(21, 9, 7, 5, rect);
+
+        // 只有矩形內的位元組改變
+        auto expect = blob;
+        for (size_t y = 0; y < 5; ++y)
+        {
+            memcpy(expect.data() + offset + (9 + y) * stride + 21 * 2, rect.data() + y * 7, 7 * 2);
+        }
+        EXPECT_EQ(to_vector(editor), expect) << pieceSize;
+        EXPECT_EQ(image.at(21, 9), 1000);
+        EXPECT_EQ(image.at(27, 13), 1034);
+
+        std::vector<uint16_t> back(rect.size());
+        image.copy_out(21, 9, 7, 5, back);
+        EXPECT_EQ(back, rect);
+
+        // 窄矩形只配置自己的位元組, 列之間仍共用原本的區塊
+        if (pieceSize == 4096)
+        {
+            size_t copied = 0;
+            editor.for_each_chunk(
+                [&](const auto& pChunk)
+                {
+                    if (pChunk->get_data() < pOld || pChunk->get_data() >= pOld + blob.size())
+                    {
+                        copied += pChunk->size();
+                    }
+                });
+            EXPECT_EQ(copied, rect.size() * 2);
+        }
+
+        // 寬矩形的列間距較小, 整段一起取代
+        std::vector<uint16_t> wide(28 * 3);
+        std::iota(wide.begin(), wide.end(), uint16_t{2000});
+        image.copy_in(1, 2, 28, 3, wide);
+        for (size_t y = 0; y < 3; ++y)
+        {
+            memcpy(expect.data() + offset + (2 + y) * stride + 1 * 2, wide.data() + y * 28, 28 * 2);
+        }
+        EXPECT_EQ(to_vector(editor), expect) << pieceSize;
+    }
+}
+
+TEST(BinaryImageTest, InvalidArguments)
+{
+    auto                  blob   = make_random(100, 1);
+    auto                  editor = split_editor(blob, 10);
+    std::vector<uint16_t> rect(4);
+    EXPECT_THROW(binary_image_view<uint16_t>(editor, 10, 2, 19), binary_exception);
+    EXPECT_THROW(binary_image_view<uint16_t>(editor, 10, 6, 20), binary_exception);
+    EXPECT_NO_THROW(binary_image_view<uint16_t>(editor, 10, 5, 20));
+
+    binary_image_view<uint16_t> image(editor, 10, 5, 20);
+    EXPECT_THROW(image.at(10, 0), binary_exception);
+    EXPECT_THROW(image.copy_out(9, 0, 2, 2, rect), binary_exception);
+    EXPECT_THROW(image.copy_out(0, 0, 3, 2, rect), binary_exception);
+    EXPECT_THROW(image.copy_in(0, 4, 2, 2, rect), binary_exception);
+    EXPECT_THROW(image.for_each_tile(0, 1, [](size_t, size_t, size_t, size_t, std::span<const uint16_t>) {}), binary_exception);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
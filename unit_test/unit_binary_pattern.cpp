@@ -0,0 +1,108 @@
+#include "../src/binary_pattern.hpp"
+#include "test_util.hpp"
+#include <gtest/gtest.h>
+
+using namespace binary;
+
+static std::vector<size_t> reference_matches(const std::vector<uint8_t>& blob, const std::vector<uint8_t>& bytes, const std::vector<uint8_t>& masks)
+{
+    std::vector<size_t> ret;
+    for (size_t i = 0; i + bytes.size() <= blob.size(); ++i)
+    {
+        bool matched = true;
+        for (size_t j = 0; j < bytes.size() && matched; ++j)
+        {
+            matched = (blob[i + j] & masks[j]) == bytes[j];
+        }
+        if (matched)
+        {
+            ret.push_back(i);
+        }
+    }
+    return ret;
+}
+
+template <typename Pattern>
+static std::vector<size_t> collect(const Pattern& pattern, const binary_editor& editor, size_t offset = 0)
+{
+    std::vector<size_t> ret;
+    pattern.find_all(editor, [&](size_t position) { ret.push_back(position); }, offset);
+    return ret;
+}
+
+// 編譯期解析
+static_assert(pattern<"48 8B ?? E8">::size() == 4);
+static_assert(pattern<"  ?  4?\t?F  ">::size() == 3);
+static_assert(pattern<"48 8B ?? E8">::match(std::array<uint8_t, 4>{0x48, 0x8B, 0x11, 0xE8}.data()));
+static_assert(!pattern<"48 8B ?? E8">::match(std::array<uint8_t, 4>{0x48, 0x8C, 0x11, 0xE8}.data()));
+static_assert(pattern<"4? ?F">::match(std::array<uint8_t, 2>{0x4A, 0x3F}.data()));
+static_assert(detail::choose_pattern_anchors(std::array<uint8_t, 4>{0x48, 0x8B, 0x00, 0x37}.data(), std::array<uint8_t, 4>{0xFF, 0xFF, 0, 0xFF}.data(), 4) ==
+              std::pair<size_t, size_t>{3, 0});
+
+TEST(BinaryPatternTest, MatchesBruteForce)
+{
+    auto blob = make_random(20000, 11, 16);
+    // 植入幾個完整的簽章, 包含跨越區塊的位置
+    for (size_t position : {0, 997, 5003, 19995})
+    {
+        std::vector<uint8_t> signature = {0x0E, 0x08, 0x05, 0x01, 0x0C};
+        std::copy(signature.begin(), signature.end(), blob.begin() + position);
+    }
+    using call_like = pattern<"0E 08 ?? 01 0C">;
+    using nibbles   = pattern<"0? ?1 0?">;
+    using single    = pattern<"0F">;
+    using wildcards = pattern<"03 ? ? ? 07">;
+
+    binary_masked_pattern runtimeCall("0e 08 ?? 01 0c");
+    binary_masked_pattern runtimeNibbles("0? ?1 0?");
+    binary_masked_pattern runtimeSingle("0F");
+    binary_masked_pattern runtimeWildcards("03 ? ? ? 07");
+    EXPECT_EQ(runtimeCall.size(), 5);
+
+    auto expectCall      = reference_matches(blob, {0x0E, 0x08, 0x00, 0x01, 0x0C}, {0xFF, 0xFF, 0x00, 0xFF, 0xFF});
+    auto expectNibbles   = reference_matches(blob, {0x00, 0x01, 0x00}, {0xF0, 0x0F, 0xF0});
+    auto expectSingle    = reference_matches(blob, {0x0F}, {0xFF});
+    auto expectWildcards = reference_matches(blob, {0x03, 0, 0, 0, 0x07}, {0xFF, 0, 0, 0, 0xFF});
+    ASSERT_GE(expectCall.size(), 4);
+
+    for (size_t pieceSize : {1, 3, 1000, 4096, 20000})
+    {
+        auto editor = split_editor(blob, pieceSize);
+        EXPECT_EQ(collect(call_like(), editor), expectCall) << pieceSize;
+        EXPECT_EQ(collect(nibbles(), editor), expectNibbles) << pieceSize;
+        EXPECT_EQ(collect(single(), editor), expectSingle) << pieceSize;
+        EXPECT_EQ(collect(wildcards(), editor), expectWildcards) << pieceSize;
+        EXPECT_EQ(collect(runtimeCall, editor), expectCall) << pieceSize;
+        EXPECT_EQ(collect(runtimeNibbles, editor), expectNibbles) << pieceSize;
+        EXPECT_EQ(collect(runtimeSingle, editor), expectSingle) << pieceSize;
+        EXPECT_EQ(collect(runtimeWildcards, editor), expectWildcards) << pieceSize;
+
+        // 指定起點與第一個符合
+        EXPECT_EQ(call_like::find(editor), 0);
+        EXPECT_EQ(call_like::find(editor, 1), 997);
+        EXPECT_EQ(runtimeCall.find(editor, 1001), 5003);
+        EXPECT_EQ(collect(call_like(), editor, 1001), std::vector<size_t>(std::lower_bound(expectCall.begin(), expectCall.end(), 1001), expectCall.end()));
+        EXPECT_FALSE(call_like::find(editor, 19996).has_value());
+    }
+
+    // 比編輯器長的樣式
+    std::vector<uint8_t> shortBlob = {0, 1};
+    EXPECT_FALSE(pattern<"00 ?? 00">::find(split_editor(shortBlob, 1)).has_value());
+    EXPECT_FALSE(runtimeCall.find(binary_editor()).has_value());
+}
+
+TEST(BinaryPatternTest, InvalidRuntimePattern)
+{
+    EXPECT_THROW(binary_masked_pattern(""), binary_exception);
+    EXPECT_THROW(binary_masked_pattern("   "), binary_exception);
+    EXPECT_THROW(binary_masked_pattern("4"), binary_exception);
+    EXPECT_THROW(binary_masked_pattern("488B"), binary_exception);
+    EXPECT_THROW(binary_masked_pattern("48 8G"), binary_exception);
+    EXPECT_NO_THROW(binary_masked_pattern("?"));
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
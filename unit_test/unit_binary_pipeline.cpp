@@ -0,0 +1,105 @@
+#include "../src/binary_pipeline.hpp"
+#include "test_util.hpp"
+#include <gtest/gtest.h>
+
+using namespace binary;
+
+TEST(BinaryPipelineTest, ChainedStages)
+{
+    std::vector<uint8_t> blob(10000);
+    for (size_t i = 0; i < blob.size(); ++i)
+    {
+        blob[i] = static_cast<uint8_t>(i * 7);
+    }
+    binary_editor editor = split_editor(blob, 333);
+
+    // xor -> 每個 byte 重複兩次 -> 去掉 0 -> 結尾附上總和
+    uint32_t        sum = 0;
+    binary_pipeline pipeline(64);
+    pipeline
+        .add_transform(
+            [](std::span<uint8_t> data)
+            {
+                for (auto& value : data)
+                {
+                    value ^= 0x5A;
+                }
+            })
+        .add_stage(
+            [](std::span<const uint8_t> input, std::vector<uint8_t>& output)
+            {
+                for (auto value : input)
+                {
+                    output.push_back(value);
+                    output.push_back(value);
+                }
+            })
+        .add_stage(
+            [](std::span<const uint8_t> input, std::vector<uint8_t>& output)
+            {
+                std::copy_if(input.begin(), input.end(), std::back_inserter(output), [](uint8_t value) { return value != 0; });
+            })
+        .add_stage(
+            [&sum](std::span<const uint8_t> input, std::vector<uint8_t>& output)
+            {
+                for (auto value : input)
+                {
+                    sum += value;
+                }
+                output.assign(input.begin(), input.end());
+            },
+            [&sum](std::vector<uint8_t>& output)
+            {
+                output.resize(sizeof(sum));
+                memcpy(output.data(), &sum, sizeof(sum));
+            });
+
+    binary_editor result = pipeline.run(editor);
+
+    std::vector<uint8_t> expected;
+    uint32_t             expectedSum = 0;
+    for (auto value : blob)
+    {
+        uint8_t transformed = value ^ 0x5A;
+        if (transformed != 0)
+        {
+            expected.insert(expected.end(), {transformed, transformed});
+            expectedSum += 2u * transformed;
+        }
+    }
+    expected.resize(expected.size() + sizeof(expectedSum));
+    memcpy(expected.data() + expected.size() - sizeof(expectedSum), &expectedSum, sizeof(expectedSum));
+
+    EXPECT_EQ(sum, expectedSum);
+    EXPECT_EQ(to_vector(result), expected);
+}
+
+TEST(BinaryPipelineTest, EmptyInputAndNoStages)
+{
+    std::vector<uint8_t> blob = {1, 2, 3};
+    binary_editor        editor(blob.data(), blob.size());
+    EXPECT_EQ(to_vector(binary_pipeline().run(editor)), blob);
+
+    binary_pipeline pipeline;
+    pipeline.add_transform([](std::span<uint8_t>) {});
+    EXPECT_EQ(pipeline.run(binary_editor()).size(), 0);
+}
+
+TEST(BinaryPipelineTest, StageExceptionPropagates)
+{
+    std::vector<uint8_t> blob(4096, 1);
+    binary_editor        editor = split_editor(blob, 100);
+
+    binary_pipeline pipeline(16);
+    pipeline.add_transform([](std::span<uint8_t>) {})
+        .add_stage([](std::span<const uint8_t>, std::vector<uint8_t>&) { throw binary_exception("stage failed"); })
+        .add_transform([](std::span<uint8_t>) {});
+    EXPECT_THROW(pipeline.run(editor), binary_exception);
+    EXPECT_THROW(binary_pipeline(0), binary_exception);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,151 @@
+#include "../src/binary_regex.hpp"
+#include "test_util.hpp"
+#include <gtest/gtest.h>
+#include <regex>
+
+using namespace binary;
+
+static std::string make_text(size_t size, uint32_t seed, const std::string& alphabet)
+{
+    std::string text(size, '\0');
+    for (auto& c : text)
+    {
+        seed = seed * 1103515245u + 12345u;
+        c    = alphabet[(seed >> 16) % alphabet.size()];
+    }
+    return text;
+}
+
+static std::vector<size_t> reference_ends(const std::string& pattern, const std::string& text)
+{
+    // 以 std::regex 逐一檢查每個結尾位置
+    std::regex          re(pattern);
+    std::vector<size_t> ret;
+    for (size_t end = 1; end <= text.size(); ++end)
+    {
+        for (size_t start = 0; start < end; ++start)
+        {
+            if (std::regex_match(text.begin() + start, text.begin() + end, re))
+            {
+                ret.push_back(end);
+                break;
+            }
+        }
+    }
+    return ret;
+}
+
+TEST(BinaryRegexTest, Signature)
+{
+    std::string text("\x90\xE8\x01\x02\x03\x04\x48\x8B\x90\xE8\x00\x48\x8B", 13);
+    binary_regex call("\\xE8.{4}\\x48\\x8B");
+    EXPECT_EQ(call.literal_prefix(), std::vector<uint8_t>({0xE8}));
+    EXPECT_EQ(call.find_all(split_editor(text, 3)), std::vector<size_t>({8}));
+
+    binary_regex highBytes("[\\x80-\\xFF]{2}\\x00");
+    EXPECT_EQ(highBytes.find_all(split_editor(std::string("\x90\xE8\x00\x01\xFF\xFF\xFF\x00", 8), 1)), std::vector<size_t>({3, 8}));
+}
+
+TEST(BinaryRegexTest, InvalidPatterns)
+{
+    for (const char* pattern : {"(", "a)", "*a", "[a", "\\q", "a{3,1}", "a{", "\\x4", "a*", "(a|)", "[z-a]"})
+    {
+        EXPECT_THROW(binary_regex{pattern}, binary_exception) << pattern;
+    }
+}
+
+TEST(BinaryRegexTest, MatchesReference)
+{
+    std::string text = make_text(150, 7, "abc\x01");
+    for (const char* pattern :
+         {"ab", "a(b|c)+a", "[ab]{2,3}c", "b[^a]?c", "(ab)*c", "a.c", "\\x01+a", "c{2}|ba", "(?:a|bc){2,}", "[\\x01-b]c\\w", "\\Dc", "abca"})
+    {
+        auto expect = reference_ends(pattern, text);
+        for (size_t pieceSize : {1, 4, 1000})
+        {
+            EXPECT_EQ(binary_regex(pattern).find_all(split_editor(text, pieceSize)), expect) << pattern << " " << pieceSize;
+        }
+    }
+}
+
+TEST(BinaryRegexTest, LiteralPrefixAcrossChunks)
+{
+    std::string  text = make_text(5000, 3, "hel0123 ");
+    text.replace(1000, 8, "hello42 ");
+    text.replace(2998, 8, "hello7 x");
+    binary_regex regex("hello[0-9]+");
+    EXPECT_EQ(regex.literal_prefix().size(), 5);
+    std::vector<size_t> expect;
+    for (size_t pos = text.find("hello"); pos != std::string::npos; pos = text.find("hello", pos + 1))
+    {
+        for (size_t end = pos + 5; end < text.size() && text[end] >= '0' && text[end] <= '9'; ++end)
+        {
+            expect.push_back(end + 1);
+        }
+    }
+    std::sort(expect.begin(), expect.end());
+    EXPECT_GE(expect.size(), 3);
+    for (size_t pieceSize : {1, 3, 7, 6000})
+    {
+        EXPECT_EQ(regex.find_all(split_editor(text, pieceSize)), expect) << pieceSize;
+    }
+}
+
+TEST(BinaryRegexTest, MemoryLimitAndStreaming)
+{
+    // 此樣式的 DFA 狀態數隨 n 指數成長
+    std::string  text = make_text(20000, 11, "ab");
+    binary_regex regex("a[ab]{10}b");
+
+    binary_regex_matcher unlimited(regex);
+    std::vector<size_t>  expect;
+    unlimited.feed(split_editor(text, 1000), [&](size_t end) { expect.push_back(end); });
+    EXPECT_GT(unlimited.state_count(), 1000);
+    EXPECT_EQ(unlimited.flush_count(), 0);
+
+    binary_regex_matcher limited(regex, 64 * 1024);
+    std::vector<size_t>  found;
+    for (size_t offset = 0; offset < text.size(); offset += 333)
+    {
+        std::string piece = text.substr(offset, 333);
+        limited.feed(reinterpret_cast<const uint8_t*>(piece.data()), piece.size(), [&](size_t end) { found.push_back(end); });
+    }
+    EXPECT_EQ(found, expect);
+    EXPECT_GT(limited.flush_count(), 0);
+    EXPECT_EQ(limited.offset(), text.size());
+
+    // 回呼回傳 false 時停止
+    limited.reset();
+    size_t first = 0;
+    EXPECT_FALSE(limited.feed(split_editor(text, 100),
+                              [&](size_t end)
+                              {
+                                  first = end;
+                                  return false;
+                              }));
+    EXPECT_EQ(first, expect.front());
+}
+
+TEST(BinaryRegexTest, SkipsChunksBySummary)
+{
+    std::string text = make_text(40000, 5, "abc");
+    text.replace(15000, 6, "hello1");
+    text.replace(29997, 6, "hello2");
+    binary_regex prefix("hello[0-9]");
+    binary_regex firstByte("[xh]e");
+    for (size_t pieceSize : {10000, 40000})
+    {
+        binary_editor editor = split_editor(text, pieceSize);
+        for (int repeat = 0; repeat < 2; ++repeat)
+        {
+            EXPECT_EQ(prefix.find_all(editor), std::vector<size_t>({15006, 30003})) << pieceSize;
+            EXPECT_EQ(firstByte.find_all(editor), std::vector<size_t>({15002, 29999})) << pieceSize;
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
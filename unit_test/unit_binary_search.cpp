@@ -0,0 +1,118 @@
+#include "../src/binary_search.hpp"
+#include "test_util.hpp"
+#include <gtest/gtest.h>
+
+using namespace binary;
+
+static std::vector<uint8_t> make_sample(size_t size, uint32_t seed)
+{
+    // 小字母表, 讓樣式經常出現
+    std::vector<uint8_t> blob(size);
+    for (auto& value : blob)
+    {
+        seed  = seed * 1103515245u + 12345u;
+        value = static_cast<uint8_t>("abc"[(seed >> 16) % 3]);
+    }
+    return blob;
+}
+
+TEST(BinarySearchTest, FindAllAcrossChunks)
+{
+    auto blob = make_sample(3000, 5);
+    for (std::vector<uint8_t> needle : {std::vector<uint8_t>{'a'}, {'a', 'b'}, {'c', 'a', 'b'}, {'a', 'b', 'c', 'a', 'b'}, std::vector<uint8_t>(20, 'a')})
+    {
+        for (size_t pieceSize : {1, 2, 5, 64, 5000})
+        {
+            binary_editor editor = split_editor(blob, pieceSize);
+            for (size_t offset : {0, 1, 1500})
+            {
+                std::vector<size_t> found;
+                find_all(editor, needle, [&found](size_t position) { found.push_back(position); }, offset);
+                EXPECT_EQ(found, reference_find_all(blob, needle, offset)) << needle.size() << " " << pieceSize << " " << offset;
+            }
+        }
+    }
+}
+
+TEST(BinarySearchTest, Find)
+{
+    std::vector<uint8_t> blob(1000, 0);
+    blob[998]            = 0x48;
+    blob[999]            = 0x8B;
+    binary_editor editor = split_editor(blob, 999);
+    EXPECT_EQ(find(editor, std::vector<uint8_t>{0x48, 0x8B}), 998);
+    EXPECT_EQ(find(editor, std::vector<uint8_t>{0x00, 0x48}, 10), 997);
+    EXPECT_FALSE(find(editor, std::vector<uint8_t>{0x8B, 0x48}).has_value());
+    EXPECT_FALSE(find(editor, std::vector<uint8_t>{}).has_value());
+    EXPECT_FALSE(find(editor, std::vector<uint8_t>{0x48}, 1000).has_value());
+    EXPECT_FALSE(find(binary_editor(), std::vector<uint8_t>{0x48}).has_value());
+}
+
+TEST(BinarySearchTest, SkipsChunksBySummary)
+{
+    // 大 chunk 使用摘要略過, 結果與參考實作一致
+    auto blob = make_sample(40000, 9);
+    std::fill(blob.begin() + 10000, blob.begin() + 30000, 'a');
+    blob[20000]          = 'x';
+    blob[29999]          = 'y';
+    blob[30000]          = 'z';
+    binary_editor editor = split_editor(blob, 10000);
+    for (std::vector<uint8_t> needle : {std::vector<uint8_t>{'x'}, {'y', 'z'}, {'a', 'a', 'b'}, {'b', 'c'}, {'z', 'z'}})
+    {
+        for (int repeat = 0; repeat < 2; ++repeat)
+        {
+            std::vector<size_t> found;
+            find_all(editor, needle, [&found](size_t position) { found.push_back(position); });
+            EXPECT_EQ(found, reference_find_all(blob, needle, 0)) << needle.size();
+        }
+    }
+}
+
+TEST(BinarySearchTest, ReverseFind)
+{
+    auto blob = make_sample(3000, 7);
+    for (std::vector<uint8_t> needle : {std::vector<uint8_t>{'a'}, {'a', 'b'}, {'c', 'a', 'b'}, {'a', 'b', 'c', 'a', 'b'}, std::vector<uint8_t>(7, 'a')})
+    {
+        auto all = reference_find_all(blob, needle, 0);
+        for (size_t pieceSize : {1, 2, 5, 64, 5000})
+        {
+            binary_editor editor = split_editor(blob, pieceSize);
+            for (size_t position : {size_t{0}, size_t{1}, size_t{1500}, size_t{2999}, SIZE_MAX})
+            {
+                // 參考答案: 起點不超過 position 的最後一個位置
+                auto                  iter = std::upper_bound(all.begin(), all.end(), position);
+                std::optional<size_t> expect;
+                if (iter != all.begin())
+                {
+                    expect = *std::prev(iter);
+                }
+                EXPECT_EQ(rfind(editor, needle, position), expect) << needle.size() << " " << pieceSize << " " << position;
+            }
+        }
+    }
+    EXPECT_FALSE(rfind(split_editor(blob, 10), std::vector<uint8_t>{'x'}).has_value());
+    EXPECT_FALSE(rfind(split_editor(blob, 10), std::vector<uint8_t>{}).has_value());
+    EXPECT_FALSE(rfind(binary_editor(), std::vector<uint8_t>{'a'}).has_value());
+}
+
+TEST(BinarySearchTest, ParallelCount)
+{
+    worker_pool pool(3);
+    auto        blob = make_sample(5000, 11);
+    for (std::vector<uint8_t> needle : {std::vector<uint8_t>{'a'}, {'a', 'b'}, {'a', 'a', 'a'}, std::vector<uint8_t>(100, 'a')})
+    {
+        size_t expect = reference_find_all(blob, needle, 0).size();
+        for (size_t pieceSize : {1, 7, 6000})
+        {
+            EXPECT_EQ(count(split_editor(blob, pieceSize), needle, pool, 64), expect) << needle.size() << " " << pieceSize;
+        }
+        EXPECT_EQ(count(split_editor(blob, 100), needle, pool), expect);
+    }
+    EXPECT_EQ(count(split_editor(blob, 100), std::vector<uint8_t>{}, pool), 0);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
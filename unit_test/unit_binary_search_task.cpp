@@ -0,0 +1,106 @@
+#include "../src/binary_search_task.hpp"
+#include "test_util.hpp"
+#include <gtest/gtest.h>
+
+using namespace binary;
+
+static std::vector<uint8_t> make_sample(size_t size, uint32_t seed)
+{
+    std::vector<uint8_t> blob(size);
+    for (auto& value : blob)
+    {
+        seed  = seed * 1103515245u + 12345u;
+        value = static_cast<uint8_t>("abcd"[(seed >> 16) % 4]);
+    }
+    return blob;
+}
+
+TEST(BinarySearchTaskTest, DeliversInOrder)
+{
+    worker_pool          pool(4);
+    auto                 blob   = make_sample(100000, 3);
+    std::vector<uint8_t> needle = {'a', 'b', 'c'};
+    std::vector<size_t>  expect;
+    find_all(split_editor(blob, 100000), needle, [&](size_t position) { expect.push_back(position); });
+    ASSERT_GT(expect.size(), 1000);
+
+    for (size_t rangeSize : {1, 7, 1000, 200000})
+    {
+        std::vector<size_t> found;
+        binary_search_task  task(split_editor(blob, 333), needle, [&](size_t position) { found.push_back(position); }, pool, rangeSize);
+        task.wait();
+        EXPECT_TRUE(task.finished());
+        EXPECT_FALSE(task.cancelled());
+        EXPECT_EQ(task.searched_bytes(), blob.size());
+        EXPECT_DOUBLE_EQ(task.progress(), 1.0);
+        EXPECT_EQ(found, expect) << rangeSize;
+    }
+
+    // 空的樣式立即完成
+    binary_search_task empty(split_editor(blob, 333), std::vector<uint8_t>{}, [](size_t) { FAIL(); }, pool);
+    EXPECT_TRUE(empty.wait_for(std::chrono::seconds(10)));
+    EXPECT_DOUBLE_EQ(empty.progress(), 1.0);
+}
+
+TEST(BinarySearchTaskTest, Cancel)
+{
+    worker_pool          pool(4);
+    auto                 blob   = make_sample(1000000, 5);
+    std::vector<uint8_t> needle = {'a', 'b'};
+
+    // 回呼回傳 false 時停止, 之後不再傳遞
+    std::vector<size_t> found;
+    binary_search_task  stopByCallback(
+        split_editor(blob, 4096), needle,
+        [&](size_t position)
+        {
+            found.push_back(position);
+            return found.size() < 10;
+        },
+        pool, 1000);
+    stopByCallback.wait();
+    EXPECT_TRUE(stopByCallback.cancelled());
+    EXPECT_EQ(found.size(), 10);
+    EXPECT_LT(stopByCallback.searched_bytes(), blob.size());
+
+    // 從其他執行緒取消
+    std::atomic<size_t> delivered{0};
+    binary_search_task  task(
+        split_editor(blob, 4096), needle,
+        [&](size_t)
+        {
+            ++delivered;
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        },
+        pool, 1000);
+    while (delivered == 0)
+    {
+        std::this_thread::yield();
+    }
+    task.cancel();
+    size_t afterCancel = delivered;
+    EXPECT_TRUE(task.wait_for(std::chrono::seconds(10)));
+    EXPECT_EQ(delivered, afterCancel);
+    EXPECT_LT(task.progress(), 1.0);
+
+    // 解構時取消並等待
+    {
+        binary_search_task dropped(split_editor(blob, 4096), needle, [](size_t) { std::this_thread::sleep_for(std::chrono::microseconds(50)); }, pool, 1000);
+    }
+}
+
+TEST(BinarySearchTaskTest, CallbackException)
+{
+    worker_pool        pool(2);
+    auto               blob = make_sample(50000, 7);
+    binary_search_task task(split_editor(blob, 1000), std::vector<uint8_t>{'a'}, [](size_t) { throw binary_exception("stop"); }, pool, 1000);
+    EXPECT_THROW(task.wait(), binary_exception);
+    EXPECT_TRUE(task.cancelled());
+    EXPECT_THROW(binary_search_task(split_editor(blob, 1000), std::vector<uint8_t>{'a'}, [](size_t) {}, pool, 0), binary_exception);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,166 @@
+#include "../src/binary_serialize.hpp"
+#include "test_util.hpp"
+#include <gtest/gtest.h>
+
+using namespace binary;
+
+struct point
+{
+    int16_t x;
+    int16_t y;
+};
+
+// 含填充與巢狀欄位的結構
+struct record
+{
+    uint8_t                kind;
+    uint32_t               id;
+    point                  origin;
+    std::array<uint16_t, 3> sizes;
+    double                 scale;
+};
+
+// 同質欄位, 整段一次交換
+struct pixel_block
+{
+    std::array<uint32_t, 7> values;
+    uint32_t                checksum;
+    float                   weight;
+};
+
+// 含 C 陣列欄位的標頭
+struct hdr
+{
+    char     magic[4];
+    uint32_t size;
+};
+
+// C 陣列位於中間, 元素為結構或多維陣列
+struct table
+{
+    uint8_t  count;
+    point    corners[2];
+    uint16_t grid[2][3];
+    uint8_t  flags;
+};
+
+// 以欄位清單指定順序, 略過快取欄位
+class annotated
+{
+public:
+    uint16_t tag   = 0;
+    uint32_t value = 0;
+    uint64_t cache = 0;
+};
+
+template <>
+struct writer::field_list<annotated>
+{
+    static constexpr auto members = std::make_tuple(&annotated::value, &annotated::tag);
+};
+
+static_assert(writer::detail::count_fields<record>() == 5);
+static_assert(writer::detail::count_fields<hdr>() == 2);
+static_assert(writer::detail::count_fields<table>() == 4);
+static_assert(writer::serialized_size<hdr> == 8);
+static_assert(writer::serialized_size<table> == 1 + 8 + 12 + 1);
+static_assert(writer::serialized_size<point> == 4);
+static_assert(writer::serialized_size<record> == 1 + 4 + 4 + 6 + 8);
+static_assert(writer::serialized_size<pixel_block> == 36);
+static_assert(writer::serialized_size<annotated> == 6);
+static_assert(writer::detail::lane_size<record>() == 0);
+static_assert(writer::detail::lane_size<pixel_block>() == 4);
+
+TEST(BinarySerializeTest, PackedLayout)
+{
+    record value{0x7F, 0x01020304, {-2, 0x0506}, {0x0A0B, 0x0C0D, 0x0E0F}, 1.0};
+
+    std::vector<uint8_t> big = {0x7F, 0x01, 0x02, 0x03, 0x04, 0xFF, 0xFE, 0x05, 0x06, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x3F, 0xF0, 0, 0, 0, 0, 0, 0};
+    auto                 editor = writer::serialize<std::endian::big>(value);
+    EXPECT_EQ(to_vector(editor), big);
+    EXPECT_EQ(chunk_count(editor), 1);
+
+    std::vector<uint8_t> little = {0x7F, 0x04, 0x03, 0x02, 0x01, 0xFE, 0xFF, 0x06, 0x05, 0x0B, 0x0A, 0x0D, 0x0C, 0x0F, 0x0E, 0, 0, 0, 0, 0, 0, 0xF0, 0x3F};
+    EXPECT_EQ(to_vector(writer::serialize(value)), little);
+
+    annotated other;
+    other.tag   = 0x1122;
+    other.value = 0x33445566;
+    other.cache = 99;
+    std::vector<uint8_t> annotatedBig = {0x33, 0x44, 0x55, 0x66, 0x11, 0x22};
+    EXPECT_EQ(to_vector(writer::serialize<std::endian::big>(other)), annotatedBig);
+
+    hdr header{{'R', 'I', 'F', 'F'}, 0x01020304};
+    EXPECT_EQ(to_vector(writer::serialize<std::endian::big>(header)), (std::vector<uint8_t>{'R', 'I', 'F', 'F', 0x01, 0x02, 0x03, 0x04}));
+
+    table grid{3, {{1, 2}, {3, -1}}, {{0x0102, 0x0304, 0x0506}, {0x0708, 0x090A, 0x0B0C}}, 0x80};
+    std::vector<uint8_t> gridBig = {3, 0, 1, 0, 2, 0, 3, 0xFF, 0xFF, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 0x80};
+    EXPECT_EQ(to_vector(writer::serialize<std::endian::big>(grid)), gridBig);
+
+    binary_editor appended;
+    writer::write_back_fields<std::endian::big>(appended, point{1, 2});
+    writer::write_back_fields<std::endian::big>(appended, other);
+    std::vector<uint8_t> expect = {0, 1, 0, 2, 0x33, 0x44, 0x55, 0x66, 0x11, 0x22};
+    EXPECT_EQ(to_vector(appended), expect);
+}
+
+TEST(BinarySerializeTest, HomogeneousSwapMatchesPerField)
+{
+    // 向量交換與逐欄位交換比較, 長度不是向量的整數倍
+    std::vector<pixel_block> blocks(37);
+    uint32_t                 seed = 3;
+    for (auto& block : blocks)
+    {
+        for (auto& value : block.values)
+        {
+            seed  = seed * 1103515245u + 12345u;
+            value = seed;
+        }
+        block.checksum = seed ^ 0xFFFF;
+        block.weight   = static_cast<float>(seed % 1000) / 7.0f;
+    }
+    auto bytes = to_vector(writer::serialize_all<std::endian::big>(std::span<const pixel_block>(blocks)));
+    ASSERT_EQ(bytes.size(), blocks.size() * 36);
+    for (size_t i = 0; i < blocks.size(); ++i)
+    {
+        std::array<uint32_t, 9> words;
+        std::copy(blocks[i].values.begin(), blocks[i].values.end(), words.begin());
+        words[7] = blocks[i].checksum;
+        words[8] = std::bit_cast<uint32_t>(blocks[i].weight);
+        for (size_t j = 0; j < words.size(); ++j)
+        {
+            const uint8_t* pWord = bytes.data() + i * 36 + j * 4;
+            EXPECT_EQ(static_cast<uint32_t>(pWord[0]) << 24 | pWord[1] << 16 | pWord[2] << 8 | pWord[3], words[j]);
+        }
+    }
+
+    // 各種寬度的通道
+    for (size_t count : {0, 1, 7, 8, 9, 33})
+    {
+        std::vector<uint8_t> lanes(count * 8), expect16, expect64;
+        std::iota(lanes.begin(), lanes.end(), uint8_t{1});
+        expect16 = lanes;
+        expect64 = lanes;
+        for (size_t i = 0; i < count * 8; i += 2)
+        {
+            std::reverse(expect16.begin() + i, expect16.begin() + i + 2);
+        }
+        for (size_t i = 0; i < count * 8; i += 8)
+        {
+            std::reverse(expect64.begin() + i, expect64.begin() + i + 8);
+        }
+        auto swapped16 = lanes;
+        auto swapped64 = lanes;
+        writer::detail::swap_lanes<2>(swapped16.data(), count * 4);
+        writer::detail::swap_lanes<8>(swapped64.data(), count);
+        EXPECT_EQ(swapped16, expect16) << count;
+        EXPECT_EQ(swapped64, expect64) << count;
+    }
+    EXPECT_EQ(writer::serialize_all(std::span<const point>()).size(), 0);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,106 @@
+#include "../src/binary_similarity.hpp"
+#include "test_util.hpp"
+#include <gtest/gtest.h>
+
+using namespace binary;
+
+static std::vector<uint8_t> make_sample(size_t size, uint32_t seed)
+{
+    // 類似程式碼的資料: 重複出現的片語加上隨機位元組
+    std::vector<uint8_t> blob;
+    while (blob.size() < size)
+    {
+        seed = seed * 1103515245u + 12345u;
+        if ((seed >> 16) % 3 == 0)
+        {
+            for (uint8_t value : {0x48, 0x8B, 0x45, 0xF8, 0xE8})
+            {
+                blob.push_back(value);
+            }
+        }
+        blob.push_back(static_cast<uint8_t>(seed >> 20));
+    }
+    blob.resize(size);
+    return blob;
+}
+
+TEST(BinarySimilarityTest, StreamingAndFormatting)
+{
+    auto blob   = make_sample(20000, 1);
+    auto digest = compute_similarity_digest(binary_editor(blob.data(), blob.size()));
+    EXPECT_TRUE(digest.valid());
+    // 切割方式不影響摘要
+    for (size_t pieceSize : {1, 3, 4096})
+    {
+        auto split = compute_similarity_digest(split_editor(blob, pieceSize));
+        EXPECT_EQ(split.to_string(), digest.to_string());
+        EXPECT_EQ(similarity_distance(split, digest), 0);
+    }
+    auto parsed = similarity_digest::from_string(digest.to_string());
+    EXPECT_EQ(parsed.to_string(), digest.to_string());
+    EXPECT_THROW(similarity_digest::from_string("12"), binary_exception);
+
+    // 子編輯器
+    binary_editor editor = split_editor(blob, 1000);
+    auto          sub    = compute_similarity_digest(editor.create_sub_editor(500, 10000));
+    EXPECT_EQ(sub.to_string(), compute_similarity_digest(binary_editor(blob.data() + 500, 10000)).to_string());
+
+    EXPECT_FALSE(compute_similarity_digest(binary_editor(blob.data(), 20)).valid());
+    EXPECT_FALSE(compute_similarity_digest(binary_editor(std::vector<uint8_t>(1000, 0).data(), 1000)).valid());
+}
+
+TEST(BinarySimilarityTest, DistanceReflectsSimilarity)
+{
+    auto original = make_sample(50000, 2);
+    auto modified = original;
+    for (size_t i = 0; i < 200; ++i)
+    {
+        modified[i * 211] ^= 0x5A;
+    }
+    auto unrelated = make_sample(50000, 3);
+    for (auto& value : unrelated)
+    {
+        value = static_cast<uint8_t>(value * 7 + 1);
+    }
+
+    std::vector<binary_editor> editors = {split_editor(original, 999), split_editor(modified, 777), split_editor(unrelated, 555)};
+    worker_pool                pool(3);
+    auto                       digests = compute_similarity_digests(editors, pool);
+    size_t                     near    = similarity_distance(digests[0], digests[1]);
+    size_t                     far     = similarity_distance(digests[0], digests[2]);
+    EXPECT_LT(near, 40);
+    EXPECT_GT(far, 2 * near + 20);
+    EXPECT_EQ(similarity_distance(digests[1], digests[0]), near);
+
+    std::vector<std::pair<size_t, size_t>> expect = {{0, 1}};
+    EXPECT_EQ(similar_pairs(digests, near, pool), expect);
+    EXPECT_EQ(similar_pairs(digests, 100000, pool).size(), 3);
+}
+
+TEST(BinarySimilarityTest, BodyDistanceMatchesCodeDifferences)
+{
+    // 位元運算的距離與逐一比較 2 位元代碼一致
+    similarity_digest lhs, rhs;
+    uint64_t          state = 99;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        state       = state * 6364136223846793005ull + 1442695040888963407ull;
+        lhs.body[i] = state;
+        state       = state * 6364136223846793005ull + 1442695040888963407ull;
+        rhs.body[i] = state;
+    }
+    size_t expect = 0;
+    for (size_t i = 0; i < similarity_digest::BUCKET_COUNT; ++i)
+    {
+        int a = static_cast<int>((lhs.body[i / 32] >> (2 * (i % 32))) & 3);
+        int b = static_cast<int>((rhs.body[i / 32] >> (2 * (i % 32))) & 3);
+        expect += std::abs(a - b) == 3 ? 6 : std::abs(a - b);
+    }
+    EXPECT_EQ(similarity_distance(lhs, rhs), expect);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
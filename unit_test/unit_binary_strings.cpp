@@ -0,0 +1,120 @@
+#include "../src/binary_strings.hpp"
+#include "test_util.hpp"
+#include <gtest/gtest.h>
+
+using namespace binary;
+
+static std::vector<uint8_t> make_sample(size_t size, uint32_t seed)
+{
+    // 混合可列印字元, 零與其他位元組, 並放入 UTF-16LE 字串
+    std::vector<uint8_t> blob(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        seed         = seed * 1103515245u + 12345u;
+        uint32_t r   = seed >> 16;
+        blob[i]      = (r % 4 == 0) ? 0 : (r % 7 == 0 ? static_cast<uint8_t>(0x80 + r % 0x80) : static_cast<uint8_t>('a' + r % 26));
+        if (r % 97 == 0)
+        {
+            for (size_t j = 0; j < 2 * (r % 23) && i + 1 < size; j += 2, i += 2)
+            {
+                blob[i]     = static_cast<uint8_t>('A' + j % 26);
+                blob[i + 1] = 0;
+            }
+        }
+    }
+    return blob;
+}
+
+static std::vector<string_match> reference_strings(const std::vector<uint8_t>& blob, size_t minLength, STRING_ENCODING encodings)
+{
+    auto                      printable = [](uint8_t c) { return (c >= 0x20 && c <= 0x7E) || c == '\t'; };
+    std::vector<string_match> ret;
+    if (has_encoding(encodings, STRING_ENCODING::ASCII))
+    {
+        for (size_t i = 0; i < blob.size();)
+        {
+            size_t j = i;
+            while (j < blob.size() && printable(blob[j]))
+            {
+                ++j;
+            }
+            if (j - i >= minLength)
+            {
+                ret.push_back({i, j - i, STRING_ENCODING::ASCII});
+            }
+            i = j + 1;
+        }
+    }
+    if (has_encoding(encodings, STRING_ENCODING::UTF16LE))
+    {
+        for (size_t parity = 0; parity < 2; ++parity)
+        {
+            for (size_t i = parity; i + 1 < blob.size();)
+            {
+                size_t j = i;
+                while (j + 1 < blob.size() && printable(blob[j]) && blob[j + 1] == 0)
+                {
+                    j += 2;
+                }
+                if ((j - i) / 2 >= minLength)
+                {
+                    ret.push_back({i, j - i, STRING_ENCODING::UTF16LE});
+                }
+                i = j + 2;
+            }
+        }
+    }
+    std::sort(ret.begin(), ret.end(),
+              [](const string_match& lhs, const string_match& rhs) { return lhs.offset != rhs.offset ? lhs.offset < rhs.offset : lhs.encoding < rhs.encoding; });
+    return ret;
+}
+
+TEST(BinaryStringsTest, Basic)
+{
+    const char    text[] = "\x01hello\0W\0o\0r\0l\0d\0\x02\x03" "ab\0";
+    binary_editor editor(reinterpret_cast<const uint8_t*>(text), sizeof(text) - 1);
+    auto          found = strings(editor, 4);
+    ASSERT_EQ(found.size(), 2);
+    EXPECT_EQ(found[0], (string_match{1, 5, STRING_ENCODING::ASCII}));
+    EXPECT_EQ(found[1], (string_match{5, 12, STRING_ENCODING::UTF16LE}));
+
+    auto subEditors = create_sub_editors(editor, found);
+    EXPECT_EQ(subEditors[0].size(), 5);
+    EXPECT_EQ(subEditors[1].size(), 12);
+    EXPECT_EQ(strings(editor, 4, STRING_ENCODING::ASCII).size(), 1);
+    EXPECT_TRUE(strings(binary_editor(), 4).empty());
+}
+
+TEST(BinaryStringsTest, MatchesReferenceAcrossChunksAndRanges)
+{
+    worker_pool pool(4);
+    for (uint32_t seed : {1u, 2u, 3u})
+    {
+        auto blob = make_sample(20000, seed);
+        // 跨越長字串的範圍與區塊邊界
+        memset(blob.data() + 5000, 'x', 3000);
+        for (size_t i = 9001; i < 12001; i += 2)
+        {
+            blob[i]     = 'y';
+            blob[i + 1] = 0;
+        }
+        for (size_t pieceSize : {1, 13, 4096})
+        {
+            binary_editor editor = split_editor(blob, pieceSize);
+            for (size_t minLength : {1, 4, 10})
+            {
+                for (auto encodings : {STRING_ENCODING::ASCII, STRING_ENCODING::UTF16LE, STRING_ENCODING::ALL})
+                {
+                    EXPECT_EQ(strings(editor, minLength, encodings, pool, 1000), reference_strings(blob, minLength, encodings))
+                        << seed << " " << pieceSize << " " << minLength;
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
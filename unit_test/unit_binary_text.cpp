@@ -0,0 +1,151 @@
+#include "../src/binary_text.hpp"
+#include "test_util.hpp"
+#include <gtest/gtest.h>
+
+using namespace binary;
+
+static std::string reference_hex(const std::vector<uint8_t>& blob)
+{
+    std::string ret;
+    char        buffer[3];
+    for (auto value : blob)
+    {
+        snprintf(buffer, sizeof(buffer), "%02x", value);
+        ret += buffer;
+    }
+    return ret;
+}
+
+TEST(BinaryTextTest, HexRoundTrip)
+{
+    // 各種長度與分段方式, 涵蓋向量與純量路徑
+    for (size_t size : {0, 1, 15, 16, 17, 33, 100, 1000})
+    {
+        auto          blob   = make_random(size, static_cast<uint32_t>(size));
+        binary_editor editor = split_editor(blob, 7);
+        std::string   hex    = to_hex(editor);
+        EXPECT_EQ(hex, reference_hex(blob));
+        EXPECT_EQ(to_vector(from_hex(hex)), blob);
+
+        std::string upper = to_hex(editor, true);
+        std::transform(hex.begin(), hex.end(), hex.begin(), [](char c) { return static_cast<char>(toupper(c)); });
+        EXPECT_EQ(upper, hex);
+        EXPECT_EQ(to_vector(from_hex(upper)), blob);
+    }
+    EXPECT_EQ(to_vector(from_hex("48 65\n6C 6c\t6F")), std::vector<uint8_t>({'H', 'e', 'l', 'l', 'o'}));
+}
+
+TEST(BinaryTextTest, HexInvalid)
+{
+    EXPECT_THROW(from_hex("abc"), binary_exception);
+    // 在每個位置放入非法字元
+    std::string hex = reference_hex(make_random(40, 1));
+    for (size_t i = 0; i < hex.size(); ++i)
+    {
+        for (char bad : {'g', 'G', '/', ':', '@', '`', '\x80', '\xff'})
+        {
+            std::string text = hex;
+            text[i]          = bad;
+            EXPECT_THROW(from_hex(text), binary_exception);
+        }
+    }
+}
+
+TEST(BinaryTextTest, Base64KnownVectors)
+{
+    const std::pair<std::string, std::string> vectors[] = {
+        {"", ""}, {"f", "Zg=="}, {"fo", "Zm8="}, {"foo", "Zm9v"}, {"foob", "Zm9vYg=="}, {"fooba", "Zm9vYmE="}, {"foobar", "Zm9vYmFy"}};
+    for (const auto& [plain, encoded] : vectors)
+    {
+        std::vector<uint8_t> blob(plain.begin(), plain.end());
+        EXPECT_EQ(to_base64(split_editor(blob, 1)), encoded);
+        EXPECT_EQ(to_vector(from_base64(encoded)), blob);
+    }
+    // 無填充與空白
+    EXPECT_EQ(to_vector(from_base64("Zm9v\r\nYmE")), std::vector<uint8_t>({'f', 'o', 'o', 'b', 'a'}));
+    EXPECT_THROW(from_base64("Zm9vY"), binary_exception);
+    EXPECT_THROW(from_base64("Zm9vY==="), binary_exception);
+    EXPECT_THROW(from_base64("Zg==Zg=="), binary_exception);
+    EXPECT_THROW(from_base64("Z=g="), binary_exception);
+    EXPECT_THROW(from_base64("Zm9v*mFy"), binary_exception);
+}
+
+TEST(BinaryTextTest, Base64RoundTrip)
+{
+    for (size_t size : {1, 2, 3, 11, 12, 13, 47, 48, 49, 1000, 4099})
+    {
+        auto        blob    = make_random(size, static_cast<uint32_t>(size) + 7);
+        std::string encoded = to_base64(split_editor(blob, 5));
+        EXPECT_EQ(encoded, to_base64(binary_editor(blob.data(), blob.size())));
+        EXPECT_EQ(to_vector(from_base64(encoded)), blob);
+    }
+    // 每個位元組值都應與查表結果一致
+    for (int c = 0; c < 256; ++c)
+    {
+        std::string text = to_base64(binary_editor(make_random(48, 3).data(), 48));
+        text[21]         = static_cast<char>(c);
+        bool valid       = strchr("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/", c) != nullptr && c != 0;
+        if (valid)
+        {
+            EXPECT_NO_THROW(from_base64(text));
+        }
+        else if (!detail::is_text_space(static_cast<char>(c)))
+        {
+            EXPECT_THROW(from_base64(text), binary_exception) << c;
+        }
+    }
+}
+
+TEST(BinaryTextTest, Streaming)
+{
+    auto          blob   = make_random(5000, 9);
+    binary_editor editor = split_editor(blob, 333);
+
+    // 編碼: 每次輸出不超過 chunkSize 個字元
+    std::vector<std::string> hexPieces;
+    to_hex(editor, [&](std::string_view text) { hexPieces.emplace_back(text); }, false, 1000);
+    std::vector<std::string> base64Pieces;
+    to_base64(editor, [&](std::string_view text) { base64Pieces.emplace_back(text); }, 1000);
+    EXPECT_EQ(hexPieces.size(), 10);
+    std::string hex, base64;
+    for (const auto& piece : hexPieces)
+    {
+        EXPECT_LE(piece.size(), 1000);
+        hex += piece;
+    }
+    for (const auto& piece : base64Pieces)
+    {
+        EXPECT_LE(piece.size(), 1000);
+        base64 += piece;
+    }
+    EXPECT_EQ(hex, to_hex(editor));
+    EXPECT_EQ(base64, to_base64(editor));
+
+    // 解碼: 任意切割輸入, 輸出為固定大小的區塊
+    binary_editor      hexOutput;
+    binary_hex_decoder hexDecoder(hexOutput, 256);
+    for (size_t offset = 0; offset < hex.size(); offset += 37)
+    {
+        hexDecoder.feed(std::string_view(hex).substr(offset, 37));
+    }
+    hexDecoder.finish();
+    EXPECT_EQ(to_vector(hexOutput), blob);
+    size_t segmentCount = 0;
+    hexOutput.for_each_segment([&](const uint8_t*, const size_t&) { ++segmentCount; });
+    EXPECT_EQ(segmentCount, (blob.size() + 255) / 256);
+
+    binary_editor         base64Output;
+    binary_base64_decoder base64Decoder(base64Output, 256);
+    for (size_t offset = 0; offset < base64.size(); offset += 37)
+    {
+        base64Decoder.feed(std::string_view(base64).substr(offset, 37));
+    }
+    base64Decoder.finish();
+    EXPECT_EQ(to_vector(base64Output), blob);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
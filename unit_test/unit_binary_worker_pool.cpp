@@ -0,0 +1,41 @@
+#include "../src/binary_worker_pool.hpp"
+#include "../src/binary_editor.hpp"
+#include <gtest/gtest.h>
+
+using namespace binary;
+
+TEST(WorkerPoolTest, SubmitAndParallelFor)
+{
+    worker_pool pool(3);
+    EXPECT_EQ(pool.size(), 3);
+    auto future = pool.submit([] { return 42; });
+    EXPECT_EQ(pool.wait(future), 42);
+
+    // 巢狀 parallel_for 不會卡住
+    std::vector<std::atomic<int>> counts(8);
+    pool.parallel_for(8,
+                      [&](size_t i)
+                      {
+                          pool.parallel_for(4, [&](size_t) { ++counts[i]; });
+                      });
+    for (auto& count : counts)
+    {
+        EXPECT_EQ(count.load(), 4);
+    }
+
+    EXPECT_THROW(pool.parallel_for(4,
+                                   [](size_t i)
+                                   {
+                                       if (i == 2)
+                                       {
+                                           throw binary_exception("task failed");
+                                       }
+                                   }),
+                 binary_exception);
+}
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}